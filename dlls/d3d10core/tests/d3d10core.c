@@ -16927,6 +16927,15 @@ static void test_multiple_viewports(void)
     SetRect(&rect, width, texture_desc.Height / 2, 2 * width - 1, texture_desc.Height - 1);
     check_texture_sub_resource_vec4(texture, 0, &rect, &expected_values[11], 1);
 
+    /* Fewer scissor rectangles requested than set. */
+    count = 1;
+    memset(rects, 0, sizeof(rects));
+    ID3D10Device_RSGetScissorRects(device, &count, rects);
+    ok(!rects[0].left && !rects[0].top && rects[0].right == width && rects[0].bottom == texture_desc.Height / 2,
+            "Got unexpected scissor rect %s.\n", wine_dbgstr_rect(&rects[0]));
+    ok(!rects[1].left && !rects[1].top && !rects[1].right && !rects[1].bottom,
+            "Got unexpected scissor rect %s.\n", wine_dbgstr_rect(&rects[1]));
+
     /* Viewport count exceeding maximum value. */
     ID3D10Device_RSSetViewports(device, 1, vp);
 
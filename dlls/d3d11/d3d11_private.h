@@ -61,6 +61,8 @@ const char *debug_float4(const float *values) DECLSPEC_HIDDEN;
 
 DXGI_FORMAT dxgi_format_from_wined3dformat(enum wined3d_format_id format) DECLSPEC_HIDDEN;
 enum wined3d_format_id wined3dformat_from_dxgi_format(DXGI_FORMAT format) DECLSPEC_HIDDEN;
+unsigned int dxgi_format_get_block_size(DXGI_FORMAT format,
+        unsigned int *block_width, unsigned int *block_height) DECLSPEC_HIDDEN;
 void d3d11_primitive_topology_from_wined3d_primitive_type(enum wined3d_primitive_type primitive_type,
         unsigned int patch_vertex_count, D3D11_PRIMITIVE_TOPOLOGY *topology) DECLSPEC_HIDDEN;
 void wined3d_primitive_type_from_d3d11_primitive_topology(D3D11_PRIMITIVE_TOPOLOGY topology,
@@ -518,6 +520,42 @@ struct d3d11_immediate_context
     struct wined3d_private_store private_store;
 };
 
+/* ID3D11CommandList */
+struct d3d11_command_buffer
+{
+    BYTE *data;
+    SIZE_T size;
+    SIZE_T capacity;
+
+    IUnknown **objects;
+    SIZE_T object_count;
+    SIZE_T object_capacity;
+};
+
+struct d3d11_command_list
+{
+    ID3D11CommandList ID3D11CommandList_iface;
+    LONG refcount;
+
+    struct wined3d_private_store private_store;
+    ID3D11Device2 *device;
+    UINT context_flags;
+    struct d3d11_command_buffer buffer;
+};
+
+/* ID3D11DeviceContext - deferred context */
+struct d3d11_deferred_context
+{
+    ID3D11DeviceContext1 ID3D11DeviceContext1_iface;
+    LONG refcount;
+
+    struct wined3d_private_store private_store;
+    ID3D11Device2 *device;
+    UINT context_flags;
+    struct d3d11_command_buffer buffer;
+    struct list mappings;
+};
+
 /* ID3D11Device, ID3D10Device1 */
 struct d3d_device
 {
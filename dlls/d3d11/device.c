@@ -32,6 +32,1232 @@ static const struct wined3d_parent_ops d3d_null_wined3d_parent_ops =
     d3d_null_wined3d_object_destroyed,
 };
 
+/* ID3D11CommandList methods */
+
+enum deferred_cmd
+{
+    DEFERRED_SET_SHADER,
+    DEFERRED_SET_CONSTANT_BUFFERS,
+    DEFERRED_SET_SHADER_RESOURCES,
+    DEFERRED_SET_SAMPLERS,
+    DEFERRED_CS_SET_UNORDERED_ACCESS_VIEWS,
+    DEFERRED_IA_SET_INPUT_LAYOUT,
+    DEFERRED_IA_SET_VERTEX_BUFFERS,
+    DEFERRED_IA_SET_INDEX_BUFFER,
+    DEFERRED_IA_SET_PRIMITIVE_TOPOLOGY,
+    DEFERRED_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS,
+    DEFERRED_OM_SET_BLEND_STATE,
+    DEFERRED_OM_SET_DEPTH_STENCIL_STATE,
+    DEFERRED_SO_SET_TARGETS,
+    DEFERRED_RS_SET_STATE,
+    DEFERRED_RS_SET_VIEWPORTS,
+    DEFERRED_RS_SET_SCISSOR_RECTS,
+    DEFERRED_SET_PREDICATION,
+    DEFERRED_BEGIN,
+    DEFERRED_END,
+    DEFERRED_DRAW,
+    DEFERRED_DRAW_INDEXED,
+    DEFERRED_DRAW_INSTANCED,
+    DEFERRED_DRAW_INDEXED_INSTANCED,
+    DEFERRED_DRAW_AUTO,
+    DEFERRED_DRAW_INSTANCED_INDIRECT,
+    DEFERRED_DRAW_INDEXED_INSTANCED_INDIRECT,
+    DEFERRED_DISPATCH,
+    DEFERRED_DISPATCH_INDIRECT,
+    DEFERRED_MAP,
+    DEFERRED_UPDATE_SUBRESOURCE,
+    DEFERRED_COPY_SUBRESOURCE_REGION,
+    DEFERRED_COPY_RESOURCE,
+    DEFERRED_COPY_STRUCTURE_COUNT,
+    DEFERRED_RESOLVE_SUBRESOURCE,
+    DEFERRED_CLEAR_RENDER_TARGET_VIEW,
+    DEFERRED_CLEAR_DEPTH_STENCIL_VIEW,
+    DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_UINT,
+    DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_FLOAT,
+    DEFERRED_CLEAR_VIEW,
+    DEFERRED_GENERATE_MIPS,
+    DEFERRED_SET_RESOURCE_MIN_LOD,
+    DEFERRED_DISCARD_RESOURCE,
+    DEFERRED_DISCARD_VIEW,
+    DEFERRED_CLEAR_STATE,
+    DEFERRED_EXECUTE_COMMAND_LIST,
+};
+
+/* Calls are stored back to back in the command buffer. Variable sized
+ * arguments (object arrays, rectangles, resource data) directly follow the
+ * fixed part of the call. */
+struct deferred_call
+{
+    enum deferred_cmd cmd;
+    unsigned int size;
+    union
+    {
+        struct
+        {
+            enum wined3d_shader_type type;
+            ID3D11DeviceChild *shader;
+        } shader;
+        struct
+        {
+            enum wined3d_shader_type type;
+            UINT start_slot;
+            UINT count;
+            BOOL has_ranges;
+        } constant_buffers;
+        struct
+        {
+            enum wined3d_shader_type type;
+            UINT start_slot;
+            UINT count;
+        } views;
+        struct
+        {
+            UINT start_slot;
+            UINT count;
+            BOOL has_initial_counts;
+        } uavs;
+        struct
+        {
+            ID3D11InputLayout *layout;
+        } input_layout;
+        struct
+        {
+            UINT start_slot;
+            UINT count;
+        } vertex_buffers;
+        struct
+        {
+            ID3D11Buffer *buffer;
+            DXGI_FORMAT format;
+            UINT offset;
+        } index_buffer;
+        struct
+        {
+            D3D11_PRIMITIVE_TOPOLOGY topology;
+        } topology;
+        struct
+        {
+            UINT rtv_count;
+            ID3D11DepthStencilView *dsv;
+            UINT uav_start_slot;
+            UINT uav_count;
+            BOOL has_initial_counts;
+        } render_targets;
+        struct
+        {
+            ID3D11BlendState *state;
+            BOOL has_factor;
+            float factor[4];
+            UINT sample_mask;
+        } blend_state;
+        struct
+        {
+            ID3D11DepthStencilState *state;
+            UINT stencil_ref;
+        } depth_stencil_state;
+        struct
+        {
+            UINT count;
+            BOOL has_offsets;
+        } so_targets;
+        struct
+        {
+            ID3D11RasterizerState *state;
+        } rasterizer_state;
+        struct
+        {
+            UINT count;
+        } rects;
+        struct
+        {
+            ID3D11Predicate *predicate;
+            BOOL value;
+        } predication;
+        struct
+        {
+            ID3D11Asynchronous *asynchronous;
+        } async;
+        struct
+        {
+            UINT vertex_count;
+            UINT start_vertex;
+        } draw;
+        struct
+        {
+            UINT index_count;
+            UINT start_index;
+            INT base_vertex;
+        } draw_indexed;
+        struct
+        {
+            UINT count_per_instance;
+            UINT instance_count;
+            UINT start_vertex;
+            UINT start_instance;
+        } draw_instanced;
+        struct
+        {
+            UINT count_per_instance;
+            UINT instance_count;
+            UINT start_index;
+            INT base_vertex;
+            UINT start_instance;
+        } draw_indexed_instanced;
+        struct
+        {
+            ID3D11Buffer *buffer;
+            UINT offset;
+        } indirect;
+        struct
+        {
+            UINT x, y, z;
+        } dispatch;
+        struct
+        {
+            ID3D11Resource *resource;
+            UINT subresource_idx;
+            D3D11_MAP map_type;
+            UINT row_pitch;
+            UINT depth_pitch;
+            UINT size;
+        } map;
+        struct
+        {
+            ID3D11Resource *resource;
+            UINT subresource_idx;
+            BOOL has_box;
+            D3D11_BOX box;
+            UINT row_pitch;
+            UINT depth_pitch;
+            UINT flags;
+        } update_subresource;
+        struct
+        {
+            ID3D11Resource *dst_resource;
+            UINT dst_subresource_idx;
+            UINT dst_x, dst_y, dst_z;
+            ID3D11Resource *src_resource;
+            UINT src_subresource_idx;
+            BOOL has_box;
+            D3D11_BOX src_box;
+            UINT flags;
+        } copy_subresource_region;
+        struct
+        {
+            ID3D11Resource *dst_resource;
+            ID3D11Resource *src_resource;
+        } copy_resource;
+        struct
+        {
+            ID3D11Buffer *dst_buffer;
+            UINT dst_offset;
+            ID3D11UnorderedAccessView *src_view;
+        } copy_structure_count;
+        struct
+        {
+            ID3D11Resource *dst_resource;
+            UINT dst_subresource_idx;
+            ID3D11Resource *src_resource;
+            UINT src_subresource_idx;
+            DXGI_FORMAT format;
+        } resolve_subresource;
+        struct
+        {
+            ID3D11RenderTargetView *view;
+            float color[4];
+        } clear_rtv;
+        struct
+        {
+            ID3D11DepthStencilView *view;
+            UINT flags;
+            float depth;
+            UINT8 stencil;
+        } clear_dsv;
+        struct
+        {
+            ID3D11UnorderedAccessView *view;
+            UINT values[4];
+        } clear_uav_uint;
+        struct
+        {
+            ID3D11UnorderedAccessView *view;
+            float values[4];
+        } clear_uav_float;
+        struct
+        {
+            ID3D11View *view;
+            float color[4];
+            UINT rect_count;
+        } clear_view;
+        struct
+        {
+            ID3D11ShaderResourceView *view;
+        } generate_mips;
+        struct
+        {
+            ID3D11Resource *resource;
+            float min_lod;
+        } min_lod;
+        struct
+        {
+            ID3D11Resource *resource;
+        } discard_resource;
+        struct
+        {
+            ID3D11View *view;
+            BOOL has_rects;
+            UINT rect_count;
+        } discard_view;
+        struct
+        {
+            ID3D11CommandList *command_list;
+            BOOL restore_state;
+        } execute_command_list;
+    } u;
+};
+
+static inline struct d3d11_command_list *impl_from_ID3D11CommandList(ID3D11CommandList *iface)
+{
+    return CONTAINING_RECORD(iface, struct d3d11_command_list, ID3D11CommandList_iface);
+}
+
+static BOOL d3d11_array_reserve(void **elements, SIZE_T *capacity, SIZE_T count, SIZE_T size)
+{
+    SIZE_T max_capacity, new_capacity;
+    void *new_elements;
+
+    if (count <= *capacity)
+        return TRUE;
+
+    max_capacity = ~(SIZE_T)0 / size;
+    if (count > max_capacity)
+        return FALSE;
+
+    new_capacity = max(64, *capacity);
+    while (new_capacity < count && new_capacity <= max_capacity / 2)
+        new_capacity *= 2;
+    if (new_capacity < count)
+        new_capacity = max_capacity;
+
+    if (!(new_elements = heap_realloc(*elements, new_capacity * size)))
+        return FALSE;
+
+    *elements = new_elements;
+    *capacity = new_capacity;
+    return TRUE;
+}
+
+static void d3d11_command_buffer_cleanup(struct d3d11_command_buffer *buffer)
+{
+    SIZE_T i;
+
+    for (i = 0; i < buffer->object_count; ++i)
+        IUnknown_Release(buffer->objects[i]);
+    heap_free(buffer->objects);
+    heap_free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_command_list_QueryInterface(ID3D11CommandList *iface,
+        REFIID riid, void **out)
+{
+    TRACE("iface %p, riid %s, out %p.\n", iface, debugstr_guid(riid), out);
+
+    if (IsEqualGUID(riid, &IID_ID3D11CommandList)
+            || IsEqualGUID(riid, &IID_ID3D11DeviceChild)
+            || IsEqualGUID(riid, &IID_IUnknown))
+    {
+        ID3D11CommandList_AddRef(iface);
+        *out = iface;
+        return S_OK;
+    }
+
+    WARN("%s not implemented, returning E_NOINTERFACE.\n", debugstr_guid(riid));
+    *out = NULL;
+    return E_NOINTERFACE;
+}
+
+static ULONG STDMETHODCALLTYPE d3d11_command_list_AddRef(ID3D11CommandList *iface)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+    ULONG refcount = InterlockedIncrement(&list->refcount);
+
+    TRACE("%p increasing refcount to %u.\n", list, refcount);
+
+    return refcount;
+}
+
+static ULONG STDMETHODCALLTYPE d3d11_command_list_Release(ID3D11CommandList *iface)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+    ULONG refcount = InterlockedDecrement(&list->refcount);
+
+    TRACE("%p decreasing refcount to %u.\n", list, refcount);
+
+    if (!refcount)
+    {
+        ID3D11Device2 *device = list->device;
+
+        d3d11_command_buffer_cleanup(&list->buffer);
+        wined3d_private_store_cleanup(&list->private_store);
+        heap_free(list);
+
+        ID3D11Device2_Release(device);
+    }
+
+    return refcount;
+}
+
+static void STDMETHODCALLTYPE d3d11_command_list_GetDevice(ID3D11CommandList *iface, ID3D11Device **device)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+
+    TRACE("iface %p, device %p.\n", iface, device);
+
+    *device = (ID3D11Device *)list->device;
+    ID3D11Device_AddRef(*device);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_command_list_GetPrivateData(ID3D11CommandList *iface, REFGUID guid,
+        UINT *data_size, void *data)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+
+    TRACE("iface %p, guid %s, data_size %p, data %p.\n", iface, debugstr_guid(guid), data_size, data);
+
+    return d3d_get_private_data(&list->private_store, guid, data_size, data);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_command_list_SetPrivateData(ID3D11CommandList *iface, REFGUID guid,
+        UINT data_size, const void *data)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+
+    TRACE("iface %p, guid %s, data_size %u, data %p.\n", iface, debugstr_guid(guid), data_size, data);
+
+    return d3d_set_private_data(&list->private_store, guid, data_size, data);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_command_list_SetPrivateDataInterface(ID3D11CommandList *iface,
+        REFGUID guid, const IUnknown *data)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+
+    TRACE("iface %p, guid %s, data %p.\n", iface, debugstr_guid(guid), data);
+
+    return d3d_set_private_data_interface(&list->private_store, guid, data);
+}
+
+static UINT STDMETHODCALLTYPE d3d11_command_list_GetContextFlags(ID3D11CommandList *iface)
+{
+    struct d3d11_command_list *list = impl_from_ID3D11CommandList(iface);
+
+    TRACE("iface %p.\n", iface);
+
+    return list->context_flags;
+}
+
+static const struct ID3D11CommandListVtbl d3d11_command_list_vtbl =
+{
+    /* IUnknown methods */
+    d3d11_command_list_QueryInterface,
+    d3d11_command_list_AddRef,
+    d3d11_command_list_Release,
+    /* ID3D11DeviceChild methods */
+    d3d11_command_list_GetDevice,
+    d3d11_command_list_GetPrivateData,
+    d3d11_command_list_SetPrivateData,
+    d3d11_command_list_SetPrivateDataInterface,
+    /* ID3D11CommandList methods */
+    d3d11_command_list_GetContextFlags,
+};
+
+static struct d3d11_command_list *unsafe_impl_from_ID3D11CommandList(ID3D11CommandList *iface)
+{
+    if (!iface)
+        return NULL;
+    assert(iface->lpVtbl == &d3d11_command_list_vtbl);
+
+    return impl_from_ID3D11CommandList(iface);
+}
+
+static HRESULT d3d11_command_list_create(ID3D11Device2 *device, UINT context_flags,
+        struct d3d11_command_buffer *buffer, struct d3d11_command_list **list)
+{
+    struct d3d11_command_list *object;
+
+    if (!(object = heap_alloc_zero(sizeof(*object))))
+        return E_OUTOFMEMORY;
+
+    object->ID3D11CommandList_iface.lpVtbl = &d3d11_command_list_vtbl;
+    object->refcount = 1;
+    object->device = device;
+    ID3D11Device2_AddRef(device);
+    object->context_flags = context_flags;
+    wined3d_private_store_init(&object->private_store);
+
+    /* The command list takes over the recorded calls and the references
+     * they hold. */
+    object->buffer = *buffer;
+    memset(buffer, 0, sizeof(*buffer));
+
+    TRACE("Created command list %p.\n", object);
+    *list = object;
+
+    return S_OK;
+}
+
+static void d3d11_context_set_shader(ID3D11DeviceContext1 *context,
+        enum wined3d_shader_type type, ID3D11DeviceChild *shader)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSSetShader(context, (ID3D11VertexShader *)shader, NULL, 0);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSSetShader(context, (ID3D11HullShader *)shader, NULL, 0);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSSetShader(context, (ID3D11DomainShader *)shader, NULL, 0);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSSetShader(context, (ID3D11GeometryShader *)shader, NULL, 0);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSSetShader(context, (ID3D11PixelShader *)shader, NULL, 0);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSSetShader(context, (ID3D11ComputeShader *)shader, NULL, 0);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            break;
+    }
+}
+
+static void d3d11_context_get_shader(ID3D11DeviceContext1 *context,
+        enum wined3d_shader_type type, ID3D11DeviceChild **shader)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSGetShader(context, (ID3D11VertexShader **)shader, NULL, NULL);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSGetShader(context, (ID3D11HullShader **)shader, NULL, NULL);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSGetShader(context, (ID3D11DomainShader **)shader, NULL, NULL);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSGetShader(context, (ID3D11GeometryShader **)shader, NULL, NULL);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSGetShader(context, (ID3D11PixelShader **)shader, NULL, NULL);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSGetShader(context, (ID3D11ComputeShader **)shader, NULL, NULL);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            *shader = NULL;
+            break;
+    }
+}
+
+static void d3d11_context_set_constant_buffers(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11Buffer *const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    if (first_constant)
+    {
+        switch (type)
+        {
+            case WINED3D_SHADER_TYPE_VERTEX:
+                ID3D11DeviceContext1_VSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            case WINED3D_SHADER_TYPE_HULL:
+                ID3D11DeviceContext1_HSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            case WINED3D_SHADER_TYPE_DOMAIN:
+                ID3D11DeviceContext1_DSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            case WINED3D_SHADER_TYPE_GEOMETRY:
+                ID3D11DeviceContext1_GSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            case WINED3D_SHADER_TYPE_PIXEL:
+                ID3D11DeviceContext1_PSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            case WINED3D_SHADER_TYPE_COMPUTE:
+                ID3D11DeviceContext1_CSSetConstantBuffers1(context, start_slot, count,
+                        buffers, first_constant, num_constants);
+                break;
+            default:
+                ERR("Invalid shader type %#x.\n", type);
+                break;
+        }
+        return;
+    }
+
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSSetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            break;
+    }
+}
+
+static void d3d11_context_get_constant_buffers(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11Buffer **buffers)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSGetConstantBuffers(context, start_slot, count, buffers);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            memset(buffers, 0, count * sizeof(*buffers));
+            break;
+    }
+}
+
+static void d3d11_context_set_shader_resources(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11ShaderResourceView *const *views)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSSetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSSetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSSetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSSetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSSetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSSetShaderResources(context, start_slot, count, views);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            break;
+    }
+}
+
+static void d3d11_context_get_shader_resources(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11ShaderResourceView **views)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSGetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSGetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSGetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSGetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSGetShaderResources(context, start_slot, count, views);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSGetShaderResources(context, start_slot, count, views);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            memset(views, 0, count * sizeof(*views));
+            break;
+    }
+}
+
+static void d3d11_context_set_samplers(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11SamplerState *const *samplers)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSSetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSSetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSSetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSSetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSSetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSSetSamplers(context, start_slot, count, samplers);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            break;
+    }
+}
+
+static void d3d11_context_get_samplers(ID3D11DeviceContext1 *context, enum wined3d_shader_type type,
+        UINT start_slot, UINT count, ID3D11SamplerState **samplers)
+{
+    switch (type)
+    {
+        case WINED3D_SHADER_TYPE_VERTEX:
+            ID3D11DeviceContext1_VSGetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_HULL:
+            ID3D11DeviceContext1_HSGetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_DOMAIN:
+            ID3D11DeviceContext1_DSGetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_GEOMETRY:
+            ID3D11DeviceContext1_GSGetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_PIXEL:
+            ID3D11DeviceContext1_PSGetSamplers(context, start_slot, count, samplers);
+            break;
+        case WINED3D_SHADER_TYPE_COMPUTE:
+            ID3D11DeviceContext1_CSGetSamplers(context, start_slot, count, samplers);
+            break;
+        default:
+            ERR("Invalid shader type %#x.\n", type);
+            memset(samplers, 0, count * sizeof(*samplers));
+            break;
+    }
+}
+
+static void d3d11_context_map_and_copy(ID3D11DeviceContext1 *context,
+        const struct deferred_call *call, const BYTE *data)
+{
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    unsigned int row_count, slice_count, i, j;
+    const BYTE *src;
+    BYTE *dst;
+    HRESULT hr;
+
+    if (FAILED(hr = ID3D11DeviceContext1_Map(context, call->u.map.resource, call->u.map.subresource_idx,
+            call->u.map.map_type, 0, &map_desc)))
+    {
+        WARN("Failed to map resource %p, hr %#x.\n", call->u.map.resource, hr);
+        return;
+    }
+
+    if ((map_desc.RowPitch == call->u.map.row_pitch && map_desc.DepthPitch == call->u.map.depth_pitch)
+            || call->u.map.row_pitch == call->u.map.size)
+    {
+        memcpy(map_desc.pData, data, call->u.map.size);
+    }
+    else
+    {
+        slice_count = call->u.map.size / call->u.map.depth_pitch;
+        row_count = call->u.map.depth_pitch / call->u.map.row_pitch;
+        for (i = 0; i < slice_count; ++i)
+        {
+            src = data + i * call->u.map.depth_pitch;
+            dst = (BYTE *)map_desc.pData + i * map_desc.DepthPitch;
+            for (j = 0; j < row_count; ++j)
+            {
+                memcpy(dst, src, min(call->u.map.row_pitch, map_desc.RowPitch));
+                src += call->u.map.row_pitch;
+                dst += map_desc.RowPitch;
+            }
+        }
+    }
+
+    ID3D11DeviceContext1_Unmap(context, call->u.map.resource, call->u.map.subresource_idx);
+}
+
+static void d3d11_command_list_execute(const struct d3d11_command_list *list, ID3D11DeviceContext1 *context)
+{
+    const BYTE *ptr = list->buffer.data, *end = ptr + list->buffer.size;
+    const struct deferred_call *call;
+    const void *data;
+
+    TRACE("Executing command list %p, %lu bytes.\n", list, (unsigned long)list->buffer.size);
+
+    for (; ptr < end; ptr += call->size)
+    {
+        call = (const struct deferred_call *)ptr;
+        data = call + 1;
+
+        switch (call->cmd)
+        {
+            case DEFERRED_SET_SHADER:
+                d3d11_context_set_shader(context, call->u.shader.type, call->u.shader.shader);
+                break;
+
+            case DEFERRED_SET_CONSTANT_BUFFERS:
+            {
+                ID3D11Buffer *const *buffers = data;
+                const UINT *first_constant = NULL, *num_constants = NULL;
+
+                if (call->u.constant_buffers.has_ranges)
+                {
+                    first_constant = (const UINT *)&buffers[call->u.constant_buffers.count];
+                    num_constants = &first_constant[call->u.constant_buffers.count];
+                }
+                d3d11_context_set_constant_buffers(context, call->u.constant_buffers.type,
+                        call->u.constant_buffers.start_slot, call->u.constant_buffers.count,
+                        buffers, first_constant, num_constants);
+                break;
+            }
+
+            case DEFERRED_SET_SHADER_RESOURCES:
+                d3d11_context_set_shader_resources(context, call->u.views.type,
+                        call->u.views.start_slot, call->u.views.count, data);
+                break;
+
+            case DEFERRED_SET_SAMPLERS:
+                d3d11_context_set_samplers(context, call->u.views.type,
+                        call->u.views.start_slot, call->u.views.count, data);
+                break;
+
+            case DEFERRED_CS_SET_UNORDERED_ACCESS_VIEWS:
+            {
+                ID3D11UnorderedAccessView *const *views = data;
+
+                ID3D11DeviceContext1_CSSetUnorderedAccessViews(context, call->u.uavs.start_slot,
+                        call->u.uavs.count, views, call->u.uavs.has_initial_counts
+                        ? (const UINT *)&views[call->u.uavs.count] : NULL);
+                break;
+            }
+
+            case DEFERRED_IA_SET_INPUT_LAYOUT:
+                ID3D11DeviceContext1_IASetInputLayout(context, call->u.input_layout.layout);
+                break;
+
+            case DEFERRED_IA_SET_VERTEX_BUFFERS:
+            {
+                ID3D11Buffer *const *buffers = data;
+                const UINT *strides = (const UINT *)&buffers[call->u.vertex_buffers.count];
+
+                ID3D11DeviceContext1_IASetVertexBuffers(context, call->u.vertex_buffers.start_slot,
+                        call->u.vertex_buffers.count, buffers, strides, &strides[call->u.vertex_buffers.count]);
+                break;
+            }
+
+            case DEFERRED_IA_SET_INDEX_BUFFER:
+                ID3D11DeviceContext1_IASetIndexBuffer(context, call->u.index_buffer.buffer,
+                        call->u.index_buffer.format, call->u.index_buffer.offset);
+                break;
+
+            case DEFERRED_IA_SET_PRIMITIVE_TOPOLOGY:
+                ID3D11DeviceContext1_IASetPrimitiveTopology(context, call->u.topology.topology);
+                break;
+
+            case DEFERRED_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS:
+            {
+                ID3D11RenderTargetView *const *rtvs = data;
+                ID3D11UnorderedAccessView *const *uavs;
+                const UINT *initial_counts = NULL;
+
+                uavs = (ID3D11UnorderedAccessView *const *)&rtvs[
+                        call->u.render_targets.rtv_count == D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL
+                        ? 0 : call->u.render_targets.rtv_count];
+                if (call->u.render_targets.has_initial_counts)
+                    initial_counts = (const UINT *)&uavs[call->u.render_targets.uav_count];
+                ID3D11DeviceContext1_OMSetRenderTargetsAndUnorderedAccessViews(context,
+                        call->u.render_targets.rtv_count, rtvs, call->u.render_targets.dsv,
+                        call->u.render_targets.uav_start_slot, call->u.render_targets.uav_count,
+                        uavs, initial_counts);
+                break;
+            }
+
+            case DEFERRED_OM_SET_BLEND_STATE:
+                ID3D11DeviceContext1_OMSetBlendState(context, call->u.blend_state.state,
+                        call->u.blend_state.has_factor ? call->u.blend_state.factor : NULL,
+                        call->u.blend_state.sample_mask);
+                break;
+
+            case DEFERRED_OM_SET_DEPTH_STENCIL_STATE:
+                ID3D11DeviceContext1_OMSetDepthStencilState(context, call->u.depth_stencil_state.state,
+                        call->u.depth_stencil_state.stencil_ref);
+                break;
+
+            case DEFERRED_SO_SET_TARGETS:
+            {
+                ID3D11Buffer *const *buffers = data;
+
+                ID3D11DeviceContext1_SOSetTargets(context, call->u.so_targets.count, buffers,
+                        call->u.so_targets.has_offsets ? (const UINT *)&buffers[call->u.so_targets.count] : NULL);
+                break;
+            }
+
+            case DEFERRED_RS_SET_STATE:
+                ID3D11DeviceContext1_RSSetState(context, call->u.rasterizer_state.state);
+                break;
+
+            case DEFERRED_RS_SET_VIEWPORTS:
+                ID3D11DeviceContext1_RSSetViewports(context, call->u.rects.count, data);
+                break;
+
+            case DEFERRED_RS_SET_SCISSOR_RECTS:
+                ID3D11DeviceContext1_RSSetScissorRects(context, call->u.rects.count, data);
+                break;
+
+            case DEFERRED_SET_PREDICATION:
+                ID3D11DeviceContext1_SetPredication(context, call->u.predication.predicate,
+                        call->u.predication.value);
+                break;
+
+            case DEFERRED_BEGIN:
+                ID3D11DeviceContext1_Begin(context, call->u.async.asynchronous);
+                break;
+
+            case DEFERRED_END:
+                ID3D11DeviceContext1_End(context, call->u.async.asynchronous);
+                break;
+
+            case DEFERRED_DRAW:
+                ID3D11DeviceContext1_Draw(context, call->u.draw.vertex_count, call->u.draw.start_vertex);
+                break;
+
+            case DEFERRED_DRAW_INDEXED:
+                ID3D11DeviceContext1_DrawIndexed(context, call->u.draw_indexed.index_count,
+                        call->u.draw_indexed.start_index, call->u.draw_indexed.base_vertex);
+                break;
+
+            case DEFERRED_DRAW_INSTANCED:
+                ID3D11DeviceContext1_DrawInstanced(context, call->u.draw_instanced.count_per_instance,
+                        call->u.draw_instanced.instance_count, call->u.draw_instanced.start_vertex,
+                        call->u.draw_instanced.start_instance);
+                break;
+
+            case DEFERRED_DRAW_INDEXED_INSTANCED:
+                ID3D11DeviceContext1_DrawIndexedInstanced(context,
+                        call->u.draw_indexed_instanced.count_per_instance,
+                        call->u.draw_indexed_instanced.instance_count,
+                        call->u.draw_indexed_instanced.start_index,
+                        call->u.draw_indexed_instanced.base_vertex,
+                        call->u.draw_indexed_instanced.start_instance);
+                break;
+
+            case DEFERRED_DRAW_AUTO:
+                ID3D11DeviceContext1_DrawAuto(context);
+                break;
+
+            case DEFERRED_DRAW_INSTANCED_INDIRECT:
+                ID3D11DeviceContext1_DrawInstancedIndirect(context,
+                        call->u.indirect.buffer, call->u.indirect.offset);
+                break;
+
+            case DEFERRED_DRAW_INDEXED_INSTANCED_INDIRECT:
+                ID3D11DeviceContext1_DrawIndexedInstancedIndirect(context,
+                        call->u.indirect.buffer, call->u.indirect.offset);
+                break;
+
+            case DEFERRED_DISPATCH:
+                ID3D11DeviceContext1_Dispatch(context, call->u.dispatch.x, call->u.dispatch.y, call->u.dispatch.z);
+                break;
+
+            case DEFERRED_DISPATCH_INDIRECT:
+                ID3D11DeviceContext1_DispatchIndirect(context, call->u.indirect.buffer, call->u.indirect.offset);
+                break;
+
+            case DEFERRED_MAP:
+                d3d11_context_map_and_copy(context, call, data);
+                break;
+
+            case DEFERRED_UPDATE_SUBRESOURCE:
+                ID3D11DeviceContext1_UpdateSubresource1(context, call->u.update_subresource.resource,
+                        call->u.update_subresource.subresource_idx,
+                        call->u.update_subresource.has_box ? &call->u.update_subresource.box : NULL,
+                        data, call->u.update_subresource.row_pitch, call->u.update_subresource.depth_pitch,
+                        call->u.update_subresource.flags);
+                break;
+
+            case DEFERRED_COPY_SUBRESOURCE_REGION:
+                ID3D11DeviceContext1_CopySubresourceRegion1(context,
+                        call->u.copy_subresource_region.dst_resource,
+                        call->u.copy_subresource_region.dst_subresource_idx,
+                        call->u.copy_subresource_region.dst_x,
+                        call->u.copy_subresource_region.dst_y,
+                        call->u.copy_subresource_region.dst_z,
+                        call->u.copy_subresource_region.src_resource,
+                        call->u.copy_subresource_region.src_subresource_idx,
+                        call->u.copy_subresource_region.has_box
+                        ? &call->u.copy_subresource_region.src_box : NULL,
+                        call->u.copy_subresource_region.flags);
+                break;
+
+            case DEFERRED_COPY_RESOURCE:
+                ID3D11DeviceContext1_CopyResource(context, call->u.copy_resource.dst_resource,
+                        call->u.copy_resource.src_resource);
+                break;
+
+            case DEFERRED_COPY_STRUCTURE_COUNT:
+                ID3D11DeviceContext1_CopyStructureCount(context, call->u.copy_structure_count.dst_buffer,
+                        call->u.copy_structure_count.dst_offset, call->u.copy_structure_count.src_view);
+                break;
+
+            case DEFERRED_RESOLVE_SUBRESOURCE:
+                ID3D11DeviceContext1_ResolveSubresource(context,
+                        call->u.resolve_subresource.dst_resource, call->u.resolve_subresource.dst_subresource_idx,
+                        call->u.resolve_subresource.src_resource, call->u.resolve_subresource.src_subresource_idx,
+                        call->u.resolve_subresource.format);
+                break;
+
+            case DEFERRED_CLEAR_RENDER_TARGET_VIEW:
+                ID3D11DeviceContext1_ClearRenderTargetView(context, call->u.clear_rtv.view, call->u.clear_rtv.color);
+                break;
+
+            case DEFERRED_CLEAR_DEPTH_STENCIL_VIEW:
+                ID3D11DeviceContext1_ClearDepthStencilView(context, call->u.clear_dsv.view,
+                        call->u.clear_dsv.flags, call->u.clear_dsv.depth, call->u.clear_dsv.stencil);
+                break;
+
+            case DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_UINT:
+                ID3D11DeviceContext1_ClearUnorderedAccessViewUint(context,
+                        call->u.clear_uav_uint.view, call->u.clear_uav_uint.values);
+                break;
+
+            case DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_FLOAT:
+                ID3D11DeviceContext1_ClearUnorderedAccessViewFloat(context,
+                        call->u.clear_uav_float.view, call->u.clear_uav_float.values);
+                break;
+
+            case DEFERRED_CLEAR_VIEW:
+                ID3D11DeviceContext1_ClearView(context, call->u.clear_view.view, call->u.clear_view.color,
+                        call->u.clear_view.rect_count ? data : NULL, call->u.clear_view.rect_count);
+                break;
+
+            case DEFERRED_GENERATE_MIPS:
+                ID3D11DeviceContext1_GenerateMips(context, call->u.generate_mips.view);
+                break;
+
+            case DEFERRED_SET_RESOURCE_MIN_LOD:
+                ID3D11DeviceContext1_SetResourceMinLOD(context, call->u.min_lod.resource, call->u.min_lod.min_lod);
+                break;
+
+            case DEFERRED_DISCARD_RESOURCE:
+                ID3D11DeviceContext1_DiscardResource(context, call->u.discard_resource.resource);
+                break;
+
+            case DEFERRED_DISCARD_VIEW:
+                if (call->u.discard_view.has_rects)
+                    ID3D11DeviceContext1_DiscardView1(context, call->u.discard_view.view,
+                            data, call->u.discard_view.rect_count);
+                else
+                    ID3D11DeviceContext1_DiscardView(context, call->u.discard_view.view);
+                break;
+
+            case DEFERRED_CLEAR_STATE:
+                ID3D11DeviceContext1_ClearState(context);
+                break;
+
+            case DEFERRED_EXECUTE_COMMAND_LIST:
+                ID3D11DeviceContext1_ExecuteCommandList(context, call->u.execute_command_list.command_list,
+                        call->u.execute_command_list.restore_state);
+                break;
+
+            default:
+                ERR("Unhandled deferred call %#x.\n", call->cmd);
+                break;
+        }
+    }
+}
+
+/* Immediate context state saved around ExecuteCommandList() when the
+ * application asks for it to be restored. */
+struct d3d11_context_state
+{
+    struct
+    {
+        ID3D11DeviceChild *shader;
+        ID3D11Buffer *constant_buffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+        ID3D11ShaderResourceView *shader_resources[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        ID3D11SamplerState *samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+    } stages[WINED3D_SHADER_TYPE_COUNT];
+    ID3D11UnorderedAccessView *cs_uavs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+
+    ID3D11InputLayout *input_layout;
+    ID3D11Buffer *vertex_buffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    UINT strides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    UINT offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    ID3D11Buffer *index_buffer;
+    DXGI_FORMAT index_format;
+    UINT index_offset;
+    D3D11_PRIMITIVE_TOPOLOGY topology;
+
+    ID3D11RenderTargetView *rtvs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    ID3D11DepthStencilView *dsv;
+    ID3D11UnorderedAccessView *uavs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+    ID3D11BlendState *blend_state;
+    float blend_factor[4];
+    UINT sample_mask;
+    ID3D11DepthStencilState *depth_stencil_state;
+    UINT stencil_ref;
+
+    ID3D11RasterizerState *rasterizer_state;
+    D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT viewport_count;
+    D3D11_RECT scissor_rects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT scissor_rect_count;
+
+    ID3D11Buffer *so_targets[D3D11_SO_BUFFER_SLOT_COUNT];
+    ID3D11Predicate *predicate;
+    BOOL predicate_value;
+};
+
+static void d3d11_context_state_capture(struct d3d11_context_state *state, ID3D11DeviceContext1 *context)
+{
+    unsigned int i;
+
+    for (i = 0; i < WINED3D_SHADER_TYPE_COUNT; ++i)
+    {
+        d3d11_context_get_shader(context, i, &state->stages[i].shader);
+        d3d11_context_get_constant_buffers(context, i, 0,
+                ARRAY_SIZE(state->stages[i].constant_buffers), state->stages[i].constant_buffers);
+        d3d11_context_get_shader_resources(context, i, 0,
+                ARRAY_SIZE(state->stages[i].shader_resources), state->stages[i].shader_resources);
+        d3d11_context_get_samplers(context, i, 0,
+                ARRAY_SIZE(state->stages[i].samplers), state->stages[i].samplers);
+    }
+    ID3D11DeviceContext1_CSGetUnorderedAccessViews(context, 0, ARRAY_SIZE(state->cs_uavs), state->cs_uavs);
+
+    ID3D11DeviceContext1_IAGetInputLayout(context, &state->input_layout);
+    ID3D11DeviceContext1_IAGetVertexBuffers(context, 0, ARRAY_SIZE(state->vertex_buffers),
+            state->vertex_buffers, state->strides, state->offsets);
+    ID3D11DeviceContext1_IAGetIndexBuffer(context, &state->index_buffer,
+            &state->index_format, &state->index_offset);
+    ID3D11DeviceContext1_IAGetPrimitiveTopology(context, &state->topology);
+
+    ID3D11DeviceContext1_OMGetRenderTargetsAndUnorderedAccessViews(context, ARRAY_SIZE(state->rtvs),
+            state->rtvs, &state->dsv, 0, ARRAY_SIZE(state->uavs), state->uavs);
+    ID3D11DeviceContext1_OMGetBlendState(context, &state->blend_state,
+            state->blend_factor, &state->sample_mask);
+    ID3D11DeviceContext1_OMGetDepthStencilState(context, &state->depth_stencil_state, &state->stencil_ref);
+
+    ID3D11DeviceContext1_RSGetState(context, &state->rasterizer_state);
+    state->viewport_count = ARRAY_SIZE(state->viewports);
+    ID3D11DeviceContext1_RSGetViewports(context, &state->viewport_count, state->viewports);
+    ID3D11DeviceContext1_RSGetScissorRects(context, &state->scissor_rect_count, NULL);
+    state->scissor_rect_count = min(state->scissor_rect_count, ARRAY_SIZE(state->scissor_rects));
+    ID3D11DeviceContext1_RSGetScissorRects(context, &state->scissor_rect_count, state->scissor_rects);
+
+    ID3D11DeviceContext1_SOGetTargets(context, ARRAY_SIZE(state->so_targets), state->so_targets);
+    ID3D11DeviceContext1_GetPredication(context, &state->predicate, &state->predicate_value);
+}
+
+static void d3d11_release_objects(void *objects, unsigned int count)
+{
+    IUnknown **iface = objects;
+    unsigned int i;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (iface[i])
+            IUnknown_Release(iface[i]);
+    }
+}
+
+/* Applies the captured state to the context, and releases the references the
+ * capture holds. */
+static void d3d11_context_state_apply(struct d3d11_context_state *state, ID3D11DeviceContext1 *context)
+{
+    unsigned int i;
+
+    for (i = 0; i < WINED3D_SHADER_TYPE_COUNT; ++i)
+    {
+        d3d11_context_set_shader(context, i, state->stages[i].shader);
+        d3d11_context_set_constant_buffers(context, i, 0, ARRAY_SIZE(state->stages[i].constant_buffers),
+                state->stages[i].constant_buffers, NULL, NULL);
+        d3d11_context_set_shader_resources(context, i, 0, ARRAY_SIZE(state->stages[i].shader_resources),
+                state->stages[i].shader_resources);
+        d3d11_context_set_samplers(context, i, 0, ARRAY_SIZE(state->stages[i].samplers),
+                state->stages[i].samplers);
+
+        d3d11_release_objects(&state->stages[i].shader, 1);
+        d3d11_release_objects(state->stages[i].constant_buffers, ARRAY_SIZE(state->stages[i].constant_buffers));
+        d3d11_release_objects(state->stages[i].shader_resources, ARRAY_SIZE(state->stages[i].shader_resources));
+        d3d11_release_objects(state->stages[i].samplers, ARRAY_SIZE(state->stages[i].samplers));
+    }
+    ID3D11DeviceContext1_CSSetUnorderedAccessViews(context, 0, ARRAY_SIZE(state->cs_uavs), state->cs_uavs, NULL);
+    d3d11_release_objects(state->cs_uavs, ARRAY_SIZE(state->cs_uavs));
+
+    ID3D11DeviceContext1_IASetInputLayout(context, state->input_layout);
+    ID3D11DeviceContext1_IASetVertexBuffers(context, 0, ARRAY_SIZE(state->vertex_buffers),
+            state->vertex_buffers, state->strides, state->offsets);
+    ID3D11DeviceContext1_IASetIndexBuffer(context, state->index_buffer, state->index_format, state->index_offset);
+    ID3D11DeviceContext1_IASetPrimitiveTopology(context, state->topology);
+    d3d11_release_objects(&state->input_layout, 1);
+    d3d11_release_objects(state->vertex_buffers, ARRAY_SIZE(state->vertex_buffers));
+    d3d11_release_objects(&state->index_buffer, 1);
+
+    ID3D11DeviceContext1_OMSetRenderTargetsAndUnorderedAccessViews(context, ARRAY_SIZE(state->rtvs),
+            state->rtvs, state->dsv, 0, ARRAY_SIZE(state->uavs), state->uavs, NULL);
+    ID3D11DeviceContext1_OMSetBlendState(context, state->blend_state, state->blend_factor, state->sample_mask);
+    ID3D11DeviceContext1_OMSetDepthStencilState(context, state->depth_stencil_state, state->stencil_ref);
+    d3d11_release_objects(state->rtvs, ARRAY_SIZE(state->rtvs));
+    d3d11_release_objects(&state->dsv, 1);
+    d3d11_release_objects(state->uavs, ARRAY_SIZE(state->uavs));
+    d3d11_release_objects(&state->blend_state, 1);
+    d3d11_release_objects(&state->depth_stencil_state, 1);
+
+    ID3D11DeviceContext1_RSSetState(context, state->rasterizer_state);
+    ID3D11DeviceContext1_RSSetViewports(context, state->viewport_count, state->viewports);
+    ID3D11DeviceContext1_RSSetScissorRects(context, state->scissor_rect_count, state->scissor_rects);
+    d3d11_release_objects(&state->rasterizer_state, 1);
+
+    ID3D11DeviceContext1_SOSetTargets(context, ARRAY_SIZE(state->so_targets), state->so_targets, NULL);
+    ID3D11DeviceContext1_SetPredication(context, state->predicate, state->predicate_value);
+    d3d11_release_objects(state->so_targets, ARRAY_SIZE(state->so_targets));
+    d3d11_release_objects(&state->predicate, 1);
+}
+
 /* ID3D11DeviceContext - immediate context methods */
 
 static inline struct d3d11_immediate_context *impl_from_ID3D11DeviceContext1(ID3D11DeviceContext1 *iface)
@@ -1210,10 +2436,35 @@ static void STDMETHODCALLTYPE d3d11_immediate_context_ResolveSubresource(ID3D11D
 static void STDMETHODCALLTYPE d3d11_immediate_context_ExecuteCommandList(ID3D11DeviceContext1 *iface,
         ID3D11CommandList *command_list, BOOL restore_state)
 {
-    FIXME("iface %p, command_list %p, restore_state %#x stub!\n", iface, command_list, restore_state);
-}
+    struct d3d11_command_list *list = unsafe_impl_from_ID3D11CommandList(command_list);
+    struct d3d11_context_state *state = NULL;
 
-static void STDMETHODCALLTYPE d3d11_immediate_context_HSSetShaderResources(ID3D11DeviceContext1 *iface,
+    TRACE("iface %p, command_list %p, restore_state %#x.\n", iface, command_list, restore_state);
+
+    if (!list)
+        return;
+
+    if (restore_state)
+    {
+        if ((state = heap_alloc_zero(sizeof(*state))))
+            d3d11_context_state_capture(state, iface);
+        else
+            ERR("Failed to allocate state, the context state will not be restored.\n");
+    }
+
+    /* Command lists don't inherit any state from the immediate context. */
+    ID3D11DeviceContext1_ClearState(iface);
+    d3d11_command_list_execute(list, iface);
+
+    ID3D11DeviceContext1_ClearState(iface);
+    if (state)
+    {
+        d3d11_context_state_apply(state, iface);
+        heap_free(state);
+    }
+}
+
+static void STDMETHODCALLTYPE d3d11_immediate_context_HSSetShaderResources(ID3D11DeviceContext1 *iface,
         UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
 {
     struct d3d_device *device = device_from_immediate_ID3D11DeviceContext1(iface);
@@ -2067,6 +3318,7 @@ static void STDMETHODCALLTYPE d3d11_immediate_context_RSGetScissorRects(ID3D11De
     if (!rect_count)
         return;
 
+    actual_count = *rect_count;
     wined3d_mutex_lock();
     wined3d_device_get_scissor_rects(device->wined3d_device, &actual_count, rects);
     wined3d_mutex_unlock();
@@ -2799,230 +4051,2594 @@ static void d3d11_immediate_context_destroy(struct d3d11_immediate_context *cont
     wined3d_private_store_cleanup(&context->private_store);
 }
 
-/* ID3D11Device methods */
+/* ID3D11DeviceContext - deferred context methods */
+
+/* A subresource mapped on a deferred context. The application writes into
+ * separately allocated memory, which is copied into the command buffer on
+ * Unmap(), since the command buffer may move while the resource is mapped.
+ * The memory is kept until the command list is finished, so that it still
+ * holds the previous contents for D3D11_MAP_WRITE_NO_OVERWRITE maps. */
+struct d3d11_deferred_mapping
+{
+    struct list entry;
+    ID3D11Resource *resource;
+    UINT subresource_idx;
+    D3D11_MAP map_type;
+    UINT row_pitch;
+    UINT depth_pitch;
+    UINT size;
+    void *data;
+    BOOL mapped;
+    /* Whether a DEFERRED_MAP call was recorded. */
+    BOOL recorded;
+};
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_QueryInterface(ID3D11Device2 *iface, REFIID riid, void **out)
+static inline struct d3d11_deferred_context *impl_from_deferred_ID3D11DeviceContext1(ID3D11DeviceContext1 *iface)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    return IUnknown_QueryInterface(device->outer_unk, riid, out);
+    return CONTAINING_RECORD(iface, struct d3d11_deferred_context, ID3D11DeviceContext1_iface);
 }
 
-static ULONG STDMETHODCALLTYPE d3d11_device_AddRef(ID3D11Device2 *iface)
+static struct deferred_call *d3d11_deferred_context_add_call(struct d3d11_deferred_context *context,
+        enum deferred_cmd cmd, SIZE_T data_size)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    return IUnknown_AddRef(device->outer_unk);
-}
+    struct d3d11_command_buffer *buffer = &context->buffer;
+    struct deferred_call *call;
+    SIZE_T size;
 
-static ULONG STDMETHODCALLTYPE d3d11_device_Release(ID3D11Device2 *iface)
-{
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    return IUnknown_Release(device->outer_unk);
+    size = (sizeof(*call) + data_size + 7) & ~(SIZE_T)7;
+    if (!d3d11_array_reserve((void **)&buffer->data, &buffer->capacity, buffer->size + size, 1))
+    {
+        ERR("Failed to allocate %lu bytes for deferred call %#x.\n", (unsigned long)size, cmd);
+        return NULL;
+    }
+
+    call = (struct deferred_call *)&buffer->data[buffer->size];
+    memset(call, 0, sizeof(*call));
+    call->cmd = cmd;
+    call->size = size;
+    buffer->size += size;
+
+    return call;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateBuffer(ID3D11Device2 *iface, const D3D11_BUFFER_DESC *desc,
-        const D3D11_SUBRESOURCE_DATA *data, ID3D11Buffer **buffer)
+/* Objects referenced by recorded calls are kept alive until the command list
+ * is destroyed. */
+static void d3d11_deferred_context_add_object(struct d3d11_deferred_context *context, void *object)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_buffer *object;
-    HRESULT hr;
-
-    TRACE("iface %p, desc %p, data %p, buffer %p.\n", iface, desc, data, buffer);
+    struct d3d11_command_buffer *buffer = &context->buffer;
+    IUnknown *iface = object;
 
-    if (FAILED(hr = d3d_buffer_create(device, desc, data, &object)))
-        return hr;
+    if (!iface)
+        return;
 
-    *buffer = &object->ID3D11Buffer_iface;
+    if (!d3d11_array_reserve((void **)&buffer->objects, &buffer->object_capacity,
+            buffer->object_count + 1, sizeof(*buffer->objects)))
+    {
+        ERR("Failed to grow object array.\n");
+        return;
+    }
 
-    return S_OK;
+    IUnknown_AddRef(iface);
+    buffer->objects[buffer->object_count++] = iface;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture1D(ID3D11Device2 *iface,
-        const D3D11_TEXTURE1D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture1D **texture)
+static void *d3d11_deferred_context_copy_objects(struct d3d11_deferred_context *context,
+        void *dst, const void *objects, unsigned int count)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_texture1d *object;
-    HRESULT hr;
-
-    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
-
-    if (FAILED(hr = d3d_texture1d_create(device, desc, data, &object)))
-        return hr;
+    IUnknown *const *src = objects;
+    IUnknown **out = dst;
+    unsigned int i;
 
-    *texture = &object->ID3D11Texture1D_iface;
+    for (i = 0; i < count; ++i)
+    {
+        out[i] = src ? src[i] : NULL;
+        d3d11_deferred_context_add_object(context, out[i]);
+    }
 
-    return S_OK;
+    return &out[count];
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture2D(ID3D11Device2 *iface,
-        const D3D11_TEXTURE2D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture2D **texture)
+static struct d3d11_deferred_mapping *d3d11_deferred_context_find_mapping(struct d3d11_deferred_context *context,
+        ID3D11Resource *resource, UINT subresource_idx)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_texture2d *object;
-    HRESULT hr;
+    struct d3d11_deferred_mapping *mapping;
 
-    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
+    LIST_FOR_EACH_ENTRY(mapping, &context->mappings, struct d3d11_deferred_mapping, entry)
+    {
+        if (mapping->resource == resource && mapping->subresource_idx == subresource_idx)
+            return mapping;
+    }
 
-    if (FAILED(hr = d3d_texture2d_create(device, desc, data, &object)))
-        return hr;
+    return NULL;
+}
 
-    *texture = &object->ID3D11Texture2D_iface;
+static void d3d11_deferred_context_reset_mappings(struct d3d11_deferred_context *context)
+{
+    struct d3d11_deferred_mapping *mapping, *next;
 
-    return S_OK;
+    LIST_FOR_EACH_ENTRY_SAFE(mapping, next, &context->mappings, struct d3d11_deferred_mapping, entry)
+    {
+        if (mapping->mapped)
+            WARN("Subresource %u of resource %p is still mapped.\n",
+                    mapping->subresource_idx, mapping->resource);
+        heap_free(mapping->data);
+        list_remove(&mapping->entry);
+        heap_free(mapping);
+    }
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture3D(ID3D11Device2 *iface,
-        const D3D11_TEXTURE3D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture3D **texture)
+static HRESULT d3d11_deferred_context_get_map_layout(ID3D11Resource *resource, UINT subresource_idx,
+        UINT *row_pitch, UINT *depth_pitch, UINT *size)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_texture3d *object;
-    HRESULT hr;
-
-    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
+    struct wined3d_sub_resource_desc sub_resource_desc;
+    struct wined3d_resource *wined3d_resource;
+    struct wined3d_resource_desc desc;
+    struct wined3d_texture *texture;
+    HRESULT hr = S_OK;
 
-    if (FAILED(hr = d3d_texture3d_create(device, desc, data, &object)))
-        return hr;
+    wined3d_resource = wined3d_resource_from_d3d11_resource(resource);
 
-    *texture = &object->ID3D11Texture3D_iface;
+    wined3d_mutex_lock();
+    wined3d_resource_get_desc(wined3d_resource, &desc);
+    if (desc.resource_type == WINED3D_RTYPE_BUFFER)
+    {
+        if (subresource_idx)
+            hr = E_INVALIDARG;
+        *row_pitch = *depth_pitch = *size = desc.size;
+    }
+    else
+    {
+        texture = wined3d_texture_from_resource(wined3d_resource);
+        if (FAILED(wined3d_texture_get_sub_resource_desc(texture, subresource_idx, &sub_resource_desc)))
+        {
+            hr = E_INVALIDARG;
+        }
+        else
+        {
+            wined3d_texture_get_pitch(texture, subresource_idx % wined3d_texture_get_level_count(texture),
+                    row_pitch, depth_pitch);
+            *size = *depth_pitch * sub_resource_desc.depth;
+        }
+    }
+    wined3d_mutex_unlock();
 
-    return S_OK;
+    return hr;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateShaderResourceView(ID3D11Device2 *iface,
-        ID3D11Resource *resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *desc, ID3D11ShaderResourceView **view)
+/* Returns the number of bytes UpdateSubresource() reads from the
+ * application's data. */
+static HRESULT d3d11_deferred_context_get_update_size(ID3D11Resource *resource, UINT subresource_idx,
+        const D3D11_BOX *box, UINT row_pitch, UINT depth_pitch, SIZE_T *size)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_shader_resource_view *object;
-    HRESULT hr;
+    unsigned int row_count, block_height, block_width, block_size;
+    unsigned int width, height, depth, last_row_size;
+    struct wined3d_sub_resource_desc sub_resource_desc;
+    struct wined3d_resource *wined3d_resource;
+    struct wined3d_resource_desc desc;
+    struct wined3d_texture *texture;
+    DXGI_FORMAT format;
 
-    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+    wined3d_resource = wined3d_resource_from_d3d11_resource(resource);
 
-    if (!resource)
+    wined3d_mutex_lock();
+    wined3d_resource_get_desc(wined3d_resource, &desc);
+    if (desc.resource_type == WINED3D_RTYPE_BUFFER)
+    {
+        wined3d_mutex_unlock();
+        *size = box ? box->right - box->left : desc.size;
+        return S_OK;
+    }
+
+    texture = wined3d_texture_from_resource(wined3d_resource);
+    if (FAILED(wined3d_texture_get_sub_resource_desc(texture, subresource_idx, &sub_resource_desc)))
+    {
+        wined3d_mutex_unlock();
+        WARN("Invalid subresource %u.\n", subresource_idx);
         return E_INVALIDARG;
+    }
+    wined3d_mutex_unlock();
 
-    if (FAILED(hr = d3d_shader_resource_view_create(device, resource, desc, &object)))
-        return hr;
+    format = dxgi_format_from_wined3dformat(desc.format);
+    if (!(block_size = dxgi_format_get_block_size(format, &block_width, &block_height)))
+    {
+        FIXME("Unhandled format %s.\n", debug_dxgi_format(format));
+        return E_NOTIMPL;
+    }
 
-    *view = &object->ID3D11ShaderResourceView_iface;
+    width = box ? box->right - box->left : sub_resource_desc.width;
+    height = box ? box->bottom - box->top : sub_resource_desc.height;
+    depth = box ? box->back - box->front : sub_resource_desc.depth;
+    if (!width || !height || !depth)
+    {
+        *size = 0;
+        return S_OK;
+    }
+
+    row_count = (height + block_height - 1) / block_height;
+    last_row_size = ((width + block_width - 1) / block_width) * block_size;
+    if (row_pitch)
+        last_row_size = min(last_row_size, row_pitch);
+
+    *size = (SIZE_T)(depth - 1) * depth_pitch + (SIZE_T)(row_count - 1) * row_pitch + last_row_size;
 
     return S_OK;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateUnorderedAccessView(ID3D11Device2 *iface,
-        ID3D11Resource *resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC *desc, ID3D11UnorderedAccessView **view)
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_QueryInterface(ID3D11DeviceContext1 *iface,
+        REFIID riid, void **out)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d11_unordered_access_view *object;
-    HRESULT hr;
+    TRACE("iface %p, riid %s, out %p.\n", iface, debugstr_guid(riid), out);
 
-    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+    if (IsEqualGUID(riid, &IID_ID3D11DeviceContext1)
+            || IsEqualGUID(riid, &IID_ID3D11DeviceContext)
+            || IsEqualGUID(riid, &IID_ID3D11DeviceChild)
+            || IsEqualGUID(riid, &IID_IUnknown))
+    {
+        ID3D11DeviceContext1_AddRef(iface);
+        *out = iface;
+        return S_OK;
+    }
 
-    if (FAILED(hr = d3d11_unordered_access_view_create(device, resource, desc, &object)))
-        return hr;
+    WARN("%s not implemented, returning E_NOINTERFACE.\n", debugstr_guid(riid));
+    *out = NULL;
+    return E_NOINTERFACE;
+}
 
-    *view = &object->ID3D11UnorderedAccessView_iface;
+static ULONG STDMETHODCALLTYPE d3d11_deferred_context_AddRef(ID3D11DeviceContext1 *iface)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    ULONG refcount = InterlockedIncrement(&context->refcount);
 
-    return S_OK;
+    TRACE("%p increasing refcount to %u.\n", context, refcount);
+
+    return refcount;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateRenderTargetView(ID3D11Device2 *iface,
-        ID3D11Resource *resource, const D3D11_RENDER_TARGET_VIEW_DESC *desc, ID3D11RenderTargetView **view)
+static ULONG STDMETHODCALLTYPE d3d11_deferred_context_Release(ID3D11DeviceContext1 *iface)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_rendertarget_view *object;
-    HRESULT hr;
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    ULONG refcount = InterlockedDecrement(&context->refcount);
 
-    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+    TRACE("%p decreasing refcount to %u.\n", context, refcount);
 
-    if (!resource)
-        return E_INVALIDARG;
+    if (!refcount)
+    {
+        ID3D11Device2 *device = context->device;
 
-    if (FAILED(hr = d3d_rendertarget_view_create(device, resource, desc, &object)))
-        return hr;
+        d3d11_deferred_context_reset_mappings(context);
+        d3d11_command_buffer_cleanup(&context->buffer);
+        wined3d_private_store_cleanup(&context->private_store);
+        heap_free(context);
 
-    *view = &object->ID3D11RenderTargetView_iface;
+        ID3D11Device2_Release(device);
+    }
 
-    return S_OK;
+    return refcount;
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateDepthStencilView(ID3D11Device2 *iface,
-        ID3D11Resource *resource, const D3D11_DEPTH_STENCIL_VIEW_DESC *desc, ID3D11DepthStencilView **view)
+static void STDMETHODCALLTYPE d3d11_deferred_context_GetDevice(ID3D11DeviceContext1 *iface, ID3D11Device **device)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_depthstencil_view *object;
-    HRESULT hr;
-
-    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
-
-    if (FAILED(hr = d3d_depthstencil_view_create(device, resource, desc, &object)))
-        return hr;
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
 
-    *view = &object->ID3D11DepthStencilView_iface;
+    TRACE("iface %p, device %p.\n", iface, device);
 
-    return S_OK;
+    *device = (ID3D11Device *)context->device;
+    ID3D11Device_AddRef(*device);
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateInputLayout(ID3D11Device2 *iface,
-        const D3D11_INPUT_ELEMENT_DESC *element_descs, UINT element_count, const void *shader_byte_code,
-        SIZE_T shader_byte_code_length, ID3D11InputLayout **input_layout)
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_GetPrivateData(ID3D11DeviceContext1 *iface, REFGUID guid,
+        UINT *data_size, void *data)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_input_layout *object;
-    HRESULT hr;
-
-    TRACE("iface %p, element_descs %p, element_count %u, shader_byte_code %p, shader_byte_code_length %lu, "
-            "input_layout %p.\n", iface, element_descs, element_count, shader_byte_code,
-            shader_byte_code_length, input_layout);
-
-    if (FAILED(hr = d3d_input_layout_create(device, element_descs, element_count,
-            shader_byte_code, shader_byte_code_length, &object)))
-        return hr;
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
 
-    *input_layout = &object->ID3D11InputLayout_iface;
+    TRACE("iface %p, guid %s, data_size %p, data %p.\n", iface, debugstr_guid(guid), data_size, data);
 
-    return S_OK;
+    return d3d_get_private_data(&context->private_store, guid, data_size, data);
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateVertexShader(ID3D11Device2 *iface, const void *byte_code,
-        SIZE_T byte_code_length, ID3D11ClassLinkage *class_linkage, ID3D11VertexShader **shader)
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_SetPrivateData(ID3D11DeviceContext1 *iface, REFGUID guid,
+        UINT data_size, const void *data)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_vertex_shader *object;
-    HRESULT hr;
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
 
-    TRACE("iface %p, byte_code %p, byte_code_length %lu, class_linkage %p, shader %p.\n",
-            iface, byte_code, byte_code_length, class_linkage, shader);
+    TRACE("iface %p, guid %s, data_size %u, data %p.\n", iface, debugstr_guid(guid), data_size, data);
 
-    if (class_linkage)
-        FIXME("Class linkage is not implemented yet.\n");
+    return d3d_set_private_data(&context->private_store, guid, data_size, data);
+}
 
-    if (FAILED(hr = d3d_vertex_shader_create(device, byte_code, byte_code_length, &object)))
-        return hr;
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_SetPrivateDataInterface(ID3D11DeviceContext1 *iface,
+        REFGUID guid, const IUnknown *data)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
 
-    *shader = &object->ID3D11VertexShader_iface;
+    TRACE("iface %p, guid %s, data %p.\n", iface, debugstr_guid(guid), data);
 
-    return S_OK;
+    return d3d_set_private_data_interface(&context->private_store, guid, data);
 }
 
-static HRESULT STDMETHODCALLTYPE d3d11_device_CreateGeometryShader(ID3D11Device2 *iface, const void *byte_code,
-        SIZE_T byte_code_length, ID3D11ClassLinkage *class_linkage, ID3D11GeometryShader **shader)
+static void d3d11_deferred_context_set_shader(struct d3d11_deferred_context *context,
+        enum wined3d_shader_type type, void *shader, ID3D11ClassInstance *const *class_instances)
 {
-    struct d3d_device *device = impl_from_ID3D11Device2(iface);
-    struct d3d_geometry_shader *object;
-    HRESULT hr;
+    struct deferred_call *call;
 
-    TRACE("iface %p, byte_code %p, byte_code_length %lu, class_linkage %p, shader %p.\n",
-            iface, byte_code, byte_code_length, class_linkage, shader);
+    if (class_instances)
+        FIXME("Dynamic linking is not implemented yet.\n");
 
-    if (class_linkage)
-        FIXME("Class linkage is not implemented yet.\n");
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_SET_SHADER, 0)))
+        return;
+    call->u.shader.type = type;
+    call->u.shader.shader = shader;
+    d3d11_deferred_context_add_object(context, shader);
+}
 
-    if (FAILED(hr = d3d_geometry_shader_create(device, byte_code, byte_code_length,
-            NULL, 0, NULL, 0, 0, &object)))
-        return hr;
+static void d3d11_deferred_context_set_constant_buffers(struct d3d11_deferred_context *context,
+        enum wined3d_shader_type type, UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers,
+        const UINT *first_constant, const UINT *num_constants)
+{
+    BOOL has_ranges = first_constant && num_constants;
+    struct deferred_call *call;
+    SIZE_T size;
+    UINT *ranges;
 
-    *shader = &object->ID3D11GeometryShader_iface;
+    size = buffer_count * sizeof(*buffers);
+    if (has_ranges)
+        size += 2 * buffer_count * sizeof(*first_constant);
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_SET_CONSTANT_BUFFERS, size)))
+        return;
 
-    return S_OK;
+    call->u.constant_buffers.type = type;
+    call->u.constant_buffers.start_slot = start_slot;
+    call->u.constant_buffers.count = buffer_count;
+    call->u.constant_buffers.has_ranges = has_ranges;
+    ranges = d3d11_deferred_context_copy_objects(context, call + 1, buffers, buffer_count);
+    if (has_ranges)
+    {
+        memcpy(ranges, first_constant, buffer_count * sizeof(*ranges));
+        memcpy(&ranges[buffer_count], num_constants, buffer_count * sizeof(*ranges));
+    }
+}
+
+static void d3d11_deferred_context_set_views(struct d3d11_deferred_context *context, enum deferred_cmd cmd,
+        enum wined3d_shader_type type, UINT start_slot, UINT count, const void *views)
+{
+    struct deferred_call *call;
+
+    if (!(call = d3d11_deferred_context_add_call(context, cmd, count * sizeof(IUnknown *))))
+        return;
+
+    call->u.views.type = type;
+    call->u.views.start_slot = start_slot;
+    call->u.views.count = count;
+    d3d11_deferred_context_copy_objects(context, call + 1, views, count);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawIndexed(ID3D11DeviceContext1 *iface,
+        UINT index_count, UINT start_index_location, INT base_vertex_location)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, index_count %u, start_index_location %u, base_vertex_location %d.\n",
+            iface, index_count, start_index_location, base_vertex_location);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DRAW_INDEXED, 0)))
+        return;
+    call->u.draw_indexed.index_count = index_count;
+    call->u.draw_indexed.start_index = start_index_location;
+    call->u.draw_indexed.base_vertex = base_vertex_location;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_Draw(ID3D11DeviceContext1 *iface,
+        UINT vertex_count, UINT start_vertex_location)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, vertex_count %u, start_vertex_location %u.\n",
+            iface, vertex_count, start_vertex_location);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DRAW, 0)))
+        return;
+    call->u.draw.vertex_count = vertex_count;
+    call->u.draw.start_vertex = start_vertex_location;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_Map(ID3D11DeviceContext1 *iface, ID3D11Resource *resource,
+        UINT subresource_idx, D3D11_MAP map_type, UINT map_flags, D3D11_MAPPED_SUBRESOURCE *mapped_subresource)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct d3d11_deferred_mapping *mapping;
+    HRESULT hr;
+
+    TRACE("iface %p, resource %p, subresource_idx %u, map_type %u, map_flags %#x, mapped_subresource %p.\n",
+            iface, resource, subresource_idx, map_type, map_flags, mapped_subresource);
+
+    if (map_flags)
+        FIXME("Ignoring map_flags %#x.\n", map_flags);
+
+    if (map_type != D3D11_MAP_WRITE_DISCARD && map_type != D3D11_MAP_WRITE_NO_OVERWRITE)
+    {
+        WARN("Invalid map type %#x for a deferred context.\n", map_type);
+        return E_INVALIDARG;
+    }
+
+    mapping = d3d11_deferred_context_find_mapping(context, resource, subresource_idx);
+    if (mapping && mapping->mapped)
+    {
+        WARN("Subresource %u of resource %p is already mapped.\n", subresource_idx, resource);
+        return E_INVALIDARG;
+    }
+    if (map_type == D3D11_MAP_WRITE_NO_OVERWRITE && (!mapping || !mapping->recorded))
+    {
+        WARN("D3D11_MAP_WRITE_NO_OVERWRITE requires a previous D3D11_MAP_WRITE_DISCARD.\n");
+        return E_INVALIDARG;
+    }
+
+    if (!mapping)
+    {
+        if (!(mapping = heap_alloc_zero(sizeof(*mapping))))
+            return E_OUTOFMEMORY;
+        if (FAILED(hr = d3d11_deferred_context_get_map_layout(resource, subresource_idx,
+                &mapping->row_pitch, &mapping->depth_pitch, &mapping->size)))
+        {
+            heap_free(mapping);
+            return hr;
+        }
+        if (!(mapping->data = heap_alloc(mapping->size)))
+        {
+            heap_free(mapping);
+            return E_OUTOFMEMORY;
+        }
+        mapping->resource = resource;
+        mapping->subresource_idx = subresource_idx;
+        list_add_head(&context->mappings, &mapping->entry);
+        d3d11_deferred_context_add_object(context, resource);
+    }
+
+    /* The memory still holds the contents of the previous map, which
+     * D3D11_MAP_WRITE_NO_OVERWRITE maps may only append to. */
+    mapping->map_type = map_type;
+    mapping->mapped = TRUE;
+
+    mapped_subresource->pData = mapping->data;
+    mapped_subresource->RowPitch = mapping->row_pitch;
+    mapped_subresource->DepthPitch = mapping->depth_pitch;
+
+    return S_OK;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_Unmap(ID3D11DeviceContext1 *iface, ID3D11Resource *resource,
+        UINT subresource_idx)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct d3d11_deferred_mapping *mapping;
+    struct deferred_call *call;
+
+    TRACE("iface %p, resource %p, subresource_idx %u.\n", iface, resource, subresource_idx);
+
+    if (!(mapping = d3d11_deferred_context_find_mapping(context, resource, subresource_idx)) || !mapping->mapped)
+    {
+        WARN("Subresource %u of resource %p is not mapped.\n", subresource_idx, resource);
+        return;
+    }
+
+    if ((call = d3d11_deferred_context_add_call(context, DEFERRED_MAP, mapping->size)))
+    {
+        call->u.map.resource = resource;
+        call->u.map.subresource_idx = subresource_idx;
+        call->u.map.map_type = mapping->map_type;
+        call->u.map.row_pitch = mapping->row_pitch;
+        call->u.map.depth_pitch = mapping->depth_pitch;
+        call->u.map.size = mapping->size;
+        memcpy(call + 1, mapping->data, mapping->size);
+        mapping->recorded = TRUE;
+    }
+
+    mapping->mapped = FALSE;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IASetInputLayout(ID3D11DeviceContext1 *iface,
+        ID3D11InputLayout *input_layout)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, input_layout %p.\n", iface, input_layout);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_IA_SET_INPUT_LAYOUT, 0)))
+        return;
+    call->u.input_layout.layout = input_layout;
+    d3d11_deferred_context_add_object(context, input_layout);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IASetVertexBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers, const UINT *strides, const UINT *offsets)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+    UINT *dst;
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, strides %p, offsets %p.\n",
+            iface, start_slot, buffer_count, buffers, strides, offsets);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_IA_SET_VERTEX_BUFFERS,
+            buffer_count * (sizeof(*buffers) + sizeof(*strides) + sizeof(*offsets)))))
+        return;
+    call->u.vertex_buffers.start_slot = start_slot;
+    call->u.vertex_buffers.count = buffer_count;
+    dst = d3d11_deferred_context_copy_objects(context, call + 1, buffers, buffer_count);
+    memcpy(dst, strides, buffer_count * sizeof(*strides));
+    memcpy(&dst[buffer_count], offsets, buffer_count * sizeof(*offsets));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IASetIndexBuffer(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer *buffer, DXGI_FORMAT format, UINT offset)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, buffer %p, format %s, offset %u.\n", iface, buffer, debug_dxgi_format(format), offset);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_IA_SET_INDEX_BUFFER, 0)))
+        return;
+    call->u.index_buffer.buffer = buffer;
+    call->u.index_buffer.format = format;
+    call->u.index_buffer.offset = offset;
+    d3d11_deferred_context_add_object(context, buffer);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawIndexedInstanced(ID3D11DeviceContext1 *iface,
+        UINT instance_index_count, UINT instance_count, UINT start_index_location, INT base_vertex_location,
+        UINT start_instance_location)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, instance_index_count %u, instance_count %u, start_index_location %u, "
+            "base_vertex_location %d, start_instance_location %u.\n",
+            iface, instance_index_count, instance_count, start_index_location,
+            base_vertex_location, start_instance_location);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DRAW_INDEXED_INSTANCED, 0)))
+        return;
+    call->u.draw_indexed_instanced.count_per_instance = instance_index_count;
+    call->u.draw_indexed_instanced.instance_count = instance_count;
+    call->u.draw_indexed_instanced.start_index = start_index_location;
+    call->u.draw_indexed_instanced.base_vertex = base_vertex_location;
+    call->u.draw_indexed_instanced.start_instance = start_instance_location;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawInstanced(ID3D11DeviceContext1 *iface,
+        UINT instance_vertex_count, UINT instance_count, UINT start_vertex_location, UINT start_instance_location)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, instance_vertex_count %u, instance_count %u, start_vertex_location %u, "
+            "start_instance_location %u.\n",
+            iface, instance_vertex_count, instance_count, start_vertex_location,
+            start_instance_location);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DRAW_INSTANCED, 0)))
+        return;
+    call->u.draw_instanced.count_per_instance = instance_vertex_count;
+    call->u.draw_instanced.instance_count = instance_count;
+    call->u.draw_instanced.start_vertex = start_vertex_location;
+    call->u.draw_instanced.start_instance = start_instance_location;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IASetPrimitiveTopology(ID3D11DeviceContext1 *iface,
+        D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, topology %#x.\n", iface, topology);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_IA_SET_PRIMITIVE_TOPOLOGY, 0)))
+        return;
+    call->u.topology.topology = topology;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_Begin(ID3D11DeviceContext1 *iface,
+        ID3D11Asynchronous *asynchronous)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, asynchronous %p.\n", iface, asynchronous);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_BEGIN, 0)))
+        return;
+    call->u.async.asynchronous = asynchronous;
+    d3d11_deferred_context_add_object(context, asynchronous);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_End(ID3D11DeviceContext1 *iface,
+        ID3D11Asynchronous *asynchronous)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, asynchronous %p.\n", iface, asynchronous);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_END, 0)))
+        return;
+    call->u.async.asynchronous = asynchronous;
+    d3d11_deferred_context_add_object(context, asynchronous);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_GetData(ID3D11DeviceContext1 *iface,
+        ID3D11Asynchronous *asynchronous, void *data, UINT data_size, UINT data_flags)
+{
+    TRACE("iface %p, asynchronous %p, data %p, data_size %u, data_flags %#x.\n",
+            iface, asynchronous, data, data_size, data_flags);
+
+    WARN("Query data can't be retrieved from a deferred context.\n");
+
+    return DXGI_ERROR_INVALID_CALL;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_SetPredication(ID3D11DeviceContext1 *iface,
+        ID3D11Predicate *predicate, BOOL value)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, predicate %p, value %#x.\n", iface, predicate, value);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_SET_PREDICATION, 0)))
+        return;
+    call->u.predication.predicate = predicate;
+    call->u.predication.value = value;
+    d3d11_deferred_context_add_object(context, predicate);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMSetRenderTargetsAndUnorderedAccessViews(
+        ID3D11DeviceContext1 *iface, UINT render_target_view_count,
+        ID3D11RenderTargetView *const *render_target_views, ID3D11DepthStencilView *depth_stencil_view,
+        UINT unordered_access_view_start_slot, UINT unordered_access_view_count,
+        ID3D11UnorderedAccessView *const *unordered_access_views, const UINT *initial_counts)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    unsigned int rtv_count = 0, uav_count = 0;
+    struct deferred_call *call;
+    SIZE_T size;
+    void *dst;
+
+    TRACE("iface %p, render_target_view_count %u, render_target_views %p, depth_stencil_view %p, "
+            "unordered_access_view_start_slot %u, unordered_access_view_count %u, unordered_access_views %p, "
+            "initial_counts %p.\n",
+            iface, render_target_view_count, render_target_views, depth_stencil_view,
+            unordered_access_view_start_slot, unordered_access_view_count, unordered_access_views,
+            initial_counts);
+
+    if (render_target_view_count != D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL)
+        rtv_count = render_target_view_count;
+    if (unordered_access_view_count != D3D11_KEEP_UNORDERED_ACCESS_VIEWS)
+        uav_count = unordered_access_view_count;
+
+    size = rtv_count * sizeof(*render_target_views) + uav_count * sizeof(*unordered_access_views);
+    if (initial_counts)
+        size += uav_count * sizeof(*initial_counts);
+    if (!(call = d3d11_deferred_context_add_call(context,
+            DEFERRED_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS, size)))
+        return;
+
+    call->u.render_targets.rtv_count = render_target_view_count;
+    call->u.render_targets.dsv = rtv_count == render_target_view_count ? depth_stencil_view : NULL;
+    call->u.render_targets.uav_start_slot = unordered_access_view_start_slot;
+    call->u.render_targets.uav_count = unordered_access_view_count;
+    call->u.render_targets.has_initial_counts = !!initial_counts;
+    d3d11_deferred_context_add_object(context, call->u.render_targets.dsv);
+    dst = d3d11_deferred_context_copy_objects(context, call + 1, render_target_views, rtv_count);
+    dst = d3d11_deferred_context_copy_objects(context, dst, unordered_access_views, uav_count);
+    if (initial_counts)
+        memcpy(dst, initial_counts, uav_count * sizeof(*initial_counts));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMSetRenderTargets(ID3D11DeviceContext1 *iface,
+        UINT render_target_view_count, ID3D11RenderTargetView *const *render_target_views,
+        ID3D11DepthStencilView *depth_stencil_view)
+{
+    TRACE("iface %p, render_target_view_count %u, render_target_views %p, depth_stencil_view %p.\n",
+            iface, render_target_view_count, render_target_views, depth_stencil_view);
+
+    d3d11_deferred_context_OMSetRenderTargetsAndUnorderedAccessViews(iface, render_target_view_count,
+            render_target_views, depth_stencil_view, 0, D3D11_KEEP_UNORDERED_ACCESS_VIEWS, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMSetBlendState(ID3D11DeviceContext1 *iface,
+        ID3D11BlendState *blend_state, const float blend_factor[4], UINT sample_mask)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, blend_state %p, blend_factor %s, sample_mask 0x%08x.\n",
+            iface, blend_state, debug_float4(blend_factor), sample_mask);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_OM_SET_BLEND_STATE, 0)))
+        return;
+    call->u.blend_state.state = blend_state;
+    if ((call->u.blend_state.has_factor = !!blend_factor))
+        memcpy(call->u.blend_state.factor, blend_factor, sizeof(call->u.blend_state.factor));
+    call->u.blend_state.sample_mask = sample_mask;
+    d3d11_deferred_context_add_object(context, blend_state);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMSetDepthStencilState(ID3D11DeviceContext1 *iface,
+        ID3D11DepthStencilState *depth_stencil_state, UINT stencil_ref)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, depth_stencil_state %p, stencil_ref %u.\n",
+            iface, depth_stencil_state, stencil_ref);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_OM_SET_DEPTH_STENCIL_STATE, 0)))
+        return;
+    call->u.depth_stencil_state.state = depth_stencil_state;
+    call->u.depth_stencil_state.stencil_ref = stencil_ref;
+    d3d11_deferred_context_add_object(context, depth_stencil_state);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_SOSetTargets(ID3D11DeviceContext1 *iface, UINT buffer_count,
+        ID3D11Buffer *const *buffers, const UINT *offsets)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+    SIZE_T size;
+    UINT *dst;
+
+    TRACE("iface %p, buffer_count %u, buffers %p, offsets %p.\n", iface, buffer_count, buffers, offsets);
+
+    buffer_count = min(buffer_count, D3D11_SO_BUFFER_SLOT_COUNT);
+    size = buffer_count * sizeof(*buffers);
+    if (offsets)
+        size += buffer_count * sizeof(*offsets);
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_SO_SET_TARGETS, size)))
+        return;
+    call->u.so_targets.count = buffer_count;
+    call->u.so_targets.has_offsets = !!offsets;
+    dst = d3d11_deferred_context_copy_objects(context, call + 1, buffers, buffer_count);
+    if (offsets)
+        memcpy(dst, offsets, buffer_count * sizeof(*offsets));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawAuto(ID3D11DeviceContext1 *iface)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p.\n", iface);
+
+    d3d11_deferred_context_add_call(context, DEFERRED_DRAW_AUTO, 0);
+}
+
+static void d3d11_deferred_context_record_indirect(struct d3d11_deferred_context *context,
+        enum deferred_cmd cmd, ID3D11Buffer *buffer, UINT offset)
+{
+    struct deferred_call *call;
+
+    if (!(call = d3d11_deferred_context_add_call(context, cmd, 0)))
+        return;
+    call->u.indirect.buffer = buffer;
+    call->u.indirect.offset = offset;
+    d3d11_deferred_context_add_object(context, buffer);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawIndexedInstancedIndirect(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer *buffer, UINT offset)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, buffer %p, offset %u.\n", iface, buffer, offset);
+
+    d3d11_deferred_context_record_indirect(context, DEFERRED_DRAW_INDEXED_INSTANCED_INDIRECT, buffer, offset);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DrawInstancedIndirect(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer *buffer, UINT offset)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, buffer %p, offset %u.\n", iface, buffer, offset);
+
+    d3d11_deferred_context_record_indirect(context, DEFERRED_DRAW_INSTANCED_INDIRECT, buffer, offset);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_Dispatch(ID3D11DeviceContext1 *iface,
+        UINT thread_group_count_x, UINT thread_group_count_y, UINT thread_group_count_z)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, thread_group_count_x %u, thread_group_count_y %u, thread_group_count_z %u.\n",
+            iface, thread_group_count_x, thread_group_count_y, thread_group_count_z);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DISPATCH, 0)))
+        return;
+    call->u.dispatch.x = thread_group_count_x;
+    call->u.dispatch.y = thread_group_count_y;
+    call->u.dispatch.z = thread_group_count_z;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DispatchIndirect(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer *buffer, UINT offset)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, buffer %p, offset %u.\n", iface, buffer, offset);
+
+    d3d11_deferred_context_record_indirect(context, DEFERRED_DISPATCH_INDIRECT, buffer, offset);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSSetState(ID3D11DeviceContext1 *iface,
+        ID3D11RasterizerState *rasterizer_state)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, rasterizer_state %p.\n", iface, rasterizer_state);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_RS_SET_STATE, 0)))
+        return;
+    call->u.rasterizer_state.state = rasterizer_state;
+    d3d11_deferred_context_add_object(context, rasterizer_state);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSSetViewports(ID3D11DeviceContext1 *iface,
+        UINT viewport_count, const D3D11_VIEWPORT *viewports)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, viewport_count %u, viewports %p.\n", iface, viewport_count, viewports);
+
+    if (viewport_count > D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE)
+        return;
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_RS_SET_VIEWPORTS,
+            viewport_count * sizeof(*viewports))))
+        return;
+    call->u.rects.count = viewport_count;
+    memcpy(call + 1, viewports, viewport_count * sizeof(*viewports));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSSetScissorRects(ID3D11DeviceContext1 *iface,
+        UINT rect_count, const D3D11_RECT *rects)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, rect_count %u, rects %p.\n", iface, rect_count, rects);
+
+    if (rect_count > D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE)
+        return;
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_RS_SET_SCISSOR_RECTS,
+            rect_count * sizeof(*rects))))
+        return;
+    call->u.rects.count = rect_count;
+    memcpy(call + 1, rects, rect_count * sizeof(*rects));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CopySubresourceRegion1(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *dst_resource, UINT dst_subresource_idx, UINT dst_x, UINT dst_y, UINT dst_z,
+        ID3D11Resource *src_resource, UINT src_subresource_idx, const D3D11_BOX *src_box, UINT flags)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, dst_resource %p, dst_subresource_idx %u, dst_x %u, dst_y %u, dst_z %u, "
+            "src_resource %p, src_subresource_idx %u, src_box %p, flags %#x.\n",
+            iface, dst_resource, dst_subresource_idx, dst_x, dst_y, dst_z,
+            src_resource, src_subresource_idx, src_box, flags);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_COPY_SUBRESOURCE_REGION, 0)))
+        return;
+    call->u.copy_subresource_region.dst_resource = dst_resource;
+    call->u.copy_subresource_region.dst_subresource_idx = dst_subresource_idx;
+    call->u.copy_subresource_region.dst_x = dst_x;
+    call->u.copy_subresource_region.dst_y = dst_y;
+    call->u.copy_subresource_region.dst_z = dst_z;
+    call->u.copy_subresource_region.src_resource = src_resource;
+    call->u.copy_subresource_region.src_subresource_idx = src_subresource_idx;
+    if ((call->u.copy_subresource_region.has_box = !!src_box))
+        call->u.copy_subresource_region.src_box = *src_box;
+    call->u.copy_subresource_region.flags = flags;
+    d3d11_deferred_context_add_object(context, dst_resource);
+    d3d11_deferred_context_add_object(context, src_resource);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CopySubresourceRegion(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *dst_resource, UINT dst_subresource_idx, UINT dst_x, UINT dst_y, UINT dst_z,
+        ID3D11Resource *src_resource, UINT src_subresource_idx, const D3D11_BOX *src_box)
+{
+    TRACE("iface %p, dst_resource %p, dst_subresource_idx %u, dst_x %u, dst_y %u, dst_z %u, "
+            "src_resource %p, src_subresource_idx %u, src_box %p.\n",
+            iface, dst_resource, dst_subresource_idx, dst_x, dst_y, dst_z,
+            src_resource, src_subresource_idx, src_box);
+
+    d3d11_deferred_context_CopySubresourceRegion1(iface, dst_resource, dst_subresource_idx,
+            dst_x, dst_y, dst_z, src_resource, src_subresource_idx, src_box, 0);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CopyResource(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *dst_resource, ID3D11Resource *src_resource)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, dst_resource %p, src_resource %p.\n", iface, dst_resource, src_resource);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_COPY_RESOURCE, 0)))
+        return;
+    call->u.copy_resource.dst_resource = dst_resource;
+    call->u.copy_resource.src_resource = src_resource;
+    d3d11_deferred_context_add_object(context, dst_resource);
+    d3d11_deferred_context_add_object(context, src_resource);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_UpdateSubresource1(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *resource, UINT subresource_idx, const D3D11_BOX *box, const void *data,
+        UINT row_pitch, UINT depth_pitch, UINT flags)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+    SIZE_T size;
+
+    TRACE("iface %p, resource %p, subresource_idx %u, box %p, data %p, row_pitch %u, depth_pitch %u, flags %#x.\n",
+            iface, resource, subresource_idx, box, data, row_pitch, depth_pitch, flags);
+
+    if (FAILED(d3d11_deferred_context_get_update_size(resource, subresource_idx,
+            box, row_pitch, depth_pitch, &size)))
+        return;
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_UPDATE_SUBRESOURCE, size)))
+        return;
+    call->u.update_subresource.resource = resource;
+    call->u.update_subresource.subresource_idx = subresource_idx;
+    if ((call->u.update_subresource.has_box = !!box))
+        call->u.update_subresource.box = *box;
+    call->u.update_subresource.row_pitch = row_pitch;
+    call->u.update_subresource.depth_pitch = depth_pitch;
+    call->u.update_subresource.flags = flags;
+    memcpy(call + 1, data, size);
+    d3d11_deferred_context_add_object(context, resource);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_UpdateSubresource(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *resource, UINT subresource_idx, const D3D11_BOX *box,
+        const void *data, UINT row_pitch, UINT depth_pitch)
+{
+    TRACE("iface %p, resource %p, subresource_idx %u, box %p, data %p, row_pitch %u, depth_pitch %u.\n",
+            iface, resource, subresource_idx, box, data, row_pitch, depth_pitch);
+
+    d3d11_deferred_context_UpdateSubresource1(iface, resource, subresource_idx,
+            box, data, row_pitch, depth_pitch, 0);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CopyStructureCount(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer *dst_buffer, UINT dst_offset, ID3D11UnorderedAccessView *src_view)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, dst_buffer %p, dst_offset %u, src_view %p.\n",
+            iface, dst_buffer, dst_offset, src_view);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_COPY_STRUCTURE_COUNT, 0)))
+        return;
+    call->u.copy_structure_count.dst_buffer = dst_buffer;
+    call->u.copy_structure_count.dst_offset = dst_offset;
+    call->u.copy_structure_count.src_view = src_view;
+    d3d11_deferred_context_add_object(context, dst_buffer);
+    d3d11_deferred_context_add_object(context, src_view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearRenderTargetView(ID3D11DeviceContext1 *iface,
+        ID3D11RenderTargetView *render_target_view, const float color_rgba[4])
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, render_target_view %p, color_rgba %s.\n",
+            iface, render_target_view, debug_float4(color_rgba));
+
+    if (!render_target_view)
+        return;
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_RENDER_TARGET_VIEW, 0)))
+        return;
+    call->u.clear_rtv.view = render_target_view;
+    memcpy(call->u.clear_rtv.color, color_rgba, sizeof(call->u.clear_rtv.color));
+    d3d11_deferred_context_add_object(context, render_target_view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearUnorderedAccessViewUint(ID3D11DeviceContext1 *iface,
+        ID3D11UnorderedAccessView *unordered_access_view, const UINT values[4])
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, unordered_access_view %p, values {%u, %u, %u, %u}.\n",
+            iface, unordered_access_view, values[0], values[1], values[2], values[3]);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_UINT, 0)))
+        return;
+    call->u.clear_uav_uint.view = unordered_access_view;
+    memcpy(call->u.clear_uav_uint.values, values, sizeof(call->u.clear_uav_uint.values));
+    d3d11_deferred_context_add_object(context, unordered_access_view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearUnorderedAccessViewFloat(ID3D11DeviceContext1 *iface,
+        ID3D11UnorderedAccessView *unordered_access_view, const float values[4])
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, unordered_access_view %p, values %s.\n",
+            iface, unordered_access_view, debug_float4(values));
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_UNORDERED_ACCESS_VIEW_FLOAT, 0)))
+        return;
+    call->u.clear_uav_float.view = unordered_access_view;
+    memcpy(call->u.clear_uav_float.values, values, sizeof(call->u.clear_uav_float.values));
+    d3d11_deferred_context_add_object(context, unordered_access_view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearDepthStencilView(ID3D11DeviceContext1 *iface,
+        ID3D11DepthStencilView *depth_stencil_view, UINT flags, FLOAT depth, UINT8 stencil)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, depth_stencil_view %p, flags %#x, depth %.8e, stencil %u.\n",
+            iface, depth_stencil_view, flags, depth, stencil);
+
+    if (!depth_stencil_view)
+        return;
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_DEPTH_STENCIL_VIEW, 0)))
+        return;
+    call->u.clear_dsv.view = depth_stencil_view;
+    call->u.clear_dsv.flags = flags;
+    call->u.clear_dsv.depth = depth;
+    call->u.clear_dsv.stencil = stencil;
+    d3d11_deferred_context_add_object(context, depth_stencil_view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GenerateMips(ID3D11DeviceContext1 *iface,
+        ID3D11ShaderResourceView *view)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, view %p.\n", iface, view);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_GENERATE_MIPS, 0)))
+        return;
+    call->u.generate_mips.view = view;
+    d3d11_deferred_context_add_object(context, view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_SetResourceMinLOD(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *resource, FLOAT min_lod)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, resource %p, min_lod %f.\n", iface, resource, min_lod);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_SET_RESOURCE_MIN_LOD, 0)))
+        return;
+    call->u.min_lod.resource = resource;
+    call->u.min_lod.min_lod = min_lod;
+    d3d11_deferred_context_add_object(context, resource);
+}
+
+static FLOAT STDMETHODCALLTYPE d3d11_deferred_context_GetResourceMinLOD(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *resource)
+{
+    FIXME("iface %p, resource %p stub!\n", iface, resource);
+
+    return 0.0f;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ResolveSubresource(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *dst_resource, UINT dst_subresource_idx,
+        ID3D11Resource *src_resource, UINT src_subresource_idx,
+        DXGI_FORMAT format)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, dst_resource %p, dst_subresource_idx %u, src_resource %p, src_subresource_idx %u, "
+            "format %s.\n",
+            iface, dst_resource, dst_subresource_idx, src_resource, src_subresource_idx,
+            debug_dxgi_format(format));
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_RESOLVE_SUBRESOURCE, 0)))
+        return;
+    call->u.resolve_subresource.dst_resource = dst_resource;
+    call->u.resolve_subresource.dst_subresource_idx = dst_subresource_idx;
+    call->u.resolve_subresource.src_resource = src_resource;
+    call->u.resolve_subresource.src_subresource_idx = src_subresource_idx;
+    call->u.resolve_subresource.format = format;
+    d3d11_deferred_context_add_object(context, dst_resource);
+    d3d11_deferred_context_add_object(context, src_resource);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ExecuteCommandList(ID3D11DeviceContext1 *iface,
+        ID3D11CommandList *command_list, BOOL restore_state)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, command_list %p, restore_state %#x.\n", iface, command_list, restore_state);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_EXECUTE_COMMAND_LIST, 0)))
+        return;
+    call->u.execute_command_list.command_list = command_list;
+    call->u.execute_command_list.restore_state = restore_state;
+    d3d11_deferred_context_add_object(context, command_list);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetUnorderedAccessViews(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11UnorderedAccessView *const *views, const UINT *initial_counts)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+    SIZE_T size;
+    UINT *dst;
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p, initial_counts %p.\n",
+            iface, start_slot, view_count, views, initial_counts);
+
+    size = view_count * sizeof(*views);
+    if (initial_counts)
+        size += view_count * sizeof(*initial_counts);
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CS_SET_UNORDERED_ACCESS_VIEWS, size)))
+        return;
+    call->u.uavs.start_slot = start_slot;
+    call->u.uavs.count = view_count;
+    call->u.uavs.has_initial_counts = !!initial_counts;
+    dst = d3d11_deferred_context_copy_objects(context, call + 1, views, view_count);
+    if (initial_counts)
+        memcpy(dst, initial_counts, view_count * sizeof(*initial_counts));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearState(ID3D11DeviceContext1 *iface)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p.\n", iface);
+
+    d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_STATE, 0);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_Flush(ID3D11DeviceContext1 *iface)
+{
+    TRACE("iface %p.\n", iface);
+
+    /* Flush() is ignored on deferred contexts. */
+}
+
+static D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE d3d11_deferred_context_GetType(ID3D11DeviceContext1 *iface)
+{
+    TRACE("iface %p.\n", iface);
+
+    return D3D11_DEVICE_CONTEXT_DEFERRED;
+}
+
+static UINT STDMETHODCALLTYPE d3d11_deferred_context_GetContextFlags(ID3D11DeviceContext1 *iface)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p.\n", iface);
+
+    return context->context_flags;
+}
+
+/* References the objects used by a state call copied from another command
+ * buffer. */
+static void d3d11_deferred_context_add_call_objects(struct d3d11_deferred_context *context,
+        const struct deferred_call *call)
+{
+    IUnknown *const *objects = (IUnknown *const *)(call + 1);
+    unsigned int i, count = 0;
+
+    switch (call->cmd)
+    {
+        case DEFERRED_SET_SHADER:
+            d3d11_deferred_context_add_object(context, call->u.shader.shader);
+            break;
+
+        case DEFERRED_SET_CONSTANT_BUFFERS:
+            count = call->u.constant_buffers.count;
+            break;
+
+        case DEFERRED_SET_SHADER_RESOURCES:
+        case DEFERRED_SET_SAMPLERS:
+            count = call->u.views.count;
+            break;
+
+        case DEFERRED_CS_SET_UNORDERED_ACCESS_VIEWS:
+            count = call->u.uavs.count;
+            break;
+
+        case DEFERRED_IA_SET_INPUT_LAYOUT:
+            d3d11_deferred_context_add_object(context, call->u.input_layout.layout);
+            break;
+
+        case DEFERRED_IA_SET_VERTEX_BUFFERS:
+            count = call->u.vertex_buffers.count;
+            break;
+
+        case DEFERRED_IA_SET_INDEX_BUFFER:
+            d3d11_deferred_context_add_object(context, call->u.index_buffer.buffer);
+            break;
+
+        case DEFERRED_OM_SET_RENDER_TARGETS_AND_UNORDERED_ACCESS_VIEWS:
+            d3d11_deferred_context_add_object(context, call->u.render_targets.dsv);
+            if (call->u.render_targets.rtv_count != D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL)
+                count += call->u.render_targets.rtv_count;
+            if (call->u.render_targets.uav_count != D3D11_KEEP_UNORDERED_ACCESS_VIEWS)
+                count += call->u.render_targets.uav_count;
+            break;
+
+        case DEFERRED_OM_SET_BLEND_STATE:
+            d3d11_deferred_context_add_object(context, call->u.blend_state.state);
+            break;
+
+        case DEFERRED_OM_SET_DEPTH_STENCIL_STATE:
+            d3d11_deferred_context_add_object(context, call->u.depth_stencil_state.state);
+            break;
+
+        case DEFERRED_SO_SET_TARGETS:
+            count = call->u.so_targets.count;
+            break;
+
+        case DEFERRED_RS_SET_STATE:
+            d3d11_deferred_context_add_object(context, call->u.rasterizer_state.state);
+            break;
+
+        case DEFERRED_SET_PREDICATION:
+            d3d11_deferred_context_add_object(context, call->u.predication.predicate);
+            break;
+
+        default:
+            break;
+    }
+
+    for (i = 0; i < count; ++i)
+        d3d11_deferred_context_add_object(context, objects[i]);
+}
+
+/* The deferred context doesn't track its state. To keep the state for the
+ * next command list, the state calls recorded since the state was last
+ * reset are copied into the new command buffer. */
+static void d3d11_deferred_context_restore_state(struct d3d11_deferred_context *context,
+        const struct d3d11_command_buffer *buffer)
+{
+    const BYTE *ptr, *start = buffer->data, *end = buffer->data + buffer->size;
+    const struct deferred_call *call;
+    struct deferred_call *copy;
+
+    for (ptr = start; ptr < end; ptr += call->size)
+    {
+        call = (const struct deferred_call *)ptr;
+        if (call->cmd == DEFERRED_CLEAR_STATE
+                || (call->cmd == DEFERRED_EXECUTE_COMMAND_LIST && !call->u.execute_command_list.restore_state))
+            start = ptr + call->size;
+    }
+
+    for (ptr = start; ptr < end; ptr += call->size)
+    {
+        call = (const struct deferred_call *)ptr;
+        /* The state calls come first in enum deferred_cmd. */
+        if (call->cmd > DEFERRED_SET_PREDICATION)
+            continue;
+
+        if (!(copy = d3d11_deferred_context_add_call(context, call->cmd, call->size - sizeof(*call))))
+            return;
+        memcpy(copy, call, call->size);
+        d3d11_deferred_context_add_call_objects(context, copy);
+    }
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_deferred_context_FinishCommandList(ID3D11DeviceContext1 *iface,
+        BOOL restore, ID3D11CommandList **command_list)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct d3d11_command_list *object;
+    HRESULT hr;
+
+    TRACE("iface %p, restore %#x, command_list %p.\n", iface, restore, command_list);
+
+    d3d11_deferred_context_reset_mappings(context);
+    if (FAILED(hr = d3d11_command_list_create(context->device, context->context_flags,
+            &context->buffer, &object)))
+    {
+        WARN("Failed to create command list, hr %#x.\n", hr);
+        *command_list = NULL;
+        return hr;
+    }
+
+    if (restore)
+        d3d11_deferred_context_restore_state(context, &object->buffer);
+
+    *command_list = &object->ID3D11CommandList_iface;
+
+    return S_OK;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DiscardResource(ID3D11DeviceContext1 *iface,
+        ID3D11Resource *resource)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, resource %p.\n", iface, resource);
+
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DISCARD_RESOURCE, 0)))
+        return;
+    call->u.discard_resource.resource = resource;
+    d3d11_deferred_context_add_object(context, resource);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DiscardView1(ID3D11DeviceContext1 *iface, ID3D11View *view,
+        const D3D11_RECT *rects, UINT num_rects)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, view %p, rects %p, num_rects %u.\n", iface, view, rects, num_rects);
+
+    if (!rects)
+        num_rects = 0;
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_DISCARD_VIEW, num_rects * sizeof(*rects))))
+        return;
+    call->u.discard_view.view = view;
+    call->u.discard_view.has_rects = !!rects;
+    call->u.discard_view.rect_count = num_rects;
+    if (rects)
+        memcpy(call + 1, rects, num_rects * sizeof(*rects));
+    d3d11_deferred_context_add_object(context, view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DiscardView(ID3D11DeviceContext1 *iface, ID3D11View *view)
+{
+    TRACE("iface %p, view %p.\n", iface, view);
+
+    d3d11_deferred_context_DiscardView1(iface, view, NULL, 0);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_SwapDeviceContextState(ID3D11DeviceContext1 *iface,
+        ID3DDeviceContextState *state, ID3DDeviceContextState **prev_state)
+{
+    FIXME("iface %p, state %p, prev_state %p stub!\n", iface, state, prev_state);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_ClearView(ID3D11DeviceContext1 *iface, ID3D11View *view,
+        const FLOAT color[4], const D3D11_RECT *rect, UINT num_rects)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+    struct deferred_call *call;
+
+    TRACE("iface %p, view %p, color %s, rect %p, num_rects %u.\n",
+            iface, view, debug_float4(color), rect, num_rects);
+
+    if (!rect)
+        num_rects = 0;
+    if (!(call = d3d11_deferred_context_add_call(context, DEFERRED_CLEAR_VIEW, num_rects * sizeof(*rect))))
+        return;
+    call->u.clear_view.view = view;
+    memcpy(call->u.clear_view.color, color, sizeof(call->u.clear_view.color));
+    call->u.clear_view.rect_count = num_rects;
+    if (rect)
+        memcpy(call + 1, rect, num_rects * sizeof(*rect));
+    d3d11_deferred_context_add_object(context, view);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11VertexShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_VERTEX, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_VERTEX,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_VERTEX,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_VERTEX, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_VERTEX, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11VertexShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_VSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11HullShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_HULL, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_HULL,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_HULL,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_HULL, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_HULL, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11HullShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_HSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11DomainShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_DOMAIN, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_DOMAIN,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_DOMAIN,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_DOMAIN, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_DOMAIN, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11DomainShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_DSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11GeometryShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_GEOMETRY, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_GEOMETRY,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_GEOMETRY,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_GEOMETRY, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_GEOMETRY, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11GeometryShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11PixelShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_PIXEL, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_PIXEL,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_PIXEL,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_PIXEL, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_PIXEL, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11PixelShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_PSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetShader(ID3D11DeviceContext1 *iface,
+        ID3D11ComputeShader *shader, ID3D11ClassInstance *const *class_instances, UINT class_instance_count)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, shader %p, class_instances %p, class_instance_count %u.\n",
+            iface, shader, class_instances, class_instance_count);
+
+    d3d11_deferred_context_set_shader(context, WINED3D_SHADER_TYPE_COMPUTE, shader, class_instances);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer *const *buffers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p.\n",
+            iface, start_slot, buffer_count, buffers);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_COMPUTE,
+            start_slot, buffer_count, buffers, NULL, NULL);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer * const *buffers, const UINT *first_constant,
+        const UINT *num_constants)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p.\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    d3d11_deferred_context_set_constant_buffers(context, WINED3D_SHADER_TYPE_COMPUTE,
+            start_slot, buffer_count, buffers, first_constant, num_constants);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView *const *views)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
+            iface, start_slot, view_count, views);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SHADER_RESOURCES,
+            WINED3D_SHADER_TYPE_COMPUTE, start_slot, view_count, views);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSSetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState *const *samplers)
+{
+    struct d3d11_deferred_context *context = impl_from_deferred_ID3D11DeviceContext1(iface);
+
+    TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
+            iface, start_slot, sampler_count, samplers);
+
+    d3d11_deferred_context_set_views(context, DEFERRED_SET_SAMPLERS,
+            WINED3D_SHADER_TYPE_COMPUTE, start_slot, sampler_count, samplers);
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetShader(ID3D11DeviceContext1 *iface,
+        ID3D11ComputeShader **shader, ID3D11ClassInstance **class_instances, UINT *class_instance_count)
+{
+    FIXME("iface %p, shader %p, class_instances %p, class_instance_count %p stub!\n",
+            iface, shader, class_instances, class_instance_count);
+
+    *shader = NULL;
+    if (class_instance_count)
+        *class_instance_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetConstantBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p stub!\n",
+            iface, start_slot, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetConstantBuffers1(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *first_constant, UINT *num_constants)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, first_constant %p, num_constants %p stub!\n",
+            iface, start_slot, buffer_count, buffers, first_constant, num_constants);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetShaderResources(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11ShaderResourceView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n",
+            iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetSamplers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT sampler_count, ID3D11SamplerState **samplers)
+{
+    FIXME("iface %p, start_slot %u, sampler_count %u, samplers %p stub!\n",
+            iface, start_slot, sampler_count, samplers);
+
+    memset(samplers, 0, sampler_count * sizeof(*samplers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_CSGetUnorderedAccessViews(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT view_count, ID3D11UnorderedAccessView **views)
+{
+    FIXME("iface %p, start_slot %u, view_count %u, views %p stub!\n", iface, start_slot, view_count, views);
+
+    memset(views, 0, view_count * sizeof(*views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IAGetInputLayout(ID3D11DeviceContext1 *iface,
+        ID3D11InputLayout **input_layout)
+{
+    FIXME("iface %p, input_layout %p stub!\n", iface, input_layout);
+
+    *input_layout = NULL;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IAGetVertexBuffers(ID3D11DeviceContext1 *iface,
+        UINT start_slot, UINT buffer_count, ID3D11Buffer **buffers, UINT *strides, UINT *offsets)
+{
+    FIXME("iface %p, start_slot %u, buffer_count %u, buffers %p, strides %p, offsets %p stub!\n",
+            iface, start_slot, buffer_count, buffers, strides, offsets);
+
+    if (buffers)
+        memset(buffers, 0, buffer_count * sizeof(*buffers));
+    if (strides)
+        memset(strides, 0, buffer_count * sizeof(*strides));
+    if (offsets)
+        memset(offsets, 0, buffer_count * sizeof(*offsets));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IAGetIndexBuffer(ID3D11DeviceContext1 *iface,
+        ID3D11Buffer **buffer, DXGI_FORMAT *format, UINT *offset)
+{
+    FIXME("iface %p, buffer %p, format %p, offset %p stub!\n", iface, buffer, format, offset);
+
+    if (buffer)
+        *buffer = NULL;
+    if (format)
+        *format = DXGI_FORMAT_UNKNOWN;
+    if (offset)
+        *offset = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_IAGetPrimitiveTopology(ID3D11DeviceContext1 *iface,
+        D3D11_PRIMITIVE_TOPOLOGY *topology)
+{
+    FIXME("iface %p, topology %p stub!\n", iface, topology);
+
+    *topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_GetPredication(ID3D11DeviceContext1 *iface,
+        ID3D11Predicate **predicate, BOOL *value)
+{
+    FIXME("iface %p, predicate %p, value %p stub!\n", iface, predicate, value);
+
+    if (predicate)
+        *predicate = NULL;
+    if (value)
+        *value = FALSE;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMGetRenderTargets(ID3D11DeviceContext1 *iface,
+        UINT render_target_view_count, ID3D11RenderTargetView **render_target_views,
+        ID3D11DepthStencilView **depth_stencil_view)
+{
+    FIXME("iface %p, render_target_view_count %u, render_target_views %p, depth_stencil_view %p stub!\n",
+            iface, render_target_view_count, render_target_views, depth_stencil_view);
+
+    if (render_target_views)
+        memset(render_target_views, 0, render_target_view_count * sizeof(*render_target_views));
+    if (depth_stencil_view)
+        *depth_stencil_view = NULL;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMGetRenderTargetsAndUnorderedAccessViews(
+        ID3D11DeviceContext1 *iface,
+        UINT render_target_view_count, ID3D11RenderTargetView **render_target_views,
+        ID3D11DepthStencilView **depth_stencil_view,
+        UINT unordered_access_view_start_slot, UINT unordered_access_view_count,
+        ID3D11UnorderedAccessView **unordered_access_views)
+{
+    FIXME("iface %p, render_target_view_count %u, render_target_views %p, depth_stencil_view %p, "
+            "unordered_access_view_start_slot %u, unordered_access_view_count %u, "
+            "unordered_access_views %p stub!\n",
+            iface, render_target_view_count, render_target_views, depth_stencil_view,
+            unordered_access_view_start_slot, unordered_access_view_count, unordered_access_views);
+
+    d3d11_deferred_context_OMGetRenderTargets(iface, render_target_view_count,
+            render_target_views, depth_stencil_view);
+    if (unordered_access_views)
+        memset(unordered_access_views, 0, unordered_access_view_count * sizeof(*unordered_access_views));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMGetBlendState(ID3D11DeviceContext1 *iface,
+        ID3D11BlendState **blend_state, FLOAT blend_factor[4], UINT *sample_mask)
+{
+    FIXME("iface %p, blend_state %p, blend_factor %p, sample_mask %p stub!\n",
+            iface, blend_state, blend_factor, sample_mask);
+
+    if (blend_state)
+        *blend_state = NULL;
+    if (blend_factor)
+        blend_factor[0] = blend_factor[1] = blend_factor[2] = blend_factor[3] = 1.0f;
+    if (sample_mask)
+        *sample_mask = D3D11_DEFAULT_SAMPLE_MASK;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_OMGetDepthStencilState(ID3D11DeviceContext1 *iface,
+        ID3D11DepthStencilState **depth_stencil_state, UINT *stencil_ref)
+{
+    FIXME("iface %p, depth_stencil_state %p, stencil_ref %p stub!\n",
+            iface, depth_stencil_state, stencil_ref);
+
+    if (depth_stencil_state)
+        *depth_stencil_state = NULL;
+    if (stencil_ref)
+        *stencil_ref = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_SOGetTargets(ID3D11DeviceContext1 *iface,
+        UINT buffer_count, ID3D11Buffer **buffers)
+{
+    FIXME("iface %p, buffer_count %u, buffers %p stub!\n", iface, buffer_count, buffers);
+
+    memset(buffers, 0, buffer_count * sizeof(*buffers));
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSGetState(ID3D11DeviceContext1 *iface,
+        ID3D11RasterizerState **rasterizer_state)
+{
+    FIXME("iface %p, rasterizer_state %p stub!\n", iface, rasterizer_state);
+
+    *rasterizer_state = NULL;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSGetViewports(ID3D11DeviceContext1 *iface,
+        UINT *viewport_count, D3D11_VIEWPORT *viewports)
+{
+    FIXME("iface %p, viewport_count %p, viewports %p stub!\n", iface, viewport_count, viewports);
+
+    if (!viewport_count)
+        return;
+    if (viewports)
+        memset(viewports, 0, *viewport_count * sizeof(*viewports));
+    else
+        *viewport_count = 0;
+}
+
+static void STDMETHODCALLTYPE d3d11_deferred_context_RSGetScissorRects(ID3D11DeviceContext1 *iface,
+        UINT *rect_count, D3D11_RECT *rects)
+{
+    FIXME("iface %p, rect_count %p, rects %p stub!\n", iface, rect_count, rects);
+
+    if (!rect_count)
+        return;
+    if (rects)
+        memset(rects, 0, *rect_count * sizeof(*rects));
+    else
+        *rect_count = 0;
+}
+
+static const struct ID3D11DeviceContext1Vtbl d3d11_deferred_context_vtbl =
+{
+    /* IUnknown methods */
+    d3d11_deferred_context_QueryInterface,
+    d3d11_deferred_context_AddRef,
+    d3d11_deferred_context_Release,
+    /* ID3D11DeviceChild methods */
+    d3d11_deferred_context_GetDevice,
+    d3d11_deferred_context_GetPrivateData,
+    d3d11_deferred_context_SetPrivateData,
+    d3d11_deferred_context_SetPrivateDataInterface,
+    /* ID3D11DeviceContext methods */
+    d3d11_deferred_context_VSSetConstantBuffers,
+    d3d11_deferred_context_PSSetShaderResources,
+    d3d11_deferred_context_PSSetShader,
+    d3d11_deferred_context_PSSetSamplers,
+    d3d11_deferred_context_VSSetShader,
+    d3d11_deferred_context_DrawIndexed,
+    d3d11_deferred_context_Draw,
+    d3d11_deferred_context_Map,
+    d3d11_deferred_context_Unmap,
+    d3d11_deferred_context_PSSetConstantBuffers,
+    d3d11_deferred_context_IASetInputLayout,
+    d3d11_deferred_context_IASetVertexBuffers,
+    d3d11_deferred_context_IASetIndexBuffer,
+    d3d11_deferred_context_DrawIndexedInstanced,
+    d3d11_deferred_context_DrawInstanced,
+    d3d11_deferred_context_GSSetConstantBuffers,
+    d3d11_deferred_context_GSSetShader,
+    d3d11_deferred_context_IASetPrimitiveTopology,
+    d3d11_deferred_context_VSSetShaderResources,
+    d3d11_deferred_context_VSSetSamplers,
+    d3d11_deferred_context_Begin,
+    d3d11_deferred_context_End,
+    d3d11_deferred_context_GetData,
+    d3d11_deferred_context_SetPredication,
+    d3d11_deferred_context_GSSetShaderResources,
+    d3d11_deferred_context_GSSetSamplers,
+    d3d11_deferred_context_OMSetRenderTargets,
+    d3d11_deferred_context_OMSetRenderTargetsAndUnorderedAccessViews,
+    d3d11_deferred_context_OMSetBlendState,
+    d3d11_deferred_context_OMSetDepthStencilState,
+    d3d11_deferred_context_SOSetTargets,
+    d3d11_deferred_context_DrawAuto,
+    d3d11_deferred_context_DrawIndexedInstancedIndirect,
+    d3d11_deferred_context_DrawInstancedIndirect,
+    d3d11_deferred_context_Dispatch,
+    d3d11_deferred_context_DispatchIndirect,
+    d3d11_deferred_context_RSSetState,
+    d3d11_deferred_context_RSSetViewports,
+    d3d11_deferred_context_RSSetScissorRects,
+    d3d11_deferred_context_CopySubresourceRegion,
+    d3d11_deferred_context_CopyResource,
+    d3d11_deferred_context_UpdateSubresource,
+    d3d11_deferred_context_CopyStructureCount,
+    d3d11_deferred_context_ClearRenderTargetView,
+    d3d11_deferred_context_ClearUnorderedAccessViewUint,
+    d3d11_deferred_context_ClearUnorderedAccessViewFloat,
+    d3d11_deferred_context_ClearDepthStencilView,
+    d3d11_deferred_context_GenerateMips,
+    d3d11_deferred_context_SetResourceMinLOD,
+    d3d11_deferred_context_GetResourceMinLOD,
+    d3d11_deferred_context_ResolveSubresource,
+    d3d11_deferred_context_ExecuteCommandList,
+    d3d11_deferred_context_HSSetShaderResources,
+    d3d11_deferred_context_HSSetShader,
+    d3d11_deferred_context_HSSetSamplers,
+    d3d11_deferred_context_HSSetConstantBuffers,
+    d3d11_deferred_context_DSSetShaderResources,
+    d3d11_deferred_context_DSSetShader,
+    d3d11_deferred_context_DSSetSamplers,
+    d3d11_deferred_context_DSSetConstantBuffers,
+    d3d11_deferred_context_CSSetShaderResources,
+    d3d11_deferred_context_CSSetUnorderedAccessViews,
+    d3d11_deferred_context_CSSetShader,
+    d3d11_deferred_context_CSSetSamplers,
+    d3d11_deferred_context_CSSetConstantBuffers,
+    d3d11_deferred_context_VSGetConstantBuffers,
+    d3d11_deferred_context_PSGetShaderResources,
+    d3d11_deferred_context_PSGetShader,
+    d3d11_deferred_context_PSGetSamplers,
+    d3d11_deferred_context_VSGetShader,
+    d3d11_deferred_context_PSGetConstantBuffers,
+    d3d11_deferred_context_IAGetInputLayout,
+    d3d11_deferred_context_IAGetVertexBuffers,
+    d3d11_deferred_context_IAGetIndexBuffer,
+    d3d11_deferred_context_GSGetConstantBuffers,
+    d3d11_deferred_context_GSGetShader,
+    d3d11_deferred_context_IAGetPrimitiveTopology,
+    d3d11_deferred_context_VSGetShaderResources,
+    d3d11_deferred_context_VSGetSamplers,
+    d3d11_deferred_context_GetPredication,
+    d3d11_deferred_context_GSGetShaderResources,
+    d3d11_deferred_context_GSGetSamplers,
+    d3d11_deferred_context_OMGetRenderTargets,
+    d3d11_deferred_context_OMGetRenderTargetsAndUnorderedAccessViews,
+    d3d11_deferred_context_OMGetBlendState,
+    d3d11_deferred_context_OMGetDepthStencilState,
+    d3d11_deferred_context_SOGetTargets,
+    d3d11_deferred_context_RSGetState,
+    d3d11_deferred_context_RSGetViewports,
+    d3d11_deferred_context_RSGetScissorRects,
+    d3d11_deferred_context_HSGetShaderResources,
+    d3d11_deferred_context_HSGetShader,
+    d3d11_deferred_context_HSGetSamplers,
+    d3d11_deferred_context_HSGetConstantBuffers,
+    d3d11_deferred_context_DSGetShaderResources,
+    d3d11_deferred_context_DSGetShader,
+    d3d11_deferred_context_DSGetSamplers,
+    d3d11_deferred_context_DSGetConstantBuffers,
+    d3d11_deferred_context_CSGetShaderResources,
+    d3d11_deferred_context_CSGetUnorderedAccessViews,
+    d3d11_deferred_context_CSGetShader,
+    d3d11_deferred_context_CSGetSamplers,
+    d3d11_deferred_context_CSGetConstantBuffers,
+    d3d11_deferred_context_ClearState,
+    d3d11_deferred_context_Flush,
+    d3d11_deferred_context_GetType,
+    d3d11_deferred_context_GetContextFlags,
+    d3d11_deferred_context_FinishCommandList,
+    /* ID3D11DeviceContext1 methods */
+    d3d11_deferred_context_CopySubresourceRegion1,
+    d3d11_deferred_context_UpdateSubresource1,
+    d3d11_deferred_context_DiscardResource,
+    d3d11_deferred_context_DiscardView,
+    d3d11_deferred_context_VSSetConstantBuffers1,
+    d3d11_deferred_context_HSSetConstantBuffers1,
+    d3d11_deferred_context_DSSetConstantBuffers1,
+    d3d11_deferred_context_GSSetConstantBuffers1,
+    d3d11_deferred_context_PSSetConstantBuffers1,
+    d3d11_deferred_context_CSSetConstantBuffers1,
+    d3d11_deferred_context_VSGetConstantBuffers1,
+    d3d11_deferred_context_HSGetConstantBuffers1,
+    d3d11_deferred_context_DSGetConstantBuffers1,
+    d3d11_deferred_context_GSGetConstantBuffers1,
+    d3d11_deferred_context_PSGetConstantBuffers1,
+    d3d11_deferred_context_CSGetConstantBuffers1,
+    d3d11_deferred_context_SwapDeviceContextState,
+    d3d11_deferred_context_ClearView,
+    d3d11_deferred_context_DiscardView1,
+};
+
+static HRESULT d3d11_deferred_context_create(struct d3d_device *device,
+        UINT flags, struct d3d11_deferred_context **context)
+{
+    struct d3d11_deferred_context *object;
+
+    if (!(object = heap_alloc_zero(sizeof(*object))))
+        return E_OUTOFMEMORY;
+
+    object->ID3D11DeviceContext1_iface.lpVtbl = &d3d11_deferred_context_vtbl;
+    object->refcount = 1;
+    object->device = &device->ID3D11Device2_iface;
+    ID3D11Device2_AddRef(object->device);
+    object->context_flags = flags;
+    wined3d_private_store_init(&object->private_store);
+    list_init(&object->mappings);
+
+    TRACE("Created deferred context %p.\n", object);
+    *context = object;
+
+    return S_OK;
+}
+
+/* ID3D11Device methods */
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_QueryInterface(ID3D11Device2 *iface, REFIID riid, void **out)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    return IUnknown_QueryInterface(device->outer_unk, riid, out);
+}
+
+static ULONG STDMETHODCALLTYPE d3d11_device_AddRef(ID3D11Device2 *iface)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    return IUnknown_AddRef(device->outer_unk);
+}
+
+static ULONG STDMETHODCALLTYPE d3d11_device_Release(ID3D11Device2 *iface)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    return IUnknown_Release(device->outer_unk);
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateBuffer(ID3D11Device2 *iface, const D3D11_BUFFER_DESC *desc,
+        const D3D11_SUBRESOURCE_DATA *data, ID3D11Buffer **buffer)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_buffer *object;
+    HRESULT hr;
+
+    TRACE("iface %p, desc %p, data %p, buffer %p.\n", iface, desc, data, buffer);
+
+    if (FAILED(hr = d3d_buffer_create(device, desc, data, &object)))
+        return hr;
+
+    *buffer = &object->ID3D11Buffer_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture1D(ID3D11Device2 *iface,
+        const D3D11_TEXTURE1D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture1D **texture)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_texture1d *object;
+    HRESULT hr;
+
+    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
+
+    if (FAILED(hr = d3d_texture1d_create(device, desc, data, &object)))
+        return hr;
+
+    *texture = &object->ID3D11Texture1D_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture2D(ID3D11Device2 *iface,
+        const D3D11_TEXTURE2D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture2D **texture)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_texture2d *object;
+    HRESULT hr;
+
+    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
+
+    if (FAILED(hr = d3d_texture2d_create(device, desc, data, &object)))
+        return hr;
+
+    *texture = &object->ID3D11Texture2D_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateTexture3D(ID3D11Device2 *iface,
+        const D3D11_TEXTURE3D_DESC *desc, const D3D11_SUBRESOURCE_DATA *data, ID3D11Texture3D **texture)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_texture3d *object;
+    HRESULT hr;
+
+    TRACE("iface %p, desc %p, data %p, texture %p.\n", iface, desc, data, texture);
+
+    if (FAILED(hr = d3d_texture3d_create(device, desc, data, &object)))
+        return hr;
+
+    *texture = &object->ID3D11Texture3D_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateShaderResourceView(ID3D11Device2 *iface,
+        ID3D11Resource *resource, const D3D11_SHADER_RESOURCE_VIEW_DESC *desc, ID3D11ShaderResourceView **view)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_shader_resource_view *object;
+    HRESULT hr;
+
+    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+
+    if (!resource)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = d3d_shader_resource_view_create(device, resource, desc, &object)))
+        return hr;
+
+    *view = &object->ID3D11ShaderResourceView_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateUnorderedAccessView(ID3D11Device2 *iface,
+        ID3D11Resource *resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC *desc, ID3D11UnorderedAccessView **view)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d11_unordered_access_view *object;
+    HRESULT hr;
+
+    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+
+    if (FAILED(hr = d3d11_unordered_access_view_create(device, resource, desc, &object)))
+        return hr;
+
+    *view = &object->ID3D11UnorderedAccessView_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateRenderTargetView(ID3D11Device2 *iface,
+        ID3D11Resource *resource, const D3D11_RENDER_TARGET_VIEW_DESC *desc, ID3D11RenderTargetView **view)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_rendertarget_view *object;
+    HRESULT hr;
+
+    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+
+    if (!resource)
+        return E_INVALIDARG;
+
+    if (FAILED(hr = d3d_rendertarget_view_create(device, resource, desc, &object)))
+        return hr;
+
+    *view = &object->ID3D11RenderTargetView_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateDepthStencilView(ID3D11Device2 *iface,
+        ID3D11Resource *resource, const D3D11_DEPTH_STENCIL_VIEW_DESC *desc, ID3D11DepthStencilView **view)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_depthstencil_view *object;
+    HRESULT hr;
+
+    TRACE("iface %p, resource %p, desc %p, view %p.\n", iface, resource, desc, view);
+
+    if (FAILED(hr = d3d_depthstencil_view_create(device, resource, desc, &object)))
+        return hr;
+
+    *view = &object->ID3D11DepthStencilView_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateInputLayout(ID3D11Device2 *iface,
+        const D3D11_INPUT_ELEMENT_DESC *element_descs, UINT element_count, const void *shader_byte_code,
+        SIZE_T shader_byte_code_length, ID3D11InputLayout **input_layout)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_input_layout *object;
+    HRESULT hr;
+
+    TRACE("iface %p, element_descs %p, element_count %u, shader_byte_code %p, shader_byte_code_length %lu, "
+            "input_layout %p.\n", iface, element_descs, element_count, shader_byte_code,
+            shader_byte_code_length, input_layout);
+
+    if (FAILED(hr = d3d_input_layout_create(device, element_descs, element_count,
+            shader_byte_code, shader_byte_code_length, &object)))
+        return hr;
+
+    *input_layout = &object->ID3D11InputLayout_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateVertexShader(ID3D11Device2 *iface, const void *byte_code,
+        SIZE_T byte_code_length, ID3D11ClassLinkage *class_linkage, ID3D11VertexShader **shader)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_vertex_shader *object;
+    HRESULT hr;
+
+    TRACE("iface %p, byte_code %p, byte_code_length %lu, class_linkage %p, shader %p.\n",
+            iface, byte_code, byte_code_length, class_linkage, shader);
+
+    if (class_linkage)
+        FIXME("Class linkage is not implemented yet.\n");
+
+    if (FAILED(hr = d3d_vertex_shader_create(device, byte_code, byte_code_length, &object)))
+        return hr;
+
+    *shader = &object->ID3D11VertexShader_iface;
+
+    return S_OK;
+}
+
+static HRESULT STDMETHODCALLTYPE d3d11_device_CreateGeometryShader(ID3D11Device2 *iface, const void *byte_code,
+        SIZE_T byte_code_length, ID3D11ClassLinkage *class_linkage, ID3D11GeometryShader **shader)
+{
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d_geometry_shader *object;
+    HRESULT hr;
+
+    TRACE("iface %p, byte_code %p, byte_code_length %lu, class_linkage %p, shader %p.\n",
+            iface, byte_code, byte_code_length, class_linkage, shader);
+
+    if (class_linkage)
+        FIXME("Class linkage is not implemented yet.\n");
+
+    if (FAILED(hr = d3d_geometry_shader_create(device, byte_code, byte_code_length,
+            NULL, 0, NULL, 0, 0, &object)))
+        return hr;
+
+    *shader = &object->ID3D11GeometryShader_iface;
+
+    return S_OK;
 }
 
 static HRESULT STDMETHODCALLTYPE d3d11_device_CreateGeometryShaderWithStreamOutput(ID3D11Device2 *iface,
@@ -3278,9 +6894,24 @@ static HRESULT STDMETHODCALLTYPE d3d11_device_CreateCounter(ID3D11Device2 *iface
 static HRESULT STDMETHODCALLTYPE d3d11_device_CreateDeferredContext(ID3D11Device2 *iface, UINT flags,
         ID3D11DeviceContext **context)
 {
-    FIXME("iface %p, flags %#x, context %p stub!\n", iface, flags, context);
+    struct d3d_device *device = impl_from_ID3D11Device2(iface);
+    struct d3d11_deferred_context *object;
+    HRESULT hr;
 
-    return E_NOTIMPL;
+    TRACE("iface %p, flags %#x, context %p.\n", iface, flags, context);
+
+    if (flags)
+        FIXME("Ignoring flags %#x.\n", flags);
+
+    if (FAILED(hr = d3d11_deferred_context_create(device, flags, &object)))
+    {
+        *context = NULL;
+        return hr;
+    }
+
+    *context = (ID3D11DeviceContext *)&object->ID3D11DeviceContext1_iface;
+
+    return S_OK;
 }
 
 static HRESULT STDMETHODCALLTYPE d3d11_device_OpenSharedResource(ID3D11Device2 *iface, HANDLE resource, REFIID riid,
@@ -3639,9 +7270,9 @@ static void STDMETHODCALLTYPE d3d11_device_GetImmediateContext1(ID3D11Device2 *i
 static HRESULT STDMETHODCALLTYPE d3d11_device_CreateDeferredContext1(ID3D11Device2 *iface, UINT flags,
         ID3D11DeviceContext1 **context)
 {
-    FIXME("iface %p, flags %#x, context %p stub!\n", iface, flags, context);
+    TRACE("iface %p, flags %#x, context %p.\n", iface, flags, context);
 
-    return E_NOTIMPL;
+    return d3d11_device_CreateDeferredContext(iface, flags, (ID3D11DeviceContext **)context);
 }
 
 static HRESULT STDMETHODCALLTYPE d3d11_device_CreateBlendState1(ID3D11Device2 *iface,
@@ -5088,6 +8719,7 @@ static void STDMETHODCALLTYPE d3d10_device_RSGetScissorRects(ID3D10Device1 *ifac
     if (!rect_count)
         return;
 
+    actual_count = *rect_count;
     wined3d_mutex_lock();
     wined3d_device_get_scissor_rects(device->wined3d_device, &actual_count, rects);
     wined3d_mutex_unlock();
@@ -27298,6 +27298,15 @@ static void test_multiple_viewports(void)
     SetRect(&rect, width, texture_desc.Height / 2, 2 * width - 1, texture_desc.Height - 1);
     check_texture_sub_resource_vec4(texture, 0, &rect, &expected_values[11], 1);
 
+    /* Fewer scissor rectangles requested than set. */
+    count = 1;
+    memset(rects, 0, sizeof(rects));
+    ID3D11DeviceContext_RSGetScissorRects(context, &count, rects);
+    ok(!rects[0].left && !rects[0].top && rects[0].right == width && rects[0].bottom == texture_desc.Height / 2,
+            "Got unexpected scissor rect %s.\n", wine_dbgstr_rect(&rects[0]));
+    ok(!rects[1].left && !rects[1].top && !rects[1].right && !rects[1].bottom,
+            "Got unexpected scissor rect %s.\n", wine_dbgstr_rect(&rects[1]));
+
     /* Viewport count exceeding maximum value. */
     ID3D11DeviceContext_RSSetViewports(context, 1, vp);
 
@@ -28102,6 +28111,242 @@ static void test_depth_clip(void)
     release_test_context(&test_context);
 }
 
+static void test_deferred_context(void)
+{
+    static const struct vec4 green_vec = {0.0f, 1.0f, 0.0f, 1.0f};
+    static const float green[] = {0.0f, 1.0f, 0.0f, 1.0f};
+    static const float red[] = {1.0f, 0.0f, 0.0f, 1.0f};
+    static const DWORD data[] = {0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10};
+
+    ID3D11CommandList *command_list, *command_list2;
+    ID3D11DeviceContext *context, *deferred_context;
+    struct d3d11_test_context test_context;
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    D3D11_BUFFER_DESC buffer_desc;
+    unsigned int stride, offset;
+    ID3D11RenderTargetView *rtv;
+    struct resource_readback rb;
+    ID3D11Device *device;
+    ID3D11Buffer *buffer;
+    unsigned int i;
+    HRESULT hr;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+
+    device = test_context.device;
+    context = test_context.immediate_context;
+
+    hr = ID3D11Device_CreateDeferredContext(device, 0, &deferred_context);
+    if (hr == DXGI_ERROR_INVALID_CALL)
+    {
+        skip("Deferred contexts are not supported.\n");
+        release_test_context(&test_context);
+        return;
+    }
+    ok(SUCCEEDED(hr), "Failed to create deferred context, hr %#x.\n", hr);
+    ok(ID3D11DeviceContext_GetType(deferred_context) == D3D11_DEVICE_CONTEXT_DEFERRED,
+            "Got unexpected context type %#x.\n", ID3D11DeviceContext_GetType(deferred_context));
+
+    ID3D11DeviceContext_ClearRenderTargetView(context, test_context.backbuffer_rtv, red);
+    ID3D11DeviceContext_ClearRenderTargetView(deferred_context, test_context.backbuffer_rtv, green);
+    check_texture_color(test_context.backbuffer, 0xff0000ff, 0);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &command_list);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+    check_texture_color(test_context.backbuffer, 0xff0000ff, 0);
+
+    ID3D11DeviceContext_OMSetRenderTargets(context, 1, &test_context.backbuffer_rtv, NULL);
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list, TRUE);
+    check_texture_color(test_context.backbuffer, 0xff00ff00, 0);
+    ID3D11DeviceContext_OMGetRenderTargets(context, 1, &rtv, NULL);
+    ok(rtv == test_context.backbuffer_rtv, "Got unexpected render target view %p.\n", rtv);
+    ID3D11RenderTargetView_Release(rtv);
+
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list, FALSE);
+    ID3D11DeviceContext_OMGetRenderTargets(context, 1, &rtv, NULL);
+    ok(!rtv, "Got unexpected render target view %p.\n", rtv);
+    ID3D11CommandList_Release(command_list);
+
+    buffer_desc.ByteWidth = sizeof(data);
+    buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+    buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    buffer_desc.MiscFlags = 0;
+    buffer_desc.StructureByteStride = 0;
+    hr = ID3D11Device_CreateBuffer(device, &buffer_desc, NULL, &buffer);
+    ok(SUCCEEDED(hr), "Failed to create buffer, hr %#x.\n", hr);
+
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)buffer, 0, D3D11_MAP_WRITE, 0, &map_desc);
+    ok(hr == E_INVALIDARG, "Got unexpected hr %#x.\n", hr);
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)buffer,
+            0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+    ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+    memcpy(map_desc.pData, data, sizeof(data));
+    ID3D11DeviceContext_Unmap(deferred_context, (ID3D11Resource *)buffer, 0);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &command_list);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list, FALSE);
+    ID3D11CommandList_Release(command_list);
+
+    get_buffer_readback(buffer, &rb);
+    for (i = 0; i < ARRAY_SIZE(data); ++i)
+    {
+        DWORD value = get_readback_color(&rb, i, 0, 0);
+        ok(value == data[i], "Got unexpected value 0x%08x at %u.\n", value, i);
+    }
+    release_resource_readback(&rb);
+
+    /* NO_OVERWRITE maps see the data of the previous map. */
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)buffer,
+            0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+    ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+    memcpy(map_desc.pData, data, sizeof(data));
+    ID3D11DeviceContext_Unmap(deferred_context, (ID3D11Resource *)buffer, 0);
+    hr = ID3D11DeviceContext_Map(deferred_context, (ID3D11Resource *)buffer,
+            0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &map_desc);
+    ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(data); ++i)
+        ok(((DWORD *)map_desc.pData)[i] == data[i], "Got unexpected value 0x%08x at %u.\n",
+                ((DWORD *)map_desc.pData)[i], i);
+    ((DWORD *)map_desc.pData)[3] = 0xdeadbeef;
+    ID3D11DeviceContext_Unmap(deferred_context, (ID3D11Resource *)buffer, 0);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &command_list);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list, FALSE);
+    ID3D11CommandList_Release(command_list);
+
+    get_buffer_readback(buffer, &rb);
+    for (i = 0; i < ARRAY_SIZE(data); ++i)
+    {
+        DWORD value = get_readback_color(&rb, i, 0, 0);
+        ok(value == (i == 3 ? 0xdeadbeef : data[i]), "Got unexpected value 0x%08x at %u.\n", value, i);
+    }
+    release_resource_readback(&rb);
+
+    /* The state set on the deferred context is kept for the next command
+     * list with RestoreDeferredContextState. */
+    draw_color_quad(&test_context, &green_vec);
+    ID3D11DeviceContext_ClearRenderTargetView(context, test_context.backbuffer_rtv, red);
+
+    ID3D11DeviceContext_OMSetRenderTargets(deferred_context, 1, &test_context.backbuffer_rtv, NULL);
+    set_viewport(deferred_context, 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    ID3D11DeviceContext_IASetInputLayout(deferred_context, test_context.input_layout);
+    ID3D11DeviceContext_IASetPrimitiveTopology(deferred_context, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    stride = sizeof(struct vec3);
+    offset = 0;
+    ID3D11DeviceContext_IASetVertexBuffers(deferred_context, 0, 1, &test_context.vb, &stride, &offset);
+    ID3D11DeviceContext_VSSetShader(deferred_context, test_context.vs, NULL, 0);
+    ID3D11DeviceContext_PSSetShader(deferred_context, test_context.ps, NULL, 0);
+    ID3D11DeviceContext_PSSetConstantBuffers(deferred_context, 0, 1, &test_context.ps_cb);
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, TRUE, &command_list);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11DeviceContext_Draw(deferred_context, 4, 0);
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &command_list2);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list2, FALSE);
+    check_texture_color(test_context.backbuffer, 0xff00ff00, 0);
+    ID3D11CommandList_Release(command_list2);
+    ID3D11CommandList_Release(command_list);
+
+    /* Without it, the next command list starts with the default state. */
+    ID3D11DeviceContext_ClearRenderTargetView(context, test_context.backbuffer_rtv, red);
+    ID3D11DeviceContext_Draw(deferred_context, 4, 0);
+    hr = ID3D11DeviceContext_FinishCommandList(deferred_context, FALSE, &command_list);
+    ok(SUCCEEDED(hr), "Failed to finish command list, hr %#x.\n", hr);
+    ID3D11DeviceContext_ExecuteCommandList(context, command_list, FALSE);
+    check_texture_color(test_context.backbuffer, 0xff0000ff, 0);
+    ID3D11CommandList_Release(command_list);
+
+    ID3D11Buffer_Release(buffer);
+    ID3D11DeviceContext_Release(deferred_context);
+    release_test_context(&test_context);
+}
+
+static void test_dynamic_buffer_map(void)
+{
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    D3D11_BUFFER_DESC buffer_desc;
+    ID3D11DeviceContext *context;
+    struct resource_readback rb;
+    ID3D11Device *device;
+    ID3D11Buffer *buffer;
+    unsigned int i, j;
+    DWORD *data;
+    ULONG refcount;
+    HRESULT hr;
+
+    if (!(device = create_device(NULL)))
+    {
+        skip("Failed to create device.\n");
+        return;
+    }
+
+    ID3D11Device_GetImmediateContext(device, &context);
+
+    buffer_desc.ByteWidth = 64 * sizeof(DWORD);
+    buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+    buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    buffer_desc.MiscFlags = 0;
+    buffer_desc.StructureByteStride = 0;
+    hr = ID3D11Device_CreateBuffer(device, &buffer_desc, NULL, &buffer);
+    ok(SUCCEEDED(hr), "Failed to create buffer, hr %#x.\n", hr);
+
+    /* Many small DISCARD maps, each followed by NOOVERWRITE maps appending to
+     * the buffer. Only the last set of updates should be visible. */
+    for (i = 0; i < 100; ++i)
+    {
+        hr = ID3D11DeviceContext_Map(context, (ID3D11Resource *)buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+        ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+        data = map_desc.pData;
+        for (j = 0; j < 16; ++j)
+            data[j] = i << 16 | j;
+        ID3D11DeviceContext_Unmap(context, (ID3D11Resource *)buffer, 0);
+
+        hr = ID3D11DeviceContext_Map(context, (ID3D11Resource *)buffer, 0,
+                D3D11_MAP_WRITE_NO_OVERWRITE, 0, &map_desc);
+        ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+        data = map_desc.pData;
+        for (j = 16; j < 64; ++j)
+            data[j] = i << 16 | j;
+        ID3D11DeviceContext_Unmap(context, (ID3D11Resource *)buffer, 0);
+    }
+
+    get_buffer_readback(buffer, &rb);
+    for (j = 0; j < 64; ++j)
+    {
+        DWORD value = get_readback_color(&rb, j, 0, 0);
+        ok(value == (99 << 16 | j), "Got unexpected value 0x%08x at %u.\n", value, j);
+    }
+    release_resource_readback(&rb);
+
+    /* A NOOVERWRITE map only updates the mapped data. */
+    hr = ID3D11DeviceContext_Map(context, (ID3D11Resource *)buffer, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &map_desc);
+    ok(SUCCEEDED(hr), "Failed to map buffer, hr %#x.\n", hr);
+    data = map_desc.pData;
+    data[63] = 0xdeadbeef;
+    ID3D11DeviceContext_Unmap(context, (ID3D11Resource *)buffer, 0);
+
+    get_buffer_readback(buffer, &rb);
+    for (j = 0; j < 63; ++j)
+    {
+        DWORD value = get_readback_color(&rb, j, 0, 0);
+        ok(value == (99 << 16 | j), "Got unexpected value 0x%08x at %u.\n", value, j);
+    }
+    ok(get_readback_color(&rb, 63, 0, 0) == 0xdeadbeef,
+            "Got unexpected value 0x%08x.\n", get_readback_color(&rb, 63, 0, 0));
+    release_resource_readback(&rb);
+
+    ID3D11Buffer_Release(buffer);
+    ID3D11DeviceContext_Release(context);
+    refcount = ID3D11Device_Release(device);
+    ok(!refcount, "Device has %u references left.\n", refcount);
+}
+
 START_TEST(d3d11)
 {
     unsigned int argc, i;
@@ -28249,6 +28494,8 @@ START_TEST(d3d11)
     queue_test(test_sample_shading);
     queue_test(test_sample_mask);
     queue_test(test_depth_clip);
+    queue_test(test_deferred_context);
+    queue_test(test_dynamic_buffer_map);
 
     run_queued_tests();
 }
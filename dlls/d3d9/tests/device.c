@@ -5569,6 +5569,81 @@ static void test_vb_lock_flags(void)
     DestroyWindow(window);
 }
 
+static void test_vb_discard_range(void)
+{
+    IDirect3DVertexBuffer9 *buffer;
+    IDirect3DDevice9 *device;
+    IDirect3D9 *d3d9;
+    unsigned int i, j;
+    ULONG refcount;
+    DWORD *data;
+    HWND window;
+    HRESULT hr;
+
+    window = CreateWindowA("d3d9_test_wc", "d3d9_test", WS_OVERLAPPEDWINDOW,
+            0, 0, 640, 480, 0, 0, 0, 0);
+    d3d9 = Direct3DCreate9(D3D_SDK_VERSION);
+    ok(!!d3d9, "Failed to create a D3D object.\n");
+    if (!(device = create_device(d3d9, window, NULL)))
+    {
+        skip("Failed to create a D3D device, skipping tests.\n");
+        IDirect3D9_Release(d3d9);
+        DestroyWindow(window);
+        return;
+    }
+
+    hr = IDirect3DDevice9_CreateVertexBuffer(device, 64 * sizeof(*data), D3DUSAGE_DYNAMIC, 0,
+            D3DPOOL_DEFAULT, &buffer, NULL);
+    ok(SUCCEEDED(hr), "Failed to create vertex buffer, hr %#x.\n", hr);
+
+    hr = IDirect3DVertexBuffer9_Lock(buffer, 0, 0, (void **)&data, 0);
+    ok(SUCCEEDED(hr), "Failed to lock vertex buffer, hr %#x.\n", hr);
+    for (j = 0; j < 64; ++j)
+        data[j] = 0xcc000000 | j;
+    hr = IDirect3DVertexBuffer9_Unlock(buffer);
+    ok(SUCCEEDED(hr), "Failed to unlock vertex buffer, hr %#x.\n", hr);
+
+    /* DISCARD locks of a part of the buffer. Windows may discard the rest of
+     * the buffer, but some applications depend on it being kept. */
+    for (i = 0; i < 4; ++i)
+    {
+        hr = IDirect3DVertexBuffer9_Lock(buffer, (16 + i) * sizeof(*data), 8 * sizeof(*data),
+                (void **)&data, D3DLOCK_DISCARD);
+        ok(SUCCEEDED(hr), "Failed to lock vertex buffer, hr %#x.\n", hr);
+        for (j = 0; j < 8; ++j)
+            data[j] = i << 16 | (16 + i + j);
+        hr = IDirect3DVertexBuffer9_Unlock(buffer);
+        ok(SUCCEEDED(hr), "Failed to unlock vertex buffer, hr %#x.\n", hr);
+
+        hr = IDirect3DVertexBuffer9_Lock(buffer, 0, 0, (void **)&data, D3DLOCK_READONLY);
+        ok(SUCCEEDED(hr), "Failed to lock vertex buffer, hr %#x.\n", hr);
+        for (j = 0; j < 64; ++j)
+        {
+            DWORD expected;
+
+            if (j >= 16 + i && j < 24 + i)
+                expected = i << 16 | j;
+            else if (j >= 16 && j < 16 + i)
+                expected = (j - 16) << 16 | j;
+            else
+                expected = 0xcc000000 | j;
+            if (j >= 16 + i && j < 24 + i)
+                ok(data[j] == expected, "Lock %u: got unexpected value %#x at %u.\n", i, data[j], j);
+            else
+                ok(data[j] == expected || broken(TRUE), "Lock %u: got unexpected value %#x at %u.\n",
+                        i, data[j], j);
+        }
+        hr = IDirect3DVertexBuffer9_Unlock(buffer);
+        ok(SUCCEEDED(hr), "Failed to unlock vertex buffer, hr %#x.\n", hr);
+    }
+
+    IDirect3DVertexBuffer9_Release(buffer);
+    refcount = IDirect3DDevice9_Release(device);
+    ok(!refcount, "Device has %u references left.\n", refcount);
+    IDirect3D9_Release(d3d9);
+    DestroyWindow(window);
+}
+
 static const char *debug_d3dpool(D3DPOOL pool)
 {
     switch (pool)
@@ -12718,6 +12793,7 @@ START_TEST(device)
     test_volume_get_container();
     test_volume_resource();
     test_vb_lock_flags();
+    test_vb_discard_range();
     test_vertex_buffer_alignment();
     test_query_support();
     test_occlusion_query();
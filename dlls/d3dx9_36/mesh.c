@@ -1206,35 +1206,165 @@ cleanup:
     return hr;
 }
 
-struct vertex_metadata {
-  float key;
-  DWORD vertex_index;
-  DWORD first_shared_index;
+/* Coincident vertices are found with a uniform grid over the vertex
+ * positions. Each vertex is stored in the hash bucket of its grid cell, so
+ * only the vertices in the neighbouring cells need to be compared. */
+#define VERTEX_GRID_MAX_CELL ((LONGLONG)1 << 62)
+
+struct vertex_grid
+{
+    DWORD *buckets;
+    DWORD *next;
+    LONGLONG (*cells)[3];
+    DWORD bucket_mask;
+    float cell_size;
 };
 
-static int compare_vertex_keys(const void *a, const void *b)
+static LONGLONG vertex_grid_cell(float coord, float cell_size)
 {
-    const struct vertex_metadata *left = a;
-    const struct vertex_metadata *right = b;
-    if (left->key == right->key)
-        return 0;
-    return left->key < right->key ? -1 : 1;
+    union
+    {
+        float f;
+        DWORD d;
+    } u;
+    double cell;
+
+    /* With a zero epsilon vertices have to match exactly, so use the value
+     * itself. Negative zero is equal to positive zero. */
+    if (cell_size == 0.0f)
+    {
+        u.f = coord == 0.0f ? 0.0f : coord;
+        return u.d;
+    }
+
+    cell = floor(coord / (double)cell_size);
+    /* Far away, infinite and NaN coordinates just share the outermost cells,
+     * the actual comparison still decides whether vertices coincide. */
+    if (!(cell > -VERTEX_GRID_MAX_CELL))
+        return -VERTEX_GRID_MAX_CELL;
+    if (!(cell < VERTEX_GRID_MAX_CELL))
+        return VERTEX_GRID_MAX_CELL;
+    return cell;
+}
+
+static DWORD vertex_grid_hash(const struct vertex_grid *grid, const LONGLONG *cell)
+{
+    ULONGLONG hash;
+
+    hash = (ULONGLONG)cell[0] * 73856093;
+    hash ^= (ULONGLONG)cell[1] * 19349663;
+    hash ^= (ULONGLONG)cell[2] * 83492791;
+    return (hash ^ (hash >> 32)) & grid->bucket_mask;
+}
+
+static HRESULT vertex_grid_init(struct vertex_grid *grid, const BYTE *vertices, DWORD vertex_size,
+        DWORD num_vertices, float epsilon)
+{
+    DWORD bucket_count = 1;
+    DWORD i, hash;
+
+    while (bucket_count < num_vertices && bucket_count < 0x80000000u)
+        bucket_count <<= 1;
+
+    grid->buckets = HeapAlloc(GetProcessHeap(), 0, bucket_count * sizeof(*grid->buckets));
+    grid->next = HeapAlloc(GetProcessHeap(), 0, num_vertices * sizeof(*grid->next));
+    grid->cells = HeapAlloc(GetProcessHeap(), 0, num_vertices * sizeof(*grid->cells));
+    if (!grid->buckets || !grid->next || !grid->cells)
+        return E_OUTOFMEMORY;
+    grid->bucket_mask = bucket_count - 1;
+    /* Vertices within epsilon of each other are at most one cell apart, twice
+     * epsilon leaves enough room for rounding errors in the comparison. */
+    grid->cell_size = 2.0f * epsilon;
+
+    memset(grid->buckets, 0xff, bucket_count * sizeof(*grid->buckets));
+    /* Insert in reverse so that the bucket lists are in vertex order. */
+    for (i = num_vertices; i--;)
+    {
+        const D3DXVECTOR3 *vertex = (const D3DXVECTOR3 *)(vertices + i * vertex_size);
+
+        grid->cells[i][0] = vertex_grid_cell(vertex->x, grid->cell_size);
+        grid->cells[i][1] = vertex_grid_cell(vertex->y, grid->cell_size);
+        grid->cells[i][2] = vertex_grid_cell(vertex->z, grid->cell_size);
+        hash = vertex_grid_hash(grid, grid->cells[i]);
+        grid->next[i] = grid->buckets[hash];
+        grid->buckets[hash] = i;
+    }
+
+    return D3D_OK;
+}
+
+static void vertex_grid_cleanup(struct vertex_grid *grid)
+{
+    HeapFree(GetProcessHeap(), 0, grid->buckets);
+    HeapFree(GetProcessHeap(), 0, grid->next);
+    HeapFree(GetProcessHeap(), 0, grid->cells);
+}
+
+/* Checks whether the faces of two corners, which share a vertex position,
+ * also share the position of an adjacent corner with opposite winding, and
+ * links them if neither edge has an adjacent face yet. */
+static void match_adjacent_corners(DWORD *adjacency, const DWORD *indices, const BYTE *vertices,
+        DWORD vertex_size, float epsilon, DWORD shared_index_a, DWORD shared_index_b)
+{
+    const float epsilon_sq = epsilon * epsilon;
+    DWORD base_a = (shared_index_a / 3) * 3;
+    DWORD base_b = (shared_index_b / 3) * 3;
+    BOOL adjacent;
+    int k;
+
+    /* faces are adjacent if they have another coincident vertex */
+    for (k = 0; k < 3; k++)
+    {
+        if (adjacency[base_b + k] == shared_index_a / 3)
+            return;
+    }
+
+    for (k = 1; k <= 2; k++)
+    {
+        DWORD vertex_index_a = base_a + (shared_index_a + k) % 3;
+        DWORD vertex_index_b = base_b + (shared_index_b + (3 - k)) % 3;
+
+        adjacent = indices[vertex_index_a] == indices[vertex_index_b];
+        if (!adjacent && epsilon >= 0.0f)
+        {
+            D3DXVECTOR3 delta = {0.0f, 0.0f, 0.0f};
+            FLOAT length_sq;
+
+            D3DXVec3Subtract(&delta,
+                    (const D3DXVECTOR3 *)(vertices + indices[vertex_index_a] * vertex_size),
+                    (const D3DXVECTOR3 *)(vertices + indices[vertex_index_b] * vertex_size));
+            length_sq = D3DXVec3LengthSq(&delta);
+            adjacent = epsilon == 0.0f ? length_sq == 0.0f : length_sq < epsilon_sq;
+        }
+        if (adjacent)
+        {
+            DWORD adj_a = base_a + 2 - (vertex_index_a + shared_index_a + 1) % 3;
+            DWORD adj_b = base_b + 2 - (vertex_index_b + shared_index_b + 1) % 3;
+
+            if (adjacency[adj_a] == -1 && adjacency[adj_b] == -1)
+            {
+                adjacency[adj_a] = base_b / 3;
+                adjacency[adj_b] = base_a / 3;
+                return;
+            }
+        }
+    }
 }
 
 static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsilon, DWORD *adjacency)
 {
     struct d3dx9_mesh *This = impl_from_ID3DXMesh(iface);
+    struct vertex_grid grid = {0};
     HRESULT hr;
     BYTE *vertices = NULL;
     const DWORD *indices = NULL;
     DWORD vertex_size;
     DWORD buffer_size;
-    /* sort the vertices by (x + y + z) to quickly find coincident vertices */
-    struct vertex_metadata *sorted_vertices;
-    /* shared_indices links together identical indices in the index buffer so
-     * that adjacency checks can be limited to faces sharing a vertex */
+    /* first_shared_index and shared_indices link together identical indices
+     * in the index buffer so that adjacency checks can be limited to faces
+     * sharing a vertex */
+    DWORD *first_shared_index;
     DWORD *shared_indices = NULL;
-    const FLOAT epsilon_sq = epsilon * epsilon;
     DWORD i;
 
     TRACE("iface %p, epsilon %.8e, adjacency %p.\n", iface, epsilon, adjacency);
@@ -1242,13 +1372,13 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
     if (!adjacency)
         return D3DERR_INVALIDCALL;
 
-    buffer_size = This->numfaces * 3 * sizeof(*shared_indices) + This->numvertices * sizeof(*sorted_vertices);
+    buffer_size = This->numfaces * 3 * sizeof(*shared_indices) + This->numvertices * sizeof(*first_shared_index);
     if (!(This->options & D3DXMESH_32BIT))
         buffer_size += This->numfaces * 3 * sizeof(*indices);
     shared_indices = HeapAlloc(GetProcessHeap(), 0, buffer_size);
     if (!shared_indices)
         return E_OUTOFMEMORY;
-    sorted_vertices = (struct vertex_metadata*)(shared_indices + This->numfaces * 3);
+    first_shared_index = shared_indices + This->numfaces * 3;
 
     hr = iface->lpVtbl->LockVertexBuffer(iface, D3DLOCK_READONLY, (void**)&vertices);
     if (FAILED(hr)) goto cleanup;
@@ -1257,105 +1387,79 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
 
     if (!(This->options & D3DXMESH_32BIT)) {
         const WORD *word_indices = (const WORD*)indices;
-        DWORD *dword_indices = (DWORD*)(sorted_vertices + This->numvertices);
+        DWORD *dword_indices = first_shared_index + This->numvertices;
         indices = dword_indices;
         for (i = 0; i < This->numfaces * 3; i++)
             *dword_indices++ = *word_indices++;
     }
 
     vertex_size = iface->lpVtbl->GetNumBytesPerVertex(iface);
-    for (i = 0; i < This->numvertices; i++) {
-        D3DXVECTOR3 *vertex = (D3DXVECTOR3*)(vertices + vertex_size * i);
-        sorted_vertices[i].first_shared_index = -1;
-        sorted_vertices[i].key = vertex->x + vertex->y + vertex->z;
-        sorted_vertices[i].vertex_index = i;
-    }
-    for (i = 0; i < This->numfaces * 3; i++) {
-        DWORD *first_shared_index = &sorted_vertices[indices[i]].first_shared_index;
-        shared_indices[i] = *first_shared_index;
-        *first_shared_index = i;
+    memset(first_shared_index, 0xff, This->numvertices * sizeof(*first_shared_index));
+    for (i = This->numfaces * 3; i--;) {
+        shared_indices[i] = first_shared_index[indices[i]];
+        first_shared_index[indices[i]] = i;
         adjacency[i] = -1;
     }
-    qsort(sorted_vertices, This->numvertices, sizeof(*sorted_vertices), compare_vertex_keys);
+
+    if (epsilon >= 0.0f)
+    {
+        hr = vertex_grid_init(&grid, vertices, vertex_size, This->numvertices, epsilon);
+        if (FAILED(hr)) goto cleanup;
+    }
 
     for (i = 0; i < This->numvertices; i++) {
-        struct vertex_metadata *sorted_vertex_a = &sorted_vertices[i];
-        D3DXVECTOR3 *vertex_a = (D3DXVECTOR3*)(vertices + sorted_vertex_a->vertex_index * vertex_size);
-        DWORD shared_index_a = sorted_vertex_a->first_shared_index;
-
-        while (shared_index_a != -1) {
-            DWORD j = i;
-            DWORD shared_index_b = shared_indices[shared_index_a];
-            struct vertex_metadata *sorted_vertex_b = sorted_vertex_a;
-
-            while (TRUE) {
-                while (shared_index_b != -1) {
-                    /* faces are adjacent if they have another coincident vertex */
-                    DWORD base_a = (shared_index_a / 3) * 3;
-                    DWORD base_b = (shared_index_b / 3) * 3;
-                    BOOL adjacent = FALSE;
-                    int k;
-
-                    for (k = 0; k < 3; k++) {
-                        if (adjacency[base_b + k] == shared_index_a / 3) {
-                            adjacent = TRUE;
-                            break;
-                        }
-                    }
-                    if (!adjacent) {
-                        for (k = 1; k <= 2; k++) {
-                            DWORD vertex_index_a = base_a + (shared_index_a + k) % 3;
-                            DWORD vertex_index_b = base_b + (shared_index_b + (3 - k)) % 3;
-                            adjacent = indices[vertex_index_a] == indices[vertex_index_b];
-                            if (!adjacent && epsilon >= 0.0f) {
-                                D3DXVECTOR3 delta = {0.0f, 0.0f, 0.0f};
-                                FLOAT length_sq;
-
-                                D3DXVec3Subtract(&delta,
-                                                 (D3DXVECTOR3*)(vertices + indices[vertex_index_a] * vertex_size),
-                                                 (D3DXVECTOR3*)(vertices + indices[vertex_index_b] * vertex_size));
-                                length_sq = D3DXVec3LengthSq(&delta);
-                                adjacent = epsilon == 0.0f ? length_sq == 0.0f : length_sq < epsilon_sq;
-                            }
-                            if (adjacent) {
-                                DWORD adj_a = base_a + 2 - (vertex_index_a + shared_index_a + 1) % 3;
-                                DWORD adj_b = base_b + 2 - (vertex_index_b + shared_index_b + 1) % 3;
-                                if (adjacency[adj_a] == -1 && adjacency[adj_b] == -1) {
-                                    adjacency[adj_a] = base_b / 3;
-                                    adjacency[adj_b] = base_a / 3;
-                                    break;
-                                }
-                            }
-                        }
-                    }
+        const D3DXVECTOR3 *vertex_a = (const D3DXVECTOR3 *)(vertices + i * vertex_size);
+        DWORD shared_index_a, shared_index_b;
+        LONGLONG cell[3];
+        int range, x, y, z;
 
-                    shared_index_b = shared_indices[shared_index_b];
-                }
-                while (++j < This->numvertices) {
-                    D3DXVECTOR3 *vertex_b;
+        if (first_shared_index[i] == -1)
+            continue;
 
-                    sorted_vertex_b++;
-                    if (sorted_vertex_b->key - sorted_vertex_a->key > epsilon * 3.0f) {
-                        /* no more coincident vertices to try */
-                        j = This->numvertices;
-                        break;
-                    }
-                    /* check for coincidence */
-                    vertex_b = (D3DXVECTOR3*)(vertices + sorted_vertex_b->vertex_index * vertex_size);
-                    if (fabsf(vertex_a->x - vertex_b->x) <= epsilon &&
-                        fabsf(vertex_a->y - vertex_b->y) <= epsilon &&
-                        fabsf(vertex_a->z - vertex_b->z) <= epsilon)
+        /* corners using the same vertex */
+        for (shared_index_a = first_shared_index[i]; shared_index_a != -1; shared_index_a = shared_indices[shared_index_a])
+        {
+            for (shared_index_b = shared_indices[shared_index_a]; shared_index_b != -1; shared_index_b = shared_indices[shared_index_b])
+                match_adjacent_corners(adjacency, indices, vertices, vertex_size, epsilon, shared_index_a, shared_index_b);
+        }
+
+        if (epsilon < 0.0f)
+            continue;
+
+        /* corners using coincident vertices with a higher index */
+        range = grid.cell_size == 0.0f ? 0 : 1;
+        for (x = -range; x <= range; x++)
+        {
+            cell[0] = grid.cells[i][0] + x;
+            for (y = -range; y <= range; y++)
+            {
+                cell[1] = grid.cells[i][1] + y;
+                for (z = -range; z <= range; z++)
+                {
+                    DWORD j;
+
+                    cell[2] = grid.cells[i][2] + z;
+                    for (j = grid.buckets[vertex_grid_hash(&grid, cell)]; j != -1; j = grid.next[j])
                     {
-                        break;
+                        const D3DXVECTOR3 *vertex_b = (const D3DXVECTOR3 *)(vertices + j * vertex_size);
+
+                        if (j <= i || first_shared_index[j] == -1
+                                || memcmp(grid.cells[j], cell, sizeof(cell)))
+                            continue;
+                        /* check for coincidence */
+                        if (!(fabsf(vertex_a->x - vertex_b->x) <= epsilon
+                                && fabsf(vertex_a->y - vertex_b->y) <= epsilon
+                                && fabsf(vertex_a->z - vertex_b->z) <= epsilon))
+                            continue;
+
+                        for (shared_index_a = first_shared_index[i]; shared_index_a != -1; shared_index_a = shared_indices[shared_index_a])
+                        {
+                            for (shared_index_b = first_shared_index[j]; shared_index_b != -1; shared_index_b = shared_indices[shared_index_b])
+                                match_adjacent_corners(adjacency, indices, vertices, vertex_size, epsilon, shared_index_a, shared_index_b);
+                        }
                     }
                 }
-                if (j >= This->numvertices)
-                    break;
-                shared_index_b = sorted_vertex_b->first_shared_index;
             }
-
-            sorted_vertex_a->first_shared_index = shared_indices[sorted_vertex_a->first_shared_index];
-            shared_index_a = sorted_vertex_a->first_shared_index;
         }
     }
 
@@ -1363,6 +1467,7 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
 cleanup:
     if (indices) iface->lpVtbl->UnlockIndexBuffer(iface);
     if (vertices) iface->lpVtbl->UnlockVertexBuffer(iface);
+    vertex_grid_cleanup(&grid);
     HeapFree(GetProcessHeap(), 0, shared_indices);
     return hr;
 }
@@ -1640,6 +1745,387 @@ static HRESULT remap_faces_for_attrsort(struct d3dx9_mesh *This, const DWORD *in
     return D3D_OK;
 }
 
+/* Vertex cache optimisation, based on Tom Forsyth's "Linear-Speed Vertex Cache
+ * Optimisation". Faces are emitted greedily, picking the face with the
+ * highest score among the faces using vertices in a simulated LRU cache.
+ * Vertex scores favour recently used vertices and vertices with few
+ * remaining faces. */
+#define VCACHE_SIZE 32
+#define VCACHE_VALENCE_TABLE_SIZE 32
+
+struct vcache_vertex
+{
+    float score;
+    int cache_pos;
+    DWORD face_start;
+    DWORD face_count;
+};
+
+struct vcache_scores
+{
+    float cache[VCACHE_SIZE];
+    float valence[VCACHE_VALENCE_TABLE_SIZE];
+};
+
+static void vcache_init_scores(struct vcache_scores *scores)
+{
+    unsigned int i;
+
+    for (i = 0; i < VCACHE_SIZE; ++i)
+    {
+        /* The vertices of the last face get a fixed score, so that the
+         * algorithm doesn't simply prefer faces sharing an edge with it. */
+        if (i < 3)
+            scores->cache[i] = 0.75f;
+        else
+            scores->cache[i] = powf(1.0f - (i - 3) * (1.0f / (VCACHE_SIZE - 3)), 1.5f);
+    }
+
+    scores->valence[0] = 0.0f;
+    for (i = 1; i < VCACHE_VALENCE_TABLE_SIZE; ++i)
+        scores->valence[i] = 2.0f * powf(i, -0.5f);
+}
+
+static float vcache_vertex_score(const struct vcache_scores *scores, const struct vcache_vertex *vertex)
+{
+    float score;
+
+    if (!vertex->face_count)
+        return -1.0f;
+
+    score = vertex->cache_pos < 0 ? 0.0f : scores->cache[vertex->cache_pos];
+    if (vertex->face_count < VCACHE_VALENCE_TABLE_SIZE)
+        score += scores->valence[vertex->face_count];
+    else
+        score += 2.0f * powf(vertex->face_count, -0.5f);
+
+    return score;
+}
+
+/* The sum of three single precision scores is exact in double precision, so
+ * the face score doesn't depend on the order of the vertices. */
+static double vcache_face_score(const struct vcache_vertex *vertices, const DWORD *face)
+{
+    return (double)vertices[face[0]].score + vertices[face[1]].score + vertices[face[2]].score;
+}
+
+/* Fills face_remap with the new face order, i.e. face_remap[i] is the
+ * original index of the i-th face. */
+static HRESULT optimize_faces(const DWORD *indices, DWORD num_faces, DWORD num_vertices, DWORD *face_remap)
+{
+    DWORD cache[VCACHE_SIZE + 3], new_cache[VCACHE_SIZE + 3];
+    DWORD cache_size = 0, new_cache_size;
+    struct vcache_vertex *vertices;
+    struct vcache_scores scores;
+    DWORD best_face, cursor;
+    DWORD *vertex_faces;
+    double best_score;
+    BYTE *face_added;
+    DWORD i, j, k;
+
+    for (i = 0; i < num_faces * 3; ++i)
+    {
+        if (indices[i] >= num_vertices)
+        {
+            WARN("Index %u of face %u is out of range.\n", indices[i], i / 3);
+            return D3DERR_INVALIDCALL;
+        }
+    }
+
+    vertices = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_vertices * sizeof(*vertices));
+    vertex_faces = HeapAlloc(GetProcessHeap(), 0, num_faces * 3 * sizeof(*vertex_faces));
+    face_added = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_faces * sizeof(*face_added));
+    if (!vertices || !vertex_faces || !face_added)
+    {
+        HeapFree(GetProcessHeap(), 0, vertices);
+        HeapFree(GetProcessHeap(), 0, vertex_faces);
+        HeapFree(GetProcessHeap(), 0, face_added);
+        return E_OUTOFMEMORY;
+    }
+
+    /* Build the per-vertex face lists. The first face_count entries of each
+     * list are the faces that haven't been emitted yet. */
+    for (i = 0; i < num_faces * 3; ++i)
+        ++vertices[indices[i]].face_count;
+    for (i = 0, j = 0; i < num_vertices; ++i)
+    {
+        vertices[i].face_start = j;
+        j += vertices[i].face_count;
+        vertices[i].face_count = 0;
+        vertices[i].cache_pos = -1;
+    }
+    for (i = 0; i < num_faces * 3; ++i)
+    {
+        struct vcache_vertex *vertex = &vertices[indices[i]];
+
+        vertex_faces[vertex->face_start + vertex->face_count++] = i / 3;
+    }
+
+    vcache_init_scores(&scores);
+    for (i = 0; i < num_vertices; ++i)
+        vertices[i].score = vcache_vertex_score(&scores, &vertices[i]);
+
+    /* Ties go to the face with the highest index. For simple meshes this
+     * gives the same face order as native. */
+    best_face = 0;
+    best_score = -1.0;
+    for (i = 0; i < num_faces; ++i)
+    {
+        double score = vcache_face_score(vertices, &indices[i * 3]);
+
+        if (score >= best_score)
+        {
+            best_score = score;
+            best_face = i;
+        }
+    }
+
+    cursor = num_faces;
+    for (i = 0; i < num_faces; ++i)
+    {
+        const DWORD *face;
+
+        /* None of the cached vertices has faces left. Instead of searching
+         * for the best face, which would make this quadratic for meshes
+         * with many disconnected parts, continue with the last face that
+         * hasn't been emitted yet. */
+        if (best_face == ~0u)
+        {
+            while (face_added[cursor - 1])
+                --cursor;
+            best_face = cursor - 1;
+        }
+
+        face_remap[i] = best_face;
+        face_added[best_face] = 1;
+        face = &indices[best_face * 3];
+
+        for (j = 0; j < 3; ++j)
+        {
+            struct vcache_vertex *vertex = &vertices[face[j]];
+            DWORD *faces = &vertex_faces[vertex->face_start];
+
+            for (k = 0; k < vertex->face_count; ++k)
+            {
+                if (faces[k] == best_face)
+                {
+                    faces[k] = faces[--vertex->face_count];
+                    break;
+                }
+            }
+        }
+
+        /* Move the vertices of the face to the front of the cache. */
+        new_cache_size = 0;
+        for (j = 0; j < 3; ++j)
+        {
+            if ((j > 0 && face[j] == face[0]) || (j > 1 && face[j] == face[1]))
+                continue;
+            new_cache[new_cache_size++] = face[j];
+        }
+        for (j = 0; j < cache_size; ++j)
+        {
+            if (cache[j] != face[0] && cache[j] != face[1] && cache[j] != face[2])
+                new_cache[new_cache_size++] = cache[j];
+        }
+
+        for (j = 0; j < new_cache_size; ++j)
+        {
+            struct vcache_vertex *vertex = &vertices[new_cache[j]];
+
+            vertex->cache_pos = j < VCACHE_SIZE ? j : -1;
+            vertex->score = vcache_vertex_score(&scores, vertex);
+        }
+
+        cache_size = min(new_cache_size, VCACHE_SIZE);
+        memcpy(cache, new_cache, cache_size * sizeof(*cache));
+
+        /* Only the scores of faces using the updated vertices changed. */
+        best_face = ~0u;
+        best_score = -1.0;
+        for (j = 0; j < new_cache_size; ++j)
+        {
+            const struct vcache_vertex *vertex = &vertices[new_cache[j]];
+            const DWORD *faces = &vertex_faces[vertex->face_start];
+
+            for (k = 0; k < vertex->face_count; ++k)
+            {
+                double score = vcache_face_score(vertices, &indices[faces[k] * 3]);
+
+                if (score > best_score || (score == best_score && faces[k] > best_face))
+                {
+                    best_score = score;
+                    best_face = faces[k];
+                }
+            }
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, vertices);
+    HeapFree(GetProcessHeap(), 0, vertex_faces);
+    HeapFree(GetProcessHeap(), 0, face_added);
+
+    return D3D_OK;
+}
+
+/* Orders the vertices by first use, which gives the best vertex fetch
+ * locality for a given face order. vertex_remap[i] is the original index of
+ * the i-th vertex, the entries for unused vertices are set to -1. */
+static HRESULT optimize_vertices(const DWORD *indices, DWORD num_faces, DWORD num_vertices,
+        DWORD *vertex_remap, DWORD *num_used_vertices)
+{
+    BYTE *vertex_used;
+    DWORD count = 0;
+    DWORD i;
+
+    if (!(vertex_used = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, num_vertices)))
+        return E_OUTOFMEMORY;
+
+    for (i = 0; i < num_faces * 3; ++i)
+    {
+        if (indices[i] >= num_vertices)
+        {
+            WARN("Index %u of face %u is out of range.\n", indices[i], i / 3);
+            HeapFree(GetProcessHeap(), 0, vertex_used);
+            return D3DERR_INVALIDCALL;
+        }
+        if (vertex_used[indices[i]])
+            continue;
+        vertex_used[indices[i]] = 1;
+        vertex_remap[count++] = indices[i];
+    }
+    for (i = count; i < num_vertices; ++i)
+        vertex_remap[i] = -1;
+
+    HeapFree(GetProcessHeap(), 0, vertex_used);
+    *num_used_vertices = count;
+
+    return D3D_OK;
+}
+
+/* Optimises the face order within each attribute range of an attribute sorted
+ * mesh, and updates face_remap (old -> new) accordingly. */
+static HRESULT remap_faces_for_vertex_cache(struct d3dx9_mesh *This, const DWORD *indices,
+        const DWORD *sorted_attrib_buffer, DWORD *face_remap)
+{
+    DWORD *sorted_indices, *order, *new_position, *local_vertex, *range_vertices;
+    DWORD start, end, num_local_vertices, i;
+    HRESULT hr = D3D_OK;
+
+    sorted_indices = HeapAlloc(GetProcessHeap(), 0, This->numfaces * 3 * sizeof(*sorted_indices));
+    order = HeapAlloc(GetProcessHeap(), 0, This->numfaces * sizeof(*order));
+    new_position = HeapAlloc(GetProcessHeap(), 0, This->numfaces * sizeof(*new_position));
+    local_vertex = HeapAlloc(GetProcessHeap(), 0, This->numvertices * sizeof(*local_vertex));
+    range_vertices = HeapAlloc(GetProcessHeap(), 0, This->numvertices * sizeof(*range_vertices));
+    if (!sorted_indices || !order || !new_position || !local_vertex || !range_vertices)
+    {
+        hr = E_OUTOFMEMORY;
+        goto done;
+    }
+
+    for (i = 0; i < This->numfaces * 3; ++i)
+    {
+        if (indices[i] >= This->numvertices)
+        {
+            WARN("Index %u of face %u is out of range.\n", indices[i], i / 3);
+            hr = D3DERR_INVALIDCALL;
+            goto done;
+        }
+    }
+
+    for (i = 0; i < This->numfaces; ++i)
+        memcpy(&sorted_indices[face_remap[i] * 3], &indices[i * 3], 3 * sizeof(*indices));
+
+    /* Each range is optimised on its own vertices only, numbered in order of
+     * first use, so that the total cost stays linear in the mesh size. The
+     * face order doesn't depend on the vertex numbering. */
+    memset(local_vertex, 0xff, This->numvertices * sizeof(*local_vertex));
+
+    for (start = 0; start < This->numfaces; start = end)
+    {
+        for (end = start + 1; end < This->numfaces; ++end)
+        {
+            if (sorted_attrib_buffer[end] != sorted_attrib_buffer[start])
+                break;
+        }
+
+        num_local_vertices = 0;
+        for (i = start * 3; i < end * 3; ++i)
+        {
+            DWORD vertex = sorted_indices[i];
+
+            if (local_vertex[vertex] == ~0u)
+            {
+                range_vertices[num_local_vertices] = vertex;
+                local_vertex[vertex] = num_local_vertices++;
+            }
+            sorted_indices[i] = local_vertex[vertex];
+        }
+        for (i = 0; i < num_local_vertices; ++i)
+            local_vertex[range_vertices[i]] = ~0u;
+
+        if (FAILED(hr = optimize_faces(&sorted_indices[start * 3], end - start, num_local_vertices, order)))
+            goto done;
+        for (i = start; i < end; ++i)
+            new_position[start + order[i - start]] = i;
+    }
+
+    for (i = 0; i < This->numfaces; ++i)
+        face_remap[i] = new_position[face_remap[i]];
+
+done:
+    HeapFree(GetProcessHeap(), 0, sorted_indices);
+    HeapFree(GetProcessHeap(), 0, order);
+    HeapFree(GetProcessHeap(), 0, new_position);
+    HeapFree(GetProcessHeap(), 0, local_vertex);
+    HeapFree(GetProcessHeap(), 0, range_vertices);
+    return hr;
+}
+
+/* Reorders the vertices by first use in the new face order, dropping unused
+ * vertices, and converts the indices. */
+static HRESULT remap_vertices_for_vertex_cache(struct d3dx9_mesh *This, DWORD *indices,
+        const DWORD *face_remap, DWORD *new_num_vertices, ID3DXBuffer **vertex_remap)
+{
+    DWORD *new_indices, *vertex_remap_ptr, *old_to_new;
+    HRESULT hr;
+    DWORD i;
+
+    if (FAILED(hr = D3DXCreateBuffer(This->numvertices * sizeof(DWORD), vertex_remap)))
+        return hr;
+    vertex_remap_ptr = ID3DXBuffer_GetBufferPointer(*vertex_remap);
+
+    new_indices = HeapAlloc(GetProcessHeap(), 0, This->numfaces * 3 * sizeof(*new_indices));
+    old_to_new = HeapAlloc(GetProcessHeap(), 0, This->numvertices * sizeof(*old_to_new));
+    if (!new_indices || !old_to_new)
+    {
+        hr = E_OUTOFMEMORY;
+        goto done;
+    }
+
+    for (i = 0; i < This->numfaces; ++i)
+        memcpy(&new_indices[face_remap[i] * 3], &indices[i * 3], 3 * sizeof(*indices));
+
+    if (FAILED(hr = optimize_vertices(new_indices, This->numfaces, This->numvertices,
+            vertex_remap_ptr, new_num_vertices)))
+        goto done;
+
+    for (i = 0; i < *new_num_vertices; ++i)
+        old_to_new[vertex_remap_ptr[i]] = i;
+    for (i = 0; i < This->numfaces * 3; ++i)
+        indices[i] = old_to_new[indices[i]];
+
+done:
+    HeapFree(GetProcessHeap(), 0, new_indices);
+    HeapFree(GetProcessHeap(), 0, old_to_new);
+    if (FAILED(hr))
+    {
+        ID3DXBuffer_Release(*vertex_remap);
+        *vertex_remap = NULL;
+    }
+    return hr;
+}
+
 static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags, const DWORD *adjacency_in,
         DWORD *adjacency_out, DWORD *face_remap_out, ID3DXBuffer **vertex_remap_out)
 {
@@ -1666,12 +2152,9 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
     if ((flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER)) == (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
         return D3DERR_INVALIDCALL;
 
-    if (flags & (D3DXMESHOPT_VERTEXCACHE | D3DXMESHOPT_STRIPREORDER))
+    if (flags & D3DXMESHOPT_STRIPREORDER)
     {
-        if (flags & D3DXMESHOPT_VERTEXCACHE)
-            FIXME("D3DXMESHOPT_VERTEXCACHE not implemented.\n");
-        if (flags & D3DXMESHOPT_STRIPREORDER)
-            FIXME("D3DXMESHOPT_STRIPREORDER not implemented.\n");
+        FIXME("D3DXMESHOPT_STRIPREORDER not implemented.\n");
         return E_NOTIMPL;
     }
 
@@ -1688,7 +2171,27 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
             dword_indices[i] = *word_indices++;
     }
 
-    if ((flags & (D3DXMESHOPT_COMPACT | D3DXMESHOPT_IGNOREVERTS | D3DXMESHOPT_ATTRSORT)) == D3DXMESHOPT_COMPACT)
+    if (flags & D3DXMESHOPT_VERTEXCACHE)
+    {
+        /* D3DXMESHOPT_VERTEXCACHE implies D3DXMESHOPT_ATTRSORT, and reordering
+         * the vertices by first use implies D3DXMESHOPT_COMPACT. */
+        hr = iface->lpVtbl->LockAttributeBuffer(iface, 0, &attrib_buffer);
+        if (FAILED(hr)) goto cleanup;
+
+        hr = remap_faces_for_attrsort(This, dword_indices, attrib_buffer, &sorted_attrib_buffer, &face_remap);
+        if (FAILED(hr)) goto cleanup;
+
+        hr = remap_faces_for_vertex_cache(This, dword_indices, sorted_attrib_buffer, face_remap);
+        if (FAILED(hr)) goto cleanup;
+
+        if (!(flags & D3DXMESHOPT_IGNOREVERTS))
+        {
+            new_num_alloc_vertices = This->numvertices;
+            hr = remap_vertices_for_vertex_cache(This, dword_indices, face_remap, &new_num_vertices, &vertex_remap);
+            if (FAILED(hr)) goto cleanup;
+        }
+    }
+    else if ((flags & (D3DXMESHOPT_COMPACT | D3DXMESHOPT_IGNOREVERTS | D3DXMESHOPT_ATTRSORT)) == D3DXMESHOPT_COMPACT)
     {
         new_num_alloc_vertices = This->numvertices;
         hr = compact_mesh(This, dword_indices, &new_num_vertices, &vertex_remap);
@@ -1748,7 +2251,7 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
             *vertex_remap_ptr++ = i;
     }
 
-    if (flags & D3DXMESHOPT_ATTRSORT)
+    if (flags & (D3DXMESHOPT_ATTRSORT | D3DXMESHOPT_VERTEXCACHE))
     {
         D3DXATTRIBUTERANGE *attrib_table;
         DWORD attrib_table_size;
@@ -1798,9 +2301,10 @@ static HRESULT WINAPI d3dx9_mesh_OptimizeInplace(ID3DXMesh *iface, DWORD flags,
             for (i = 0; i < This->numfaces; i++) {
                 DWORD old_pos = i * 3;
                 DWORD new_pos = face_remap[i] * 3;
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
-                adjacency_out[new_pos++] = face_remap[adjacency_in[old_pos++]];
+                DWORD j;
+
+                for (j = 0; j < 3; ++j, ++old_pos)
+                    adjacency_out[new_pos++] = adjacency_in[old_pos] == ~0u ? ~0u : face_remap[adjacency_in[old_pos]];
             }
         } else {
             memcpy(adjacency_out, adjacency_in, This->numfaces * 3 * sizeof(*adjacency_out));
@@ -7096,6 +7600,11 @@ HRESULT WINAPI D3DXWeldVertices(ID3DXMesh *mesh, DWORD flags, const D3DXWELDEPSI
 
     if (flags & D3DXWELDEPSILONS_WELDPARTIALMATCHES)
     {
+        FLOAT component_epsilons[MAX_FVF_DECL_SIZE];
+        DWORD vertex_size = mesh->lpVtbl->GetNumBytesPerVertex(mesh);
+        DWORD num_vertex_components;
+        D3DVERTEXELEMENT9 *decl_ptr;
+
         hr = mesh->lpVtbl->LockVertexBuffer(mesh, 0, (void**)&vertices);
         if (FAILED(hr))
         {
@@ -7109,20 +7618,21 @@ HRESULT WINAPI D3DXWeldVertices(ID3DXMesh *mesh, DWORD flags, const D3DXWELDEPSI
          * belong to the same attribute group. Otherwise the vertex components
          * that are within epsilon are set to the same value.
          */
+        for (decl_ptr = This->cached_declaration, num_vertex_components = 0; decl_ptr->Stream != 0xFF; decl_ptr++, num_vertex_components++)
+            component_epsilons[num_vertex_components] = get_component_epsilon(decl_ptr, epsilons);
+
         for (i = 0; i < 3 * This->numfaces; i++)
         {
-            D3DVERTEXELEMENT9 *decl_ptr;
-            DWORD vertex_size = mesh->lpVtbl->GetNumBytesPerVertex(mesh);
-            DWORD num_vertex_components;
+            DWORD component;
             INT matches = 0;
             BOOL all_match;
             DWORD index = read_ib(indices, indices_are_32bit, i);
 
-            for (decl_ptr = This->cached_declaration, num_vertex_components = 0; decl_ptr->Stream != 0xFF; decl_ptr++, num_vertex_components++)
+            for (decl_ptr = This->cached_declaration, component = 0; decl_ptr->Stream != 0xFF; decl_ptr++, component++)
             {
                 BYTE *to = &vertices[vertex_size*index + decl_ptr->Offset];
                 BYTE *from = &vertices[vertex_size*point_reps[index] + decl_ptr->Offset];
-                FLOAT epsilon = get_component_epsilon(decl_ptr, epsilons);
+                FLOAT epsilon = component_epsilons[component];
 
                 /* Don't weld self */
                 if (index == point_reps[index])
@@ -7186,6 +7696,24 @@ cleanup:
     return hr;
 }
 
+static DWORD *get_dword_indices(const void *indices, UINT num_faces, BOOL indices_are_32bit)
+{
+    DWORD *dword_indices;
+    const WORD *word_indices = indices;
+    UINT i;
+
+    if (!(dword_indices = HeapAlloc(GetProcessHeap(), 0, num_faces * 3 * sizeof(*dword_indices))))
+        return NULL;
+
+    if (indices_are_32bit)
+        memcpy(dword_indices, indices, num_faces * 3 * sizeof(*dword_indices));
+    else
+        for (i = 0; i < num_faces * 3; ++i)
+            dword_indices[i] = word_indices[i];
+
+    return dword_indices;
+}
+
 /*************************************************************************
  * D3DXOptimizeFaces    (D3DX9_36.@)
  *
@@ -7202,52 +7730,78 @@ cleanup:
  *   Success: D3D_OK.
  *   Failure: D3DERR_INVALIDCALL.
  *
- * BUGS
- *   The face re-ordering does not use the vertex cache optimally.
- *
  */
 HRESULT WINAPI D3DXOptimizeFaces(const void *indices, UINT num_faces,
         UINT num_vertices, BOOL indices_are_32bit, DWORD *face_remap)
 {
-    UINT i;
-    UINT j = num_faces - 1;
     UINT limit_16_bit = 2 << 15; /* According to MSDN */
-    HRESULT hr = D3D_OK;
+    DWORD *dword_indices;
+    HRESULT hr;
 
-    FIXME("indices %p, num_faces %u, num_vertices %u, indices_are_32bit %#x, face_remap %p semi-stub. "
-            "Face order will not be optimal.\n",
+    TRACE("indices %p, num_faces %u, num_vertices %u, indices_are_32bit %#x, face_remap %p.\n",
             indices, num_faces, num_vertices, indices_are_32bit, face_remap);
 
     if (!indices_are_32bit && num_faces >= limit_16_bit)
     {
         WARN("Number of faces must be less than %d when using 16-bit indices.\n",
              limit_16_bit);
-        hr = D3DERR_INVALIDCALL;
-        goto error;
+        return D3DERR_INVALIDCALL;
     }
 
     if (!face_remap)
     {
         WARN("Face remap pointer is NULL.\n");
-        hr = D3DERR_INVALIDCALL;
-        goto error;
+        return D3DERR_INVALIDCALL;
     }
 
-    /* The faces are drawn in reverse order for simple meshes. This ordering
-     * is not optimal for complicated meshes, but will not break anything
-     * either. The ordering should be changed to take advantage of the vertex
-     * cache on the graphics card.
-     *
-     * TODO Re-order to take advantage of vertex cache.
-     */
-    for (i = 0; i < num_faces; i++)
+    if (!(dword_indices = get_dword_indices(indices, num_faces, indices_are_32bit)))
+        return E_OUTOFMEMORY;
+
+    hr = optimize_faces(dword_indices, num_faces, num_vertices, face_remap);
+
+    HeapFree(GetProcessHeap(), 0, dword_indices);
+    return hr;
+}
+
+/*************************************************************************
+ * D3DXOptimizeVertices    (D3DX9_36.@)
+ *
+ * Re-orders the vertices so that they are fetched in order.
+ *
+ * PARAMS
+ *   indices           [I] Pointer to an index buffer belonging to a mesh.
+ *   num_faces         [I] Number of faces in the mesh.
+ *   num_vertices      [I] Number of vertices in the mesh.
+ *   indices_are_32bit [I] Specifies whether indices are 32- or 16-bit.
+ *   vertex_remap      [I/O] The new order of the vertices.
+ *
+ * RETURNS
+ *   Success: D3D_OK.
+ *   Failure: D3DERR_INVALIDCALL.
+ *
+ */
+HRESULT WINAPI D3DXOptimizeVertices(const void *indices, UINT num_faces,
+        UINT num_vertices, BOOL indices_are_32bit, DWORD *vertex_remap)
+{
+    DWORD *dword_indices;
+    DWORD used_count;
+    HRESULT hr;
+
+    TRACE("indices %p, num_faces %u, num_vertices %u, indices_are_32bit %#x, vertex_remap %p.\n",
+            indices, num_faces, num_vertices, indices_are_32bit, vertex_remap);
+
+    if (!vertex_remap)
     {
-        face_remap[i] = j--;
+        WARN("Vertex remap pointer is NULL.\n");
+        return D3DERR_INVALIDCALL;
     }
 
-    return D3D_OK;
+    if (!(dword_indices = get_dword_indices(indices, num_faces, indices_are_32bit)))
+        return E_OUTOFMEMORY;
 
-error:
+    hr = optimize_vertices(dword_indices, num_faces, num_vertices, vertex_remap, &used_count);
+
+    HeapFree(GetProcessHeap(), 0, dword_indices);
     return hr;
 }
 
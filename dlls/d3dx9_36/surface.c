@@ -1487,6 +1487,157 @@ static void format_from_vec4(const struct pixel_format_desc *format, const struc
     }
 }
 
+/* Converts a single pixel, using the conversion info from
+ * init_argb_conversion_info(). ck_conv_info is only used with a color key. */
+static void convert_argb_pixel(const struct argb_conversion_info *conv_info,
+        const struct argb_conversion_info *ck_conv_info, const BYTE *src_ptr, BYTE *dst_ptr,
+        D3DCOLOR color_key, const PALETTEENTRY *palette)
+{
+    const struct pixel_format_desc *src_format = conv_info->srcformat;
+    const struct pixel_format_desc *dst_format = conv_info->destformat;
+    DWORD channels[4] = {0};
+
+    if (!src_format->to_rgba && !dst_format->from_rgba
+            && src_format->type == dst_format->type
+            && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
+    {
+        DWORD val;
+
+        get_relevant_argb_components(conv_info, src_ptr, channels);
+        val = make_argb_color(conv_info, channels);
+
+        if (color_key)
+        {
+            DWORD ck_pixel;
+
+            get_relevant_argb_components(ck_conv_info, src_ptr, channels);
+            ck_pixel = make_argb_color(ck_conv_info, channels);
+            if (ck_pixel == color_key)
+                val &= ~conv_info->destmask[0];
+        }
+        memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
+    }
+    else
+    {
+        struct vec4 color, tmp;
+
+        format_to_vec4(src_format, src_ptr, &color);
+        if (src_format->to_rgba)
+            src_format->to_rgba(&color, &tmp, palette);
+        else
+            tmp = color;
+
+        if (color_key)
+        {
+            DWORD ck_pixel;
+
+            format_from_vec4(ck_conv_info->destformat, &tmp, (BYTE *)&ck_pixel);
+            if (ck_pixel == color_key)
+                tmp.w = 0.0f;
+        }
+
+        if (dst_format->from_rgba)
+            dst_format->from_rgba(&tmp, &color);
+        else
+            color = tmp;
+
+        format_from_vec4(dst_format, &color, dst_ptr);
+    }
+}
+
+/* Fast paths for the most common formats. The pixels of a row are expanded
+ * to D3DFMT_A8R8G8B8 and converted back, which gives the same results as
+ * get_relevant_argb_components() and make_argb_color(). */
+static BOOL is_fast_argb_format(const struct pixel_format_desc *format)
+{
+    return format->format == D3DFMT_A8R8G8B8
+            || format->format == D3DFMT_X8R8G8B8
+            || format->format == D3DFMT_R5G6B5;
+}
+
+/* Reads width pixels into row. If src_x is not NULL, it holds the index of
+ * the source pixel for each pixel of the row. */
+static void read_argb_row(const struct pixel_format_desc *format, const BYTE *src, const UINT *src_x,
+        DWORD *row, UINT width)
+{
+    const DWORD *src32 = (const DWORD *)src;
+    const WORD *src16 = (const WORD *)src;
+    UINT x;
+
+    switch (format->format)
+    {
+        case D3DFMT_A8R8G8B8:
+            if (src_x)
+                for (x = 0; x < width; ++x)
+                    row[x] = src32[src_x[x]];
+            else
+                memcpy(row, src, width * sizeof(*row));
+            break;
+
+        case D3DFMT_X8R8G8B8:
+            if (src_x)
+                for (x = 0; x < width; ++x)
+                    row[x] = src32[src_x[x]] | 0xff000000;
+            else
+                for (x = 0; x < width; ++x)
+                    row[x] = src32[x] | 0xff000000;
+            break;
+
+        case D3DFMT_R5G6B5:
+            for (x = 0; x < width; ++x)
+            {
+                DWORD p = src16[src_x ? src_x[x] : x];
+                DWORD r = (p >> 11) & 0x1f, g = (p >> 5) & 0x3f, b = p & 0x1f;
+
+                row[x] = 0xff000000 | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+            }
+            break;
+
+        default:
+            ERR("Unhandled format %#x.\n", format->format);
+            break;
+    }
+}
+
+static void write_argb_row(const struct pixel_format_desc *format, const DWORD *row, BYTE *dst, UINT width)
+{
+    DWORD *dst32 = (DWORD *)dst;
+    WORD *dst16 = (WORD *)dst;
+    UINT x;
+
+    switch (format->format)
+    {
+        case D3DFMT_A8R8G8B8:
+            memcpy(dst, row, width * sizeof(*row));
+            break;
+
+        case D3DFMT_X8R8G8B8:
+            for (x = 0; x < width; ++x)
+                dst32[x] = row[x] & 0x00ffffff;
+            break;
+
+        case D3DFMT_R5G6B5:
+            for (x = 0; x < width; ++x)
+                dst16[x] = ((row[x] >> 8) & 0xf800) | ((row[x] >> 5) & 0x07e0) | ((row[x] >> 3) & 0x001f);
+            break;
+
+        default:
+            ERR("Unhandled format %#x.\n", format->format);
+            break;
+    }
+}
+
+static void color_key_argb_row(DWORD *row, UINT width, D3DCOLOR color_key)
+{
+    UINT x;
+
+    for (x = 0; x < width; ++x)
+    {
+        if (row[x] == color_key)
+            row[x] &= 0x00ffffff;
+    }
+}
+
 /************************************************************
  * copy_pixels
  *
@@ -1531,12 +1682,10 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
         const PALETTEENTRY *palette)
 {
     struct argb_conversion_info conv_info, ck_conv_info;
-    const struct pixel_format_desc *ck_format = NULL;
-    DWORD channels[4];
+    DWORD *row = NULL;
     UINT min_width, min_height, min_depth;
     UINT x, y, z;
 
-    ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
 
     min_width = min(src_size->width, dst_size->width);
@@ -1546,10 +1695,12 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
     if (color_key)
     {
         /* Color keys are always represented in D3DFMT_A8R8G8B8 format. */
-        ck_format = get_format_info(D3DFMT_A8R8G8B8);
-        init_argb_conversion_info(src_format, ck_format, &ck_conv_info);
+        init_argb_conversion_info(src_format, get_format_info(D3DFMT_A8R8G8B8), &ck_conv_info);
     }
 
+    if (is_fast_argb_format(src_format) && is_fast_argb_format(dst_format))
+        row = HeapAlloc(GetProcessHeap(), 0, min_width * sizeof(*row));
+
     for (z = 0; z < min_depth; z++) {
         const BYTE *src_slice_ptr = src + z * src_slice_pitch;
         BYTE *dst_slice_ptr = dst + z * dst_slice_pitch;
@@ -1558,56 +1709,21 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
             const BYTE *src_ptr = src_slice_ptr + y * src_row_pitch;
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
 
-            for (x = 0; x < min_width; x++) {
-                if (!src_format->to_rgba && !dst_format->from_rgba
-                        && src_format->type == dst_format->type
-                        && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
-                {
-                    DWORD val;
-
-                    get_relevant_argb_components(&conv_info, src_ptr, channels);
-                    val = make_argb_color(&conv_info, channels);
-
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
-
-                        get_relevant_argb_components(&ck_conv_info, src_ptr, channels);
-                        ck_pixel = make_argb_color(&ck_conv_info, channels);
-                        if (ck_pixel == color_key)
-                            val &= ~conv_info.destmask[0];
-                    }
-                    memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
-                }
-                else
-                {
-                    struct vec4 color, tmp;
-
-                    format_to_vec4(src_format, src_ptr, &color);
-                    if (src_format->to_rgba)
-                        src_format->to_rgba(&color, &tmp, palette);
-                    else
-                        tmp = color;
-
-                    if (ck_format)
-                    {
-                        DWORD ck_pixel;
-
-                        format_from_vec4(ck_format, &tmp, (BYTE *)&ck_pixel);
-                        if (ck_pixel == color_key)
-                            tmp.w = 0.0f;
-                    }
-
-                    if (dst_format->from_rgba)
-                        dst_format->from_rgba(&tmp, &color);
-                    else
-                        color = tmp;
-
-                    format_from_vec4(dst_format, &color, dst_ptr);
+            if (row)
+            {
+                read_argb_row(src_format, src_ptr, NULL, row, min_width);
+                if (color_key)
+                    color_key_argb_row(row, min_width, color_key);
+                write_argb_row(dst_format, row, dst_ptr, min_width);
+                dst_ptr += min_width * dst_format->bytes_per_pixel;
+            }
+            else
+            {
+                for (x = 0; x < min_width; x++) {
+                    convert_argb_pixel(&conv_info, &ck_conv_info, src_ptr, dst_ptr, color_key, palette);
+                    src_ptr += src_format->bytes_per_pixel;
+                    dst_ptr += dst_format->bytes_per_pixel;
                 }
-
-                src_ptr += src_format->bytes_per_pixel;
-                dst_ptr += dst_format->bytes_per_pixel;
             }
 
             if (src_size->width < dst_size->width) /* black out remaining pixels */
@@ -1619,6 +1735,8 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
     }
     if (src_size->depth < dst_size->depth) /* black out remaining pixels */
         memset(dst + src_size->depth * dst_slice_pitch, 0, dst_slice_pitch * (dst_size->depth - src_size->depth));
+
+    HeapFree(GetProcessHeap(), 0, row);
 }
 
 /************************************************************
@@ -1634,18 +1752,32 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
         const PALETTEENTRY *palette)
 {
     struct argb_conversion_info conv_info, ck_conv_info;
-    const struct pixel_format_desc *ck_format = NULL;
-    DWORD channels[4];
+    DWORD *row = NULL;
+    UINT *src_x = NULL;
     UINT x, y, z;
 
-    ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
 
     if (color_key)
     {
         /* Color keys are always represented in D3DFMT_A8R8G8B8 format. */
-        ck_format = get_format_info(D3DFMT_A8R8G8B8);
-        init_argb_conversion_info(src_format, ck_format, &ck_conv_info);
+        init_argb_conversion_info(src_format, get_format_info(D3DFMT_A8R8G8B8), &ck_conv_info);
+    }
+
+    if (is_fast_argb_format(src_format) && is_fast_argb_format(dst_format))
+    {
+        row = HeapAlloc(GetProcessHeap(), 0, dst_size->width * sizeof(*row));
+        src_x = HeapAlloc(GetProcessHeap(), 0, dst_size->width * sizeof(*src_x));
+        if (row && src_x)
+        {
+            for (x = 0; x < dst_size->width; x++)
+                src_x[x] = x * src_size->width / dst_size->width;
+        }
+        else
+        {
+            HeapFree(GetProcessHeap(), 0, row);
+            row = NULL;
+        }
     }
 
     for (z = 0; z < dst_size->depth; z++)
@@ -1658,61 +1790,173 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
             const BYTE *src_row_ptr = src_slice_ptr + src_row_pitch * (y * src_size->height / dst_size->height);
 
+            if (row)
+            {
+                read_argb_row(src_format, src_row_ptr, src_x, row, dst_size->width);
+                if (color_key)
+                    color_key_argb_row(row, dst_size->width, color_key);
+                write_argb_row(dst_format, row, dst_ptr, dst_size->width);
+                continue;
+            }
+
             for (x = 0; x < dst_size->width; x++)
             {
                 const BYTE *src_ptr = src_row_ptr + (x * src_size->width / dst_size->width) * src_format->bytes_per_pixel;
 
-                if (!src_format->to_rgba && !dst_format->from_rgba
-                        && src_format->type == dst_format->type
-                        && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
-                {
-                    DWORD val;
+                convert_argb_pixel(&conv_info, &ck_conv_info, src_ptr, dst_ptr, color_key, palette);
+                dst_ptr += dst_format->bytes_per_pixel;
+            }
+        }
+    }
 
-                    get_relevant_argb_components(&conv_info, src_ptr, channels);
-                    val = make_argb_color(&conv_info, channels);
+    HeapFree(GetProcessHeap(), 0, row);
+    HeapFree(GetProcessHeap(), 0, src_x);
+}
 
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
+/************************************************************
+ * is_box_filter_supported
+ *
+ * The box filter only handles halving the size, like when
+ * generating mipmaps. A dimension of 1 is left unchanged.
+ */
+BOOL is_box_filter_supported(const struct volume *src_size, const struct volume *dst_size)
+{
+    return (src_size->width == dst_size->width * 2 || (src_size->width == 1 && dst_size->width == 1))
+            && (src_size->height == dst_size->height * 2 || (src_size->height == 1 && dst_size->height == 1))
+            && (src_size->depth == dst_size->depth * 2 || (src_size->depth == 1 && dst_size->depth == 1));
+}
 
-                        get_relevant_argb_components(&ck_conv_info, src_ptr, channels);
-                        ck_pixel = make_argb_color(&ck_conv_info, channels);
-                        if (ck_pixel == color_key)
-                            val &= ~conv_info.destmask[0];
-                    }
-                    memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
-                }
+static void box_filter_argb_pixel(const struct pixel_format_desc *src_format, const BYTE *src,
+        UINT src_row_pitch, UINT src_slice_pitch, UINT x_step, UINT y_step, UINT z_step,
+        const struct pixel_format_desc *dst_format, BYTE *dst, D3DCOLOR color_key, const PALETTEENTRY *palette)
+{
+    const struct pixel_format_desc *ck_format = get_format_info(D3DFMT_A8R8G8B8);
+    struct vec4 sum = {0.0f, 0.0f, 0.0f, 0.0f}, color, tmp;
+    float scale = 1.0f / (x_step * y_step * z_step);
+    UINT x, y, z;
+
+    for (z = 0; z < z_step; z++)
+    {
+        for (y = 0; y < y_step; y++)
+        {
+            for (x = 0; x < x_step; x++)
+            {
+                format_to_vec4(src_format, src + z * src_slice_pitch + y * src_row_pitch
+                        + x * src_format->bytes_per_pixel, &color);
+                if (src_format->to_rgba)
+                    src_format->to_rgba(&color, &tmp, palette);
                 else
+                    tmp = color;
+
+                if (color_key)
                 {
-                    struct vec4 color, tmp;
+                    DWORD ck_pixel;
 
-                    format_to_vec4(src_format, src_ptr, &color);
-                    if (src_format->to_rgba)
-                        src_format->to_rgba(&color, &tmp, palette);
-                    else
-                        tmp = color;
+                    format_from_vec4(ck_format, &tmp, (BYTE *)&ck_pixel);
+                    if (ck_pixel == color_key)
+                        tmp.w = 0.0f;
+                }
 
-                    if (ck_format)
-                    {
-                        DWORD ck_pixel;
+                sum.x += tmp.x;
+                sum.y += tmp.y;
+                sum.z += tmp.z;
+                sum.w += tmp.w;
+            }
+        }
+    }
 
-                        format_from_vec4(ck_format, &tmp, (BYTE *)&ck_pixel);
-                        if (ck_pixel == color_key)
-                            tmp.w = 0.0f;
-                    }
+    tmp.x = sum.x * scale;
+    tmp.y = sum.y * scale;
+    tmp.z = sum.z * scale;
+    tmp.w = sum.w * scale;
+
+    if (dst_format->from_rgba)
+        dst_format->from_rgba(&tmp, &color);
+    else
+        color = tmp;
+
+    format_from_vec4(dst_format, &color, dst);
+}
+
+/************************************************************
+ * box_filter_argb_pixels
+ *
+ * Copies the source buffer to the destination buffer, performing
+ * any necessary format conversion and color keying, and halving
+ * the size using a box filter. The sizes must be supported
+ * according to is_box_filter_supported().
+ */
+void box_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch, const struct volume *src_size,
+        const struct pixel_format_desc *src_format, BYTE *dst, UINT dst_row_pitch, UINT dst_slice_pitch,
+        const struct volume *dst_size, const struct pixel_format_desc *dst_format, D3DCOLOR color_key,
+        const PALETTEENTRY *palette)
+{
+    UINT x_step = src_size->width / dst_size->width;
+    UINT y_step = src_size->height / dst_size->height;
+    UINT z_step = src_size->depth / dst_size->depth;
+    UINT shift = (x_step >> 1) + (y_step >> 1) + (z_step >> 1);
+    DWORD *row = NULL, *sum_rb, *sum_ag;
+    UINT x, y, z, i, j;
+
+    if (is_fast_argb_format(src_format) && is_fast_argb_format(dst_format))
+        row = HeapAlloc(GetProcessHeap(), 0, (src_size->width + 2 * dst_size->width) * sizeof(*row));
+
+    for (z = 0; z < dst_size->depth; z++)
+    {
+        BYTE *dst_slice_ptr = dst + z * dst_slice_pitch;
+        const BYTE *src_slice_ptr = src + z * z_step * src_slice_pitch;
+
+        for (y = 0; y < dst_size->height; y++)
+        {
+            BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
+            const BYTE *src_row_ptr = src_slice_ptr + y * y_step * src_row_pitch;
 
-                    if (dst_format->from_rgba)
-                        dst_format->from_rgba(&tmp, &color);
-                    else
-                        color = tmp;
+            if (!row)
+            {
+                for (x = 0; x < dst_size->width; x++)
+                {
+                    box_filter_argb_pixel(src_format, src_row_ptr + x * x_step * src_format->bytes_per_pixel,
+                            src_row_pitch, src_slice_pitch, x_step, y_step, z_step,
+                            dst_format, dst_ptr, color_key, palette);
+                    dst_ptr += dst_format->bytes_per_pixel;
+                }
+                continue;
+            }
 
-                    format_from_vec4(dst_format, &color, dst_ptr);
+            /* Sum the red and blue, and the alpha and green channels of up to
+             * 8 pixels in the two 16-bit halves of a DWORD. */
+            sum_rb = row + src_size->width;
+            sum_ag = sum_rb + dst_size->width;
+            memset(sum_rb, 0, 2 * dst_size->width * sizeof(*sum_rb));
+            for (i = 0; i < z_step; i++)
+            {
+                for (j = 0; j < y_step; j++)
+                {
+                    read_argb_row(src_format, src_row_ptr + i * src_slice_pitch + j * src_row_pitch,
+                            NULL, row, src_size->width);
+                    if (color_key)
+                        color_key_argb_row(row, src_size->width, color_key);
+
+                    for (x = 0; x < src_size->width; x++)
+                    {
+                        sum_rb[x / x_step] += row[x] & 0x00ff00ff;
+                        sum_ag[x / x_step] += (row[x] >> 8) & 0x00ff00ff;
+                    }
                 }
+            }
 
-                dst_ptr += dst_format->bytes_per_pixel;
+            for (x = 0; x < dst_size->width; x++)
+            {
+                DWORD rb = sum_rb[x] + ((1u << shift) >> 1) * 0x00010001;
+                DWORD ag = sum_ag[x] + ((1u << shift) >> 1) * 0x00010001;
+
+                row[x] = ((rb >> shift) & 0x00ff00ff) | (((ag >> shift) & 0x00ff00ff) << 8);
             }
+            write_argb_row(dst_format, row, dst_ptr, dst_size->width);
         }
     }
+
+    HeapFree(GetProcessHeap(), 0, row);
 }
 
 /************************************************************
@@ -1852,13 +2096,21 @@ HRESULT WINAPI D3DXLoadSurfaceFromMemory(IDirect3DSurface9 *dst_surface,
             convert_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
                     lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette);
         }
+        else if (((filter & 0xf) == D3DX_FILTER_BOX || (filter & 0xf) == D3DX_FILTER_LINEAR)
+                && is_box_filter_supported(&src_size, &dst_size))
+        {
+            /* When halving the size a linear filter samples exactly between
+             * the source pixels, which is the same as a box filter. */
+            box_filter_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
+                    lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette);
+        }
         else /* if ((filter & 0xf) == D3DX_FILTER_POINT) */
         {
             if ((filter & 0xf) != D3DX_FILTER_POINT)
                 FIXME("Unhandled filter %#x.\n", filter);
 
-            /* Always apply a point filter until D3DX_FILTER_LINEAR,
-             * D3DX_FILTER_TRIANGLE and D3DX_FILTER_BOX are implemented. */
+            /* Apply a point filter until D3DX_FILTER_LINEAR, D3DX_FILTER_TRIANGLE
+             * and D3DX_FILTER_BOX are implemented for arbitrary sizes. */
             point_filter_argb_pixels(src_memory, src_pitch, 0, &src_size, srcformatdesc,
                     lockrect.pBits, lockrect.Pitch, 0, &dst_size, destformatdesc, color_key, src_palette);
         }
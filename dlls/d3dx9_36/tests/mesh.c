@@ -4574,6 +4574,12 @@ static void D3DXGenerateAdjacencyTest(void)
             0.354, /* > sqrt(0.25*0.25 + 0.25*0.25) */
             {-1, -1, 1,  0, -1, -1},
         },
+        {
+            6, {{0.49, 0.0, 0.0}, {1.0, 0.0, 0.0}, {1.0, 1.0, 0.0}, {0.51, 0.0, 0.0}, {1.0, 1.0, 0.0}, {0.0, 1.0, 0.0}},
+            2, {0, 1, 2,  3, 4, 5},
+            0.25,
+            {-1, -1, 1,  0, -1, -1},
+        },
         { /* adjacent faces must have opposite winding orders at the shared edge */
             4, {{0.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {1.0, 1.0, 0.0}, {0.0, 1.0, 0.0}},
             2, {0, 1, 2,  0, 3, 2},
@@ -10623,6 +10629,38 @@ static HRESULT compute_normals_D3DXComputeTangentFrameEx(ID3DXMesh *mesh, const
             adjacency, -1.01f, -0.01f, -1.01f, NULL, NULL);
 }
 
+static void test_optimize_vertices(void)
+{
+    /* 3--2
+     * |\ |\
+     * | \| \
+     * 0--1--4
+     */
+    const DWORD indices32[] = {2, 1, 3, 1, 0, 3, 4, 1, 2};
+    const WORD indices16[] = {2, 1, 3, 1, 0, 3, 4, 1, 2};
+    const DWORD exp_vertex_remap[] = {2, 1, 3, 0, 4};
+    DWORD vertex_remap[ARRAY_SIZE(exp_vertex_remap)];
+    HRESULT hr;
+    UINT i;
+
+    hr = D3DXOptimizeVertices(indices32, 3, 5, TRUE, NULL);
+    ok(hr == D3DERR_INVALIDCALL, "Got unexpected hr %#x.\n", hr);
+
+    memset(vertex_remap, 0xcc, sizeof(vertex_remap));
+    hr = D3DXOptimizeVertices(indices32, 3, 5, TRUE, vertex_remap);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(exp_vertex_remap); ++i)
+        ok(vertex_remap[i] == exp_vertex_remap[i], "Got vertex %u at %u, expected %u.\n",
+                vertex_remap[i], i, exp_vertex_remap[i]);
+
+    memset(vertex_remap, 0xcc, sizeof(vertex_remap));
+    hr = D3DXOptimizeVertices(indices16, 3, 5, FALSE, vertex_remap);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(exp_vertex_remap); ++i)
+        ok(vertex_remap[i] == exp_vertex_remap[i], "Got vertex %u at %u, expected %u.\n",
+                vertex_remap[i], i, exp_vertex_remap[i]);
+}
+
 static void test_compute_normals(void)
 {
     HRESULT hr;
@@ -11220,6 +11258,7 @@ START_TEST(mesh)
     test_clone_mesh();
     test_valid_mesh();
     test_optimize_faces();
+    test_optimize_vertices();
     test_compute_normals();
     test_D3DXFrameFind();
 }
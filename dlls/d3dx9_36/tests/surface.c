@@ -695,6 +695,13 @@ static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
     const DWORD pixdata_g16r16[] = { 0x07d23fbe, 0xdc7f44a4, 0xe4d8976b, 0x9a84fe89 };
     const DWORD pixdata_a8b8g8r8[] = { 0xc3394cf0, 0x235ae892, 0x09b197fd, 0x8dc32bf6 };
     const DWORD pixdata_a2r10g10b10[] = { 0x57395aff, 0x5b7668fd, 0xb0d856b5, 0xff2c61d6 };
+    const DWORD pixdata_box[] =
+    {
+        0x00000000, 0x40404040, 0xff000000, 0xff0000ff,
+        0x80808080, 0xc0c0c0c0, 0xff00ff00, 0xffff0000,
+        0x10203040, 0x10203040, 0x00000000, 0x00000000,
+        0x30405060, 0x30405060, 0xfcfcfcfc, 0x00000000,
+    };
 
     hr = create_file("testdummy.bmp", noimage, sizeof(noimage));  /* invalid image */
     testdummy_ok = SUCCEEDED(hr);
@@ -943,6 +950,20 @@ static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
         hr = IDirect3DSurface9_UnlockRect(surf);
         ok(SUCCEEDED(hr), "Failed to unlock surface, hr %#x.\n", hr);
 
+        SetRect(&rect, 0, 0, 4, 4);
+        hr = D3DXLoadSurfaceFromMemory(surf, NULL, NULL, pixdata_box,
+                D3DFMT_A8R8G8B8, 16, NULL, &rect, D3DX_FILTER_BOX, 0);
+        ok(SUCCEEDED(hr), "Failed to load surface, hr %#x.\n", hr);
+        hr = IDirect3DSurface9_LockRect(surf, &lockrect, NULL, D3DLOCK_READONLY);
+        ok(SUCCEEDED(hr), "Failed to lock surface, hr %#x.\n", hr);
+        check_pixel_4bpp(&lockrect, 0, 0, 0x60606060);
+        check_pixel_4bpp(&lockrect, 1, 0, 0xff404040);
+        check_pixel_4bpp(&lockrect, 0, 1, 0x20304050);
+        check_pixel_4bpp(&lockrect, 1, 1, 0x3f3f3f3f);
+        hr = IDirect3DSurface9_UnlockRect(surf);
+        ok(SUCCEEDED(hr), "Failed to unlock surface, hr %#x.\n", hr);
+        SetRect(&rect, 0, 0, 2, 2);
+
         /* Test D3DXLoadSurfaceFromMemory with indexed color image */
         if (0)
         {
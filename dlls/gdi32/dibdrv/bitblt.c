@@ -1195,6 +1195,207 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
+/* fixed point precision of the halftone filter weights */
+#define HALFTONE_SHIFT 12
+
+struct halftone_axis
+{
+    int  start;   /* first destination pixel */
+    int  inc;     /* destination direction */
+    int  count;   /* number of visible destination pixels */
+    int  taps;    /* maximum number of source pixels per destination pixel */
+    int *num;     /* number of source pixels for each destination pixel */
+    int *pos;     /* coordinate of each source pixel */
+    int *weight;  /* weight of each source pixel, they add up to 1 << HALFTONE_SHIFT */
+};
+
+/* return the range of indices along a possibly mirrored axis that fall inside the visible area */
+static void get_visible_indices( int start, int length, int vis_start, int vis_end, int *first, int *end )
+{
+    if (length > 0)
+    {
+        *first = max( vis_start - start, 0 );
+        *end = min( vis_end - start, length );
+    }
+    else
+    {
+        *first = max( start - vis_end + 1, 0 );
+        *end = min( start - vis_start + 1, -length );
+    }
+}
+
+static void add_halftone_tap( struct halftone_axis *axis, int index, int pos, int weight )
+{
+    int *num = &axis->num[index], *p = axis->pos + index * axis->taps, *w = axis->weight + index * axis->taps;
+
+    if (!weight) return;
+    if (*num && p[*num - 1] == pos) w[*num - 1] += weight;
+    else
+    {
+        p[*num] = pos;
+        w[*num] = weight;
+        (*num)++;
+    }
+}
+
+/***********************************************************************
+ *           init_halftone_axis
+ *
+ * Compute the filter taps along one axis: a box filter when shrinking,
+ * a linear interpolation when stretching. Source pixels outside of the
+ * visible source area are replaced by the nearest visible one.
+ */
+static BOOL init_halftone_axis( struct halftone_axis *axis, int dst_start, int dst_len, int dst_vis_start,
+                                int dst_vis_end, int src_start, int src_len, int src_vis_start, int src_vis_end )
+{
+    LONGLONG d = abs( dst_len ), s = abs( src_len ), a, b, num;
+    int i, j, first, end, src_first, src_end, src_inc = src_len > 0 ? 1 : -1, weight, prev;
+
+    get_visible_indices( dst_start, dst_len, dst_vis_start, dst_vis_end, &first, &end );
+    get_visible_indices( src_start, src_len, src_vis_start, src_vis_end, &src_first, &src_end );
+
+    axis->inc = dst_len > 0 ? 1 : -1;
+    axis->start = dst_start + axis->inc * first;
+    axis->count = max( end - first, 0 );
+    axis->taps = s > d ? s / d + 2 : 2;
+    if (!axis->count || src_first >= src_end) return TRUE;
+
+    axis->num = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, axis->count * sizeof(int) );
+    axis->pos = HeapAlloc( GetProcessHeap(), 0, axis->count * axis->taps * sizeof(int) );
+    axis->weight = HeapAlloc( GetProcessHeap(), 0, axis->count * axis->taps * sizeof(int) );
+    if (!axis->num || !axis->pos || !axis->weight) return FALSE;
+
+    for (i = 0; i < axis->count; i++)
+    {
+        if (s > d)
+        {
+            /* destination pixel covers [a, b) in units of 1/d source pixels */
+            a = (first + i) * s;
+            b = a + s;
+            for (j = a / d, prev = 0; j * d < b; j++)
+            {
+                weight = (min( (j + 1) * d, b ) - a) * (1 << HALFTONE_SHIFT) / s;
+                add_halftone_tap( axis, i, src_start + src_inc * min( max( j, src_first ), src_end - 1 ),
+                                  weight - prev );
+                prev = weight;
+            }
+        }
+        else
+        {
+            /* center of the destination pixel in units of 1/2d source pixels */
+            num = (2 * (first + i) + 1) * s - d;
+            j = num >= 0 ? num / (2 * d) : -((2 * d - 1 - num) / (2 * d));
+            weight = (num - j * 2 * d) * (1 << HALFTONE_SHIFT) / (2 * d);
+            add_halftone_tap( axis, i, src_start + src_inc * min( max( j, src_first ), src_end - 1 ),
+                              (1 << HALFTONE_SHIFT) - weight );
+            add_halftone_tap( axis, i, src_start + src_inc * min( max( j + 1, src_first ), src_end - 1 ),
+                              weight );
+        }
+    }
+    return TRUE;
+}
+
+static void free_halftone_axis( struct halftone_axis *axis )
+{
+    HeapFree( GetProcessHeap(), 0, axis->num );
+    HeapFree( GetProcessHeap(), 0, axis->pos );
+    HeapFree( GetProcessHeap(), 0, axis->weight );
+}
+
+/* filter a source row horizontally, the result is stored with 6 bits of extra precision */
+static void halftone_row( const struct halftone_axis *axis, const BYTE *src, int bpp, unsigned int *dst )
+{
+    const int *pos = axis->pos, *weight = axis->weight;
+    unsigned int sum[4];
+    int i, j, c;
+
+    for (i = 0; i < axis->count; i++, pos += axis->taps, weight += axis->taps)
+    {
+        const BYTE *ptr;
+
+        sum[0] = sum[1] = sum[2] = sum[3] = 0;
+        for (j = 0; j < axis->num[i]; j++)
+        {
+            ptr = src + pos[j] * bpp;
+            for (c = 0; c < bpp; c++) sum[c] += ptr[c] * weight[j];
+        }
+        for (c = 0; c < bpp; c++) *dst++ = (sum[c] + (1 << (HALFTONE_SHIFT - 7))) >> (HALFTONE_SHIFT - 6);
+    }
+}
+
+/***********************************************************************
+ *           halftone_bitmapinfo
+ *
+ * Separable filtering implementation of STRETCH_HALFTONE for 24 and 32 bpp.
+ * Horizontally filtered source rows are kept in a small cache since
+ * consecutive destination rows share most of their source rows.
+ */
+static DWORD halftone_bitmapinfo( const dib_info *src_dib, const struct bitblt_coords *src,
+                                  const dib_info *dst_dib, const struct bitblt_coords *dst )
+{
+    struct halftone_axis h, v;
+    int bpp = dst_dib->bit_count / 8, len, x, y, i, j, slot, *cache_row = NULL;
+    unsigned int *cache = NULL, *acc = NULL, *line;
+    const int *pos, *weight;
+    BYTE *dst_ptr;
+    DWORD ret = ERROR_OUTOFMEMORY;
+
+    memset( &h, 0, sizeof(h) );
+    memset( &v, 0, sizeof(v) );
+    if (!init_halftone_axis( &h, dst->x, dst->width, dst->visrect.left, dst->visrect.right,
+                             src->x, src->width, src->visrect.left, src->visrect.right ))
+        goto done;
+    if (!init_halftone_axis( &v, dst->y, dst->height, dst->visrect.top, dst->visrect.bottom,
+                             src->y, src->height, src->visrect.top, src->visrect.bottom ))
+        goto done;
+
+    ret = ERROR_NO_DATA;
+    if (!h.num || !v.num) goto done;
+
+    ret = ERROR_OUTOFMEMORY;
+    len = h.count * bpp;
+    if (!(acc = HeapAlloc( GetProcessHeap(), 0, len * sizeof(*acc) ))) goto done;
+    if (!(cache = HeapAlloc( GetProcessHeap(), 0, v.taps * len * sizeof(*cache) ))) goto done;
+    if (!(cache_row = HeapAlloc( GetProcessHeap(), 0, v.taps * sizeof(*cache_row) ))) goto done;
+    for (slot = 0; slot < v.taps; slot++) cache_row[slot] = -1;
+
+    for (i = 0, pos = v.pos, weight = v.weight; i < v.count; i++, pos += v.taps, weight += v.taps)
+    {
+        memset( acc, 0, len * sizeof(*acc) );
+        for (j = 0; j < v.num[i]; j++)
+        {
+            slot = pos[j] % v.taps;
+            line = cache + slot * len;
+            if (cache_row[slot] != pos[j])
+            {
+                halftone_row( &h, (const BYTE *)src_dib->bits.ptr + (src_dib->rect.top + pos[j]) * src_dib->stride +
+                              src_dib->rect.left * bpp, bpp, line );
+                cache_row[slot] = pos[j];
+            }
+            for (x = 0; x < len; x++) acc[x] += line[x] * weight[j];
+        }
+
+        y = v.start + v.inc * i - dst->visrect.top;
+        dst_ptr = (BYTE *)dst_dib->bits.ptr + (dst_dib->rect.top + y) * dst_dib->stride;
+        for (x = 0; x < h.count; x++)
+        {
+            BYTE *ptr = dst_ptr + (dst_dib->rect.left + h.start + h.inc * x - dst->visrect.left) * bpp;
+
+            for (j = 0; j < bpp; j++)
+                ptr[j] = min( (acc[x * bpp + j] + (1 << (HALFTONE_SHIFT + 5))) >> (HALFTONE_SHIFT + 6), 255 );
+        }
+    }
+    ret = ERROR_SUCCESS;
+
+done:
+    HeapFree( GetProcessHeap(), 0, cache_row );
+    HeapFree( GetProcessHeap(), 0, cache );
+    HeapFree( GetProcessHeap(), 0, acc );
+    free_halftone_axis( &v );
+    free_halftone_axis( &h );
+    return ret;
+}
+
 DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                           const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                           INT mode )
@@ -1217,6 +1418,13 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     init_dib_info_from_bitmapinfo( &src_dib, src_info, src_bits );
     init_dib_info_from_bitmapinfo( &dst_dib, dst_info, dst_bits );
 
+    if (mode == STRETCH_HALFTONE && src_dib.funcs == dst_dib.funcs &&
+        (dst_dib.funcs == &funcs_8888 || dst_dib.funcs == &funcs_24))
+    {
+        if ((ret = halftone_bitmapinfo( &src_dib, src, &dst_dib, dst ))) return ret;
+        goto done;
+    }
+
     /* v */
     ret = calc_1d_stretch_params( dst->y, dst->height, dst->visrect.top, dst->visrect.bottom,
                                   src->y, src->height, src->visrect.top, src->visrect.bottom,
@@ -1301,6 +1509,7 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
         }
     }
 
+done:
     /* update coordinates, the destination rectangle is always stored at 0,0 */
     *src = *dst;
     src->x -= src->visrect.left;
@@ -47,6 +47,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(enhmetafile);
+WINE_DECLARE_DEBUG_CHANNEL(emf_perf);
 
 typedef struct
 {
@@ -543,7 +544,7 @@ typedef struct enum_emh_data
 
 static void EMF_Update_MF_Xform(HDC hdc, const enum_emh_data *info)
 {
-    XFORM mapping_mode_trans, final_trans;
+    XFORM mapping_mode_trans, final_trans, cur_trans;
     double scaleX, scaleY;
 
     scaleX = (double)info->state.vportExtX / (double)info->state.wndExtX;
@@ -557,7 +558,12 @@ static void EMF_Update_MF_Xform(HDC hdc, const enum_emh_data *info)
 
     CombineTransform(&final_trans, &info->state.world_transform, &mapping_mode_trans);
     CombineTransform(&final_trans, &final_trans, &info->init_transform);
- 
+
+    /* metafiles often set the same extents and origins over and over, setting
+     * the transform is a lot more expensive than checking whether it changed */
+    if (GetWorldTransform(hdc, &cur_trans) && !memcmp(&cur_trans, &final_trans, sizeof(final_trans)))
+        return;
+
     if (!SetWorldTransform(hdc, &final_trans))
     {
         ERR("World transform failed!\n");
@@ -2270,6 +2276,33 @@ BOOL WINAPI PlayEnhMetaFileRecord(
 }
 
 
+/* per record type playback statistics, collected when the emf_perf channel is on */
+struct emr_stats
+{
+    DWORD    count;
+    LONGLONG ticks;
+};
+
+static void EMF_DumpStats( HENHMETAFILE hmf, const struct emr_stats *stats )
+{
+    LARGE_INTEGER freq;
+    LONGLONG total = 0;
+    DWORD count = 0;
+    int i;
+
+    QueryPerformanceFrequency( &freq );
+    for (i = EMR_MIN; i <= EMR_MAX; i++)
+    {
+        if (!stats[i].count) continue;
+        TRACE_(emf_perf)( "%p: %s %u records, %s us\n", hmf, get_emr_name( i ), stats[i].count,
+                          wine_dbgstr_longlong( stats[i].ticks * 1000000 / freq.QuadPart ) );
+        count += stats[i].count;
+        total += stats[i].ticks;
+    }
+    TRACE_(emf_perf)( "%p: %u records played in %s us\n", hmf, count,
+                      wine_dbgstr_longlong( total * 1000000 / freq.QuadPart ) );
+}
+
 /*****************************************************************************
  *
  *        EnumEnhMetaFile  (GDI32.@)
@@ -2329,6 +2362,8 @@ BOOL WINAPI EnumEnhMetaFile(
     POINT vp_org, win_org;
     INT mapMode = MM_TEXT, old_align = 0, old_rop2 = 0, old_arcdir = 0, old_polyfill = 0, old_stretchblt = 0;
     COLORREF old_text_color = 0, old_bk_color = 0;
+    struct emr_stats *stats = NULL;
+    LARGE_INTEGER start, end;
 
     if(!lpRect && hdc)
     {
@@ -2464,6 +2499,9 @@ BOOL WINAPI EnumEnhMetaFile(
         }
     }
 
+    if (TRACE_ON(emf_perf))
+        stats = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, (EMR_MAX + 1) * sizeof(*stats) );
+
     ret = TRUE;
     offset = 0;
     while(ret && offset < emh->nBytes)
@@ -2483,10 +2521,23 @@ BOOL WINAPI EnumEnhMetaFile(
             EMF_Update_MF_Xform(hdc, info);
 
 	TRACE("Calling EnumFunc with record %s, size %d\n", get_emr_name(emr->iType), emr->nSize);
+        if (stats) QueryPerformanceCounter(&start);
 	ret = (*callback)(hdc, ht, emr, emh->nHandles, (LPARAM)data);
+        if (stats && emr->iType <= EMR_MAX)
+        {
+            QueryPerformanceCounter(&end);
+            stats[emr->iType].count++;
+            stats[emr->iType].ticks += end.QuadPart - start.QuadPart;
+        }
 	offset += emr->nSize;
     }
 
+    if (stats)
+    {
+        EMF_DumpStats(hmf, stats);
+        HeapFree( GetProcessHeap(), 0, stats );
+    }
+
     if (hdc)
     {
         SetStretchBltMode(hdc, old_stretchblt);
@@ -309,6 +309,45 @@ typedef struct {
     FLOAT eM21, eM22;
 } FMAT2;
 
+/* rendered glyph bitmaps, shared between all the GdiFonts that use the same face with the same scaling */
+struct glyph_cache_key
+{
+    const void *data;
+    FT_Long     face_index;
+    FT_UShort   x_ppem;
+    FT_UShort   y_ppem;
+    LONG        aveWidth;
+    double      scale_y;
+    FMAT2       matrix;
+    INT         orientation;
+    BOOL        fake_italic;
+    BOOL        fake_bold;
+};
+
+struct glyph_bits
+{
+    struct list  entry;
+    UINT         index;
+    UINT         format;
+    GLYPHMETRICS gm;
+    ABC          abc;
+    DWORD        size;
+    BYTE         bits[1];
+};
+
+#define GLYPH_CACHE_BUCKETS  256
+#define GLYPH_CACHE_MAX_SIZE (1024 * 1024)
+
+struct glyph_cache
+{
+    struct list            entry;
+    unsigned int           refcount;
+    struct glyph_cache_key key;
+    CRITICAL_SECTION       cs;    /* protects the buckets, lookups don't need freetype_cs */
+    DWORD                  size;
+    struct list            buckets[GLYPH_CACHE_BUCKETS];
+};
+
 typedef struct {
     DWORD hash;
     LOGFONTW lf;
@@ -402,6 +441,7 @@ struct tagGdiFont {
     DWORD total_kern_pairs;
     KERNINGPAIR *kern_pairs;
     struct list child_fonts;
+    struct glyph_cache *glyph_cache;
 
     /* the following members can be accessed without locking, they are never modified after creation */
     FT_Face ft_face;
@@ -458,6 +498,7 @@ static struct list unused_gdi_font_list = LIST_INIT(unused_gdi_font_list);
 static unsigned int unused_font_count;
 #define UNUSED_CACHE_SIZE 10
 static struct list system_links = LIST_INIT(system_links);
+static struct list glyph_cache_list = LIST_INIT(glyph_cache_list);
 
 static struct list font_subst_list = LIST_INIT(font_subst_list);
 
@@ -4633,6 +4674,155 @@ static int get_nearest_charset(const WCHAR *family_name, Face *face, int *cp)
     return DEFAULT_CHARSET;
 }
 
+static void flush_glyph_cache( struct glyph_cache *cache )
+{
+    struct glyph_bits *bits, *next;
+    unsigned int i;
+
+    for (i = 0; i < GLYPH_CACHE_BUCKETS; i++)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE( bits, next, &cache->buckets[i], struct glyph_bits, entry )
+        {
+            list_remove( &bits->entry );
+            HeapFree( GetProcessHeap(), 0, bits );
+        }
+    }
+    cache->size = 0;
+}
+
+/* freetype_cs must be held */
+static struct glyph_cache *grab_glyph_cache( GdiFont *font )
+{
+    struct glyph_cache_key key;
+    struct glyph_cache *cache;
+    unsigned int i;
+
+    memset( &key, 0, sizeof(key) );
+    key.data        = font->ft_face->stream->base;
+    key.face_index  = font->ft_face->face_index;
+    key.x_ppem      = font->ft_face->size->metrics.x_ppem;
+    key.y_ppem      = font->ft_face->size->metrics.y_ppem;
+    key.aveWidth    = font->aveWidth;
+    key.scale_y     = font->scale_y;
+    key.matrix      = font->font_desc.matrix;
+    key.orientation = font->orientation;
+    key.fake_italic = font->fake_italic;
+    key.fake_bold   = font->fake_bold;
+
+    LIST_FOR_EACH_ENTRY( cache, &glyph_cache_list, struct glyph_cache, entry )
+    {
+        if (memcmp( &cache->key, &key, sizeof(key) )) continue;
+        TRACE( "font %p sharing glyph cache %p\n", font, cache );
+        cache->refcount++;
+        return cache;
+    }
+
+    if (!(cache = HeapAlloc( GetProcessHeap(), 0, sizeof(*cache) ))) return NULL;
+    cache->refcount = 1;
+    cache->key = key;
+    cache->size = 0;
+    for (i = 0; i < GLYPH_CACHE_BUCKETS; i++) list_init( &cache->buckets[i] );
+    InitializeCriticalSection( &cache->cs );
+    cache->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": glyph_cache.cs");
+    list_add_head( &glyph_cache_list, &cache->entry );
+    TRACE( "font %p created glyph cache %p\n", font, cache );
+    return cache;
+}
+
+/* freetype_cs must be held */
+static void release_glyph_cache( struct glyph_cache *cache )
+{
+    if (--cache->refcount) return;
+
+    list_remove( &cache->entry );
+    flush_glyph_cache( cache );
+    cache->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cache->cs );
+    HeapFree( GetProcessHeap(), 0, cache );
+}
+
+static BOOL is_cacheable_glyph_format( UINT format )
+{
+    switch (format & ~GGO_UNHINTED)
+    {
+    case GGO_BITMAP:
+    case GGO_GRAY2_BITMAP:
+    case GGO_GRAY4_BITMAP:
+    case GGO_GRAY8_BITMAP:
+    case WINE_GGO_GRAY16_BITMAP:
+    case WINE_GGO_HRGB_BITMAP:
+    case WINE_GGO_HBGR_BITMAP:
+    case WINE_GGO_VRGB_BITMAP:
+    case WINE_GGO_VBGR_BITMAP:
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* returns TRUE and sets *ret if the glyph is in the cache */
+static BOOL get_cached_glyph_bits( struct glyph_cache *cache, UINT index, UINT format,
+                                   GLYPHMETRICS *gm, ABC *abc, DWORD buflen, void *buf, DWORD *ret )
+{
+    struct list *bucket = &cache->buckets[index % GLYPH_CACHE_BUCKETS];
+    struct glyph_bits *bits;
+
+    EnterCriticalSection( &cache->cs );
+    LIST_FOR_EACH_ENTRY( bits, bucket, struct glyph_bits, entry )
+    {
+        if (bits->index != index || bits->format != format) continue;
+
+        /* keep the most recently used glyphs at the front */
+        list_remove( &bits->entry );
+        list_add_head( bucket, &bits->entry );
+
+        if (!buf || !buflen) *ret = bits->size;
+        else if (bits->size > buflen) *ret = GDI_ERROR;
+        else
+        {
+            memcpy( buf, bits->bits, bits->size );
+            /* the anti-aliased formats clear the whole buffer */
+            if ((format & ~GGO_UNHINTED) != GGO_BITMAP)
+                memset( (BYTE *)buf + bits->size, 0, buflen - bits->size );
+            *ret = bits->size;
+        }
+        if (*ret != GDI_ERROR)
+        {
+            *gm = bits->gm;
+            *abc = bits->abc;
+        }
+        LeaveCriticalSection( &cache->cs );
+        TRACE( "cached: index %04x format %x size %u\n", index, format, bits->size );
+        return TRUE;
+    }
+    LeaveCriticalSection( &cache->cs );
+    return FALSE;
+}
+
+static void add_cached_glyph_bits( struct glyph_cache *cache, UINT index, UINT format,
+                                   const GLYPHMETRICS *gm, const ABC *abc, DWORD size, const void *buf )
+{
+    struct glyph_bits *bits;
+
+    if (!(bits = HeapAlloc( GetProcessHeap(), 0, FIELD_OFFSET( struct glyph_bits, bits[size] ))))
+        return;
+    bits->index  = index;
+    bits->format = format;
+    bits->gm     = *gm;
+    bits->abc    = *abc;
+    bits->size   = size;
+    memcpy( bits->bits, buf, size );
+
+    EnterCriticalSection( &cache->cs );
+    if (cache->size + size > GLYPH_CACHE_MAX_SIZE)
+    {
+        TRACE( "flushing glyph cache %p\n", cache );
+        flush_glyph_cache( cache );
+    }
+    list_add_head( &cache->buckets[index % GLYPH_CACHE_BUCKETS], &bits->entry );
+    cache->size += size;
+    LeaveCriticalSection( &cache->cs );
+}
+
 static GdiFont *alloc_font(void)
 {
     GdiFont *ret = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*ret));
@@ -4664,6 +4854,7 @@ static void free_font(GdiFont *font)
     }
 
     HeapFree(GetProcessHeap(), 0, font->fileinfo);
+    if (font->glyph_cache) release_glyph_cache( font->glyph_cache );
     free_font_handle(font->instance_id);
     if (font->ft_face) pFT_Done_Face(font->ft_face);
     if (font->mapping) unmap_font_file( font->mapping );
@@ -6822,6 +7013,8 @@ static DWORD get_glyph_outline(GdiFont *incoming_font, UINT glyph, UINT format,
     BOOL tategaki = (font->name[0] == '@');
     BOOL vertical_metrics;
     UINT original_index;
+    struct glyph_cache *cache = NULL;
+    UINT cache_format;
 
     TRACE("%p, %04x, %08x, %p, %08x, %p, %p\n", font, glyph, format, lpgm,
 	  buflen, buf, lpmat);
@@ -6852,6 +7045,7 @@ static DWORD get_glyph_outline(GdiFont *incoming_font, UINT glyph, UINT format,
             tategaki = check_unicode_tategaki(glyph);
     }
 
+    cache_format = format;
     if(format & GGO_UNHINTED) {
         load_flags |= FT_LOAD_NO_HINTING;
         format &= ~GGO_UNHINTED;
@@ -6890,6 +7084,17 @@ static DWORD get_glyph_outline(GdiFont *incoming_font, UINT glyph, UINT format,
     else
         widthRatio = font->scale_y;
 
+    /* Rendered bitmaps only depend on the face and the font scaling, unless the glyph comes
+     * from a linked font (clipped to the metrics of the base font), or is rotated per glyph. */
+    if (font == incoming_font && font->name[0] != '@' && is_identity_MAT2(lpmat) &&
+        is_cacheable_glyph_format( cache_format ))
+    {
+        if (!font->glyph_cache) font->glyph_cache = grab_glyph_cache( font );
+        if ((cache = font->glyph_cache) &&
+            get_cached_glyph_bits( cache, glyph_index, cache_format, lpgm, abc, buflen, buf, &needed ))
+            return needed;
+    }
+
     /* Scaling transform */
     if (widthRatio != 1.0 || font->scale_y != 1.0)
     {
@@ -7489,6 +7694,8 @@ static DWORD get_glyph_outline(GdiFont *incoming_font, UINT glyph, UINT format,
 	return GDI_ERROR;
     }
     *lpgm = gm;
+    if (cache && buf && buflen && needed)
+        add_cached_glyph_bits( cache, glyph_index, cache_format, &gm, abc, needed, buf );
     return needed;
 }
 
@@ -8017,6 +8224,7 @@ static DWORD freetype_GetGlyphOutline( PHYSDEV dev, UINT glyph, UINT format,
                                        LPGLYPHMETRICS lpgm, DWORD buflen, LPVOID buf, const MAT2 *lpmat )
 {
     struct freetype_physdev *physdev = get_freetype_dev( dev );
+    struct glyph_cache *cache;
     DWORD ret;
     ABC abc;
 
@@ -8026,6 +8234,14 @@ static DWORD freetype_GetGlyphOutline( PHYSDEV dev, UINT glyph, UINT format,
         return dev->funcs->pGetGlyphOutline( dev, glyph, format, lpgm, buflen, buf, lpmat );
     }
 
+    /* glyph indices don't need font linking, so already rendered glyphs
+     * can be returned without serializing on freetype_cs */
+    if ((format & GGO_GLYPH_INDEX) && (cache = physdev->font->glyph_cache) &&
+        physdev->font->ft_face->charmap && physdev->font->ft_face->charmap->encoding != FT_ENCODING_NONE &&
+        is_identity_MAT2( lpmat ) && is_cacheable_glyph_format( format & ~GGO_GLYPH_INDEX ) &&
+        get_cached_glyph_bits( cache, glyph, format & ~GGO_GLYPH_INDEX, lpgm, &abc, buflen, buf, &ret ))
+        return ret;
+
     GDI_CheckNotLock();
     EnterCriticalSection( &freetype_cs );
     ret = get_glyph_outline( physdev->font, glyph, format, lpgm, &abc, buflen, buf, lpmat );
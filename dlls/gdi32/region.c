@@ -1152,6 +1152,24 @@ BOOL WINAPI EqualRgn( HRGN hrgn1, HRGN hrgn2 )
 static BOOL REGION_UnionRectWithRegion(const RECT *rect, WINEREGION *rgn)
 {
     WINEREGION region;
+    RECT *last;
+
+    /* rectangles are usually added in scanline order, so appending
+     * a new band at the bottom of the region is worth a shortcut */
+    if (rgn->numRects && rect->left < rect->right && rect->top < rect->bottom &&
+        rect->top >= rgn->extents.bottom)
+    {
+        last = &rgn->rects[rgn->numRects - 1];
+        if (last->bottom == rect->top && last->left == rect->left && last->right == rect->right &&
+            (rgn->numRects == 1 || last[-1].top != last->top))
+            last->bottom = rect->bottom;
+        else if (!add_rect( rgn, rect->left, rect->top, rect->right, rect->bottom ))
+            return FALSE;
+        rgn->extents.left = min( rgn->extents.left, rect->left );
+        rgn->extents.right = max( rgn->extents.right, rect->right );
+        rgn->extents.bottom = rect->bottom;
+        return TRUE;
+    }
 
     init_region( &region, 1 );
     region.numRects = 1;
@@ -1920,6 +1938,76 @@ static BOOL REGION_IntersectO(WINEREGION *pReg,  RECT *r1, RECT *r1End,
     return TRUE;
 }
 
+/***********************************************************************
+ *	     REGION_FindBand
+ *
+ * Return the index of the first rectangle whose bottom is below y. Since
+ * bands never overlap, this is always the start of a band.
+ */
+static INT REGION_FindBand( const WINEREGION *reg, INT y )
+{
+    INT i, start = 0, end = reg->numRects;
+
+    while (start < end)
+    {
+        i = (start + end) / 2;
+        if (reg->rects[i].bottom <= y) start = i + 1;
+        else end = i;
+    }
+    return start;
+}
+
+/***********************************************************************
+ *	     REGION_IntersectRect
+ *
+ * Intersect a region with a single rectangle. Only the bands that overlap
+ * the rectangle are visited, and since every source rectangle produces at
+ * most one destination rectangle the result is built directly in the
+ * destination storage, which may be the source region itself.
+ */
+static BOOL REGION_IntersectRect( WINEREGION *dst, WINEREGION *src, const RECT *rect )
+{
+    RECT clip = *rect;
+    INT i, count = src->numRects, left, right, top, bottom, bandTop = 0;
+    INT prevBand = 0, curBand = 0;
+
+    if (!count || !overlapping( &src->extents, &clip ))
+    {
+        empty_region( dst );
+        return TRUE;
+    }
+    if (dst != src && !grow_region( dst, count )) return FALSE;
+
+    i = REGION_FindBand( src, clip.top );
+    for (dst->numRects = 0; i < count; i++)
+    {
+        if (src->rects[i].top >= clip.bottom) break;
+
+        if (!dst->numRects || src->rects[i].top != bandTop)
+        {
+            if (dst->numRects != curBand) prevBand = REGION_Coalesce( dst, prevBand, curBand );
+            curBand = dst->numRects;
+            bandTop = src->rects[i].top;
+        }
+
+        left = max( src->rects[i].left, clip.left );
+        right = min( src->rects[i].right, clip.right );
+        if (left >= right) continue;
+        top = max( src->rects[i].top, clip.top );
+        bottom = min( src->rects[i].bottom, clip.bottom );
+
+        dst->rects[dst->numRects].left = left;
+        dst->rects[dst->numRects].top = top;
+        dst->rects[dst->numRects].right = right;
+        dst->rects[dst->numRects].bottom = bottom;
+        dst->numRects++;
+    }
+    if (dst->numRects != curBand) REGION_Coalesce( dst, prevBand, curBand );
+
+    REGION_SetExtents( dst );
+    return TRUE;
+}
+
 /***********************************************************************
  *	     REGION_IntersectRegion
  */
@@ -1930,6 +2018,10 @@ static BOOL REGION_IntersectRegion(WINEREGION *newReg, WINEREGION *reg1,
     if ( (!(reg1->numRects)) || (!(reg2->numRects))  ||
 	(!overlapping(&reg1->extents, &reg2->extents)))
 	newReg->numRects = 0;
+    else if (reg2->numRects == 1)
+        return REGION_IntersectRect( newReg, reg1, &reg2->extents );
+    else if (reg1->numRects == 1)
+        return REGION_IntersectRect( newReg, reg2, &reg1->extents );
     else
 	if (!REGION_RegionOp (newReg, reg1, reg2, REGION_IntersectO, NULL, NULL)) return FALSE;
 
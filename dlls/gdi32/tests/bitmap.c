@@ -3407,6 +3407,132 @@ static void test_StretchBlt(void)
     DeleteDC(hdcScreen);
 }
 
+static void test_StretchBlt_halftone(void)
+{
+    static const UINT32 colors[4] = {0x00ff0000, 0x0000ff00, 0x000000ff, 0x00808080};
+    /* The expected values below are those of a box filter when shrinking
+     * and linear interpolation when enlarging. They could not be checked
+     * against native. */
+    static const UINT32 checker_3x3[9] =
+    {
+        0x00787878, 0x00808080, 0x00878787,
+        0x00808080, 0x00808080, 0x00808080,
+        0x00878787, 0x00808080, 0x00787878,
+    };
+    static const UINT32 gradient_4x4[16] =
+    {
+        0x00401010, 0x00401050, 0x00401090, 0x004010d0,
+        0x00405010, 0x00405050, 0x00405090, 0x004050d0,
+        0x00409010, 0x00409050, 0x00409090, 0x004090d0,
+        0x0040d010, 0x0040d050, 0x0040d090, 0x0040d0d0,
+    };
+    static const UINT32 gradient_3x1[3] = {0x0040001c, 0x00400070, 0x004000c4};
+    static const UINT32 gradient_8x1[8] =
+    {
+        0x00400000, 0x00400008, 0x00400018, 0x00400028, 0x00400038, 0x00400048, 0x00400058, 0x00400060,
+    };
+    static const UINT32 gradient_2x2_4x4[16] =
+    {
+        0x00400000, 0x00400008, 0x00400018, 0x00400020,
+        0x00400800, 0x00400808, 0x00400818, 0x00400820,
+        0x00401800, 0x00401808, 0x00401818, 0x00401820,
+        0x00402000, 0x00402008, 0x00402018, 0x00402020,
+    };
+    HBITMAP bmp_dst, bmp_src, old_dst, old_src;
+    HDC hdc_dst, hdc_src;
+    UINT32 *dst_bits, *src_bits;
+    BITMAPINFO bi;
+    int x, y, ret;
+
+    memset(&bi, 0, sizeof(bi));
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = 8;
+    bi.bmiHeader.biHeight = -8;
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+
+    hdc_dst = CreateCompatibleDC(0);
+    hdc_src = CreateCompatibleDC(0);
+    bmp_dst = CreateDIBSection(hdc_dst, &bi, DIB_RGB_COLORS, (void **)&dst_bits, NULL, 0);
+    bmp_src = CreateDIBSection(hdc_src, &bi, DIB_RGB_COLORS, (void **)&src_bits, NULL, 0);
+    old_dst = SelectObject(hdc_dst, bmp_dst);
+    old_src = SelectObject(hdc_src, bmp_src);
+
+    ret = SetStretchBltMode(hdc_dst, HALFTONE);
+    ok(ret, "SetStretchBltMode failed\n");
+
+    /* four uniform 4x4 blocks shrink to four pixels of the block colors */
+    for (y = 0; y < 8; y++)
+        for (x = 0; x < 8; x++)
+            src_bits[y * 8 + x] = colors[(y / 4) * 2 + x / 4];
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 2, 2, hdc_src, 0, 0, 8, 8, SRCCOPY);
+    for (y = 0; y < 2; y++)
+        for (x = 0; x < 2; x++)
+            ok(dst_bits[y * 8 + x] == colors[y * 2 + x], "%d,%d: got %08x\n", x, y, dst_bits[y * 8 + x]);
+    ok(dst_bits[2] == 0xcccccccc, "got %08x\n", dst_bits[2]);
+
+    /* a uniform area stays uniform when enlarged */
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 8, 8, hdc_src, 0, 0, 2, 2, SRCCOPY);
+    for (y = 0; y < 8; y++)
+        for (x = 0; x < 8; x++)
+            ok(dst_bits[y * 8 + x] == colors[0], "%d,%d: got %08x\n", x, y, dst_bits[y * 8 + x]);
+
+    /* one pixel checkerboard */
+    for (y = 0; y < 8; y++)
+        for (x = 0; x < 8; x++)
+            src_bits[y * 8 + x] = (x + y) & 1 ? 0x00ffffff : 0;
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 2, 2, hdc_src, 0, 0, 8, 8, SRCCOPY);
+    for (y = 0; y < 2; y++)
+        for (x = 0; x < 2; x++)
+            ok(dst_bits[y * 8 + x] == 0x00808080, "%d,%d: got %08x\n", x, y, dst_bits[y * 8 + x]);
+
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 3, 3, hdc_src, 0, 0, 8, 8, SRCCOPY);
+    for (y = 0; y < 3; y++)
+        for (x = 0; x < 3; x++)
+            ok(dst_bits[y * 8 + x] == checker_3x3[y * 3 + x], "%d,%d: got %08x, expected %08x\n",
+               x, y, dst_bits[y * 8 + x], checker_3x3[y * 3 + x]);
+
+    /* gradients along both axes, red is constant */
+    for (y = 0; y < 8; y++)
+        for (x = 0; x < 8; x++)
+            src_bits[y * 8 + x] = 0x00400000 | (y * 32) << 8 | x * 32;
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 4, 4, hdc_src, 0, 0, 8, 8, SRCCOPY);
+    for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+            ok(dst_bits[y * 8 + x] == gradient_4x4[y * 4 + x], "%d,%d: got %08x, expected %08x\n",
+               x, y, dst_bits[y * 8 + x], gradient_4x4[y * 4 + x]);
+
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 3, 1, hdc_src, 0, 0, 8, 1, SRCCOPY);
+    for (x = 0; x < 3; x++)
+        ok(dst_bits[x] == gradient_3x1[x], "%d: got %08x, expected %08x\n", x, dst_bits[x], gradient_3x1[x]);
+
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 8, 1, hdc_src, 0, 0, 4, 1, SRCCOPY);
+    for (x = 0; x < 8; x++)
+        ok(dst_bits[x] == gradient_8x1[x], "%d: got %08x, expected %08x\n", x, dst_bits[x], gradient_8x1[x]);
+
+    memset(dst_bits, 0xcc, 8 * 8 * sizeof(*dst_bits));
+    StretchBlt(hdc_dst, 0, 0, 4, 4, hdc_src, 0, 0, 2, 2, SRCCOPY);
+    for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+            ok(dst_bits[y * 8 + x] == gradient_2x2_4x4[y * 4 + x], "%d,%d: got %08x, expected %08x\n",
+               x, y, dst_bits[y * 8 + x], gradient_2x2_4x4[y * 4 + x]);
+
+    SelectObject(hdc_src, old_src);
+    SelectObject(hdc_dst, old_dst);
+    DeleteObject(bmp_src);
+    DeleteObject(bmp_dst);
+    DeleteDC(hdc_src);
+    DeleteDC(hdc_dst);
+}
+
 static void check_StretchDIBits_pixel(HDC hdcDst, UINT32 *dstBuffer, UINT32 *srcBuffer,
                                       DWORD dwRop, UINT32 expected, int line)
 {
@@ -5953,6 +6079,7 @@ START_TEST(bitmap)
     test_CreateBitmap();
     test_BitBlt();
     test_StretchBlt();
+    test_StretchBlt_halftone();
     test_StretchDIBits();
     test_GdiAlphaBlend();
     test_GdiGradientFill();
@@ -168,6 +168,86 @@ static void verify_region(HRGN hrgn, const RECT *rc)
     ok(EqualRect(&rgn.data.rdh.rcBound, rc), "rects don't match\n");
 }
 
+static void verify_region_rects(HRGN hrgn, const RECT *rects, DWORD count)
+{
+    char buffer[sizeof(RGNDATAHEADER) + 8 * sizeof(RECT)];
+    RGNDATA *data = (RGNDATA *)buffer;
+    const RECT *rect = (const RECT *)data->Buffer;
+    DWORD ret, i;
+
+    ret = GetRegionData(hrgn, sizeof(buffer), data);
+    ok(ret == sizeof(data->rdh) + count * sizeof(RECT), "got %u\n", ret);
+    ok(data->rdh.nCount == count, "expected %u rects, got %u\n", count, data->rdh.nCount);
+    for (i = 0; i < min(count, data->rdh.nCount); i++)
+        ok(EqualRect(&rect[i], &rects[i]), "%u: expected %s, got %s\n", i,
+           wine_dbgstr_rect(&rects[i]), wine_dbgstr_rect(&rect[i]));
+}
+
+static void test_CombineRgn(void)
+{
+    static const RECT grid[] = {{0, 0, 10, 10}, {20, 0, 30, 10}, {0, 10, 10, 20}, {20, 10, 40, 20}};
+    static const RECT and_inner[] = {{5, 5, 10, 10}, {20, 5, 30, 10}, {5, 10, 10, 15}, {20, 10, 35, 15}};
+    static const RECT and_merged[] = {{0, 0, 10, 20}, {20, 0, 30, 20}};
+    static const RECT and_band[] = {{0, 12, 10, 20}, {20, 12, 40, 20}};
+    HRGN hrgn, hrect, hdst;
+    RECT rc;
+    int ret, i;
+
+    hrgn = CreateRectRgn(0, 0, 0, 0);
+    for (i = 0; i < ARRAY_SIZE(grid); i++)
+    {
+        hrect = CreateRectRgnIndirect(&grid[i]);
+        ret = CombineRgn(hrgn, hrgn, hrect, RGN_OR);
+        ok(ret == (i ? COMPLEXREGION : SIMPLEREGION), "%d: got %d\n", i, ret);
+        DeleteObject(hrect);
+    }
+    verify_region_rects(hrgn, grid, ARRAY_SIZE(grid));
+
+    hdst = CreateRectRgn(0, 0, 0, 0);
+    hrect = CreateRectRgn(5, 5, 35, 15);
+    ret = CombineRgn(hdst, hrgn, hrect, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    verify_region_rects(hdst, and_inner, ARRAY_SIZE(and_inner));
+    ret = CombineRgn(hdst, hrect, hrgn, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    verify_region_rects(hdst, and_inner, ARRAY_SIZE(and_inner));
+
+    /* bands that become identical after clipping are merged */
+    SetRectRgn(hrect, 0, 0, 30, 20);
+    ret = CombineRgn(hdst, hrgn, hrect, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    verify_region_rects(hdst, and_merged, ARRAY_SIZE(and_merged));
+
+    /* destination is one of the sources */
+    SetRectRgn(hrect, -5, 12, 50, 30);
+    CombineRgn(hdst, hrgn, 0, RGN_COPY);
+    ret = CombineRgn(hdst, hdst, hrect, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    verify_region_rects(hdst, and_band, ARRAY_SIZE(and_band));
+    ret = CombineRgn(hrect, hrgn, hrect, RGN_AND);
+    ok(ret == COMPLEXREGION, "got %d\n", ret);
+    verify_region_rects(hrect, and_band, ARRAY_SIZE(and_band));
+
+    /* rectangle inside a hole */
+    SetRectRgn(hrect, 12, 2, 18, 8);
+    ret = CombineRgn(hdst, hrgn, hrect, RGN_AND);
+    ok(ret == NULLREGION, "got %d\n", ret);
+    SetRectEmpty(&rc);
+    verify_region(hdst, &rc);
+
+    /* two rectangles */
+    SetRectRgn(hrgn, 0, 0, 10, 10);
+    SetRectRgn(hrect, 5, 5, 15, 15);
+    ret = CombineRgn(hdst, hrgn, hrect, RGN_AND);
+    ok(ret == SIMPLEREGION, "got %d\n", ret);
+    SetRect(&rc, 5, 5, 10, 10);
+    verify_region(hdst, &rc);
+
+    DeleteObject(hdst);
+    DeleteObject(hrect);
+    DeleteObject(hrgn);
+}
+
 static void test_ExtCreateRegion(void)
 {
     static const RECT empty_rect;
@@ -538,6 +618,7 @@ START_TEST(clipping)
 {
     test_GetRandomRgn();
     test_ExtCreateRegion();
+    test_CombineRgn();
     test_GetClipRgn();
     test_memory_dc_clipping();
     test_window_dc_clipping();
@@ -5716,6 +5716,78 @@ todo_wine
     ReleaseDC(NULL, hdc);
 }
 
+static void test_GetGlyphOutline_repeated(void)
+{
+    static const UINT formats[] = {GGO_BITMAP, GGO_GRAY2_BITMAP, GGO_GRAY4_BITMAP, GGO_GRAY8_BITMAP};
+    static const BYTE charsets[] = {ANSI_CHARSET, DEFAULT_CHARSET};
+    BYTE *bits[2][2];
+    GLYPHMETRICS gm, gm2;
+    HFONT hfont, hfont_prev;
+    LOGFONTA lf;
+    DWORD size, ret;
+    WORD index;
+    HDC hdc;
+    int i, j;
+
+    if (!is_truetype_font_installed("Tahoma"))
+    {
+        skip("Tahoma is not installed\n");
+        return;
+    }
+
+    hdc = GetDC(NULL);
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+    {
+        size = 0;
+        for (j = 0; j < ARRAY_SIZE(charsets); j++)
+        {
+            memset(&lf, 0, sizeof(lf));
+            lf.lfHeight = -32;
+            lf.lfCharSet = charsets[j];
+            lstrcpyA(lf.lfFaceName, "Tahoma");
+            hfont = CreateFontIndirectA(&lf);
+            ok(hfont != 0, "CreateFontIndirectA error %u\n", GetLastError());
+            hfont_prev = SelectObject(hdc, hfont);
+
+            ret = GetGlyphIndicesA(hdc, "A", 1, &index, 0);
+            ok(ret == 1, "GetGlyphIndices returned %u\n", ret);
+
+            ret = GetGlyphOutlineA(hdc, index, formats[i] | GGO_GLYPH_INDEX, &gm, 0, NULL, &mat);
+            ok(ret != GDI_ERROR && ret, "%u: GetGlyphOutline failed\n", formats[i]);
+            if (!j) size = ret;
+            else ok(ret == size, "%u: got size %u, expected %u\n", formats[i], ret, size);
+
+            bits[j][0] = HeapAlloc(GetProcessHeap(), 0, size);
+            bits[j][1] = HeapAlloc(GetProcessHeap(), 0, size);
+
+            ret = GetGlyphOutlineA(hdc, index, formats[i] | GGO_GLYPH_INDEX, &gm, size, bits[j][0], &mat);
+            ok(ret == size, "%u: got %u, expected %u\n", formats[i], ret, size);
+            memset(bits[j][1], 0xcc, size);
+            ret = GetGlyphOutlineA(hdc, index, formats[i] | GGO_GLYPH_INDEX, &gm2, size, bits[j][1], &mat);
+            ok(ret == size, "%u: got %u, expected %u\n", formats[i], ret, size);
+            ok(!memcmp(&gm, &gm2, sizeof(gm)), "%u: glyph metrics differ\n", formats[i]);
+            ok(!memcmp(bits[j][0], bits[j][1], size), "%u: glyph bits differ\n", formats[i]);
+
+            ret = GetGlyphOutlineA(hdc, index, formats[i] | GGO_GLYPH_INDEX, &gm2, size - 1, bits[j][1], &mat);
+            ok(ret == GDI_ERROR, "%u: got %u\n", formats[i], ret);
+
+            SelectObject(hdc, hfont_prev);
+            DeleteObject(hfont);
+        }
+
+        ok(!memcmp(bits[0][0], bits[1][0], size), "%u: glyph bits differ between fonts\n", formats[i]);
+
+        for (j = 0; j < ARRAY_SIZE(charsets); j++)
+        {
+            HeapFree(GetProcessHeap(), 0, bits[j][0]);
+            HeapFree(GetProcessHeap(), 0, bits[j][1]);
+        }
+    }
+
+    ReleaseDC(NULL, hdc);
+}
+
 static void test_fstype_fixup(void)
 {
     HDC hdc;
@@ -6922,6 +6994,7 @@ START_TEST(font)
     test_bitmap_font_glyph_index();
     test_GetCharWidthI();
     test_long_names();
+    test_GetGlyphOutline_repeated();
 
     /* These tests should be last test until RemoveFontResource
      * is properly implemented.
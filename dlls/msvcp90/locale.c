@@ -7448,6 +7448,71 @@ static ostreambuf_iterator_char* num_put_char_fput(const num_put *this, ostreamb
     return num_put_char__Rep(this, ret, dest, fill, pad);
 }
 
+/* Formats integer the same way as sprintf with format returned by _Ifmt.
+ * v contains the value sign or zero extended from type of given size. */
+static MSVCP_size_t num_put_format_int(char *buf, ULONGLONG v, unsigned int size, BOOL is_signed, int fmtfl)
+{
+    static const char digits_lower[] = "0123456789abcdef";
+    static const char digits_upper[] = "0123456789ABCDEF";
+    int base = fmtfl & FMTFLAG_basefield;
+    const char *digits = (fmtfl & FMTFLAG_uppercase) ? digits_upper : digits_lower;
+    unsigned int radix;
+    char tmp[24], *end = tmp+sizeof(tmp), *p = end;
+    MSVCP_size_t len = 0;
+
+    if(base == FMTFLAG_oct)
+        radix = 8;
+    else if(base == FMTFLAG_hex)
+        radix = 16;
+    else
+        radix = 10;
+
+    if(radix == 10 && is_signed) {
+        if((LONGLONG)v < 0) {
+            buf[len++] = '-';
+            v = -v;
+        }else if(fmtfl & FMTFLAG_showpos) {
+            buf[len++] = '+';
+        }
+    }else {
+        if(size < sizeof(v))
+            v &= ((ULONGLONG)1 << size*8) - 1;
+
+        if(v && (fmtfl & FMTFLAG_showbase)) {
+            if(radix == 16) {
+                buf[len++] = '0';
+                buf[len++] = (fmtfl & FMTFLAG_uppercase) ? 'X' : 'x';
+            }else if(radix == 8) {
+                buf[len++] = '0';
+            }
+        }
+    }
+
+    if(radix == 10) {
+        /* avoid 64-bit division when the value fits in 32 bits */
+        while(v > 0xffffffff) {
+            *--p = '0' + v%10;
+            v /= 10;
+        }
+        do {
+            *--p = '0' + (ULONG)v%10;
+            v = (ULONG)v/10;
+        }while(v);
+    }else {
+        unsigned int shift = (radix == 16 ? 4 : 3);
+
+        do {
+            *--p = digits[v & (radix-1)];
+            v >>= shift;
+        }while(v);
+    }
+
+    memcpy(buf+len, p, end-p);
+    len += end-p;
+    buf[len] = '\0';
+    return len;
+}
+
 /* ?_Ifmt@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@ABAPADPADPBDH@Z */
 /* ?_Ifmt@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@AEBAPEADPEADPEBDH@Z */
 char* __cdecl num_put_char__Ifmt(const num_put *this, char *fmt, const char *spec, int fmtfl)
@@ -7556,12 +7621,11 @@ ostreambuf_iterator_char* __thiscall num_put_char_do_put_long(const num_put *thi
         ostreambuf_iterator_char dest, ios_base *base, char fill, LONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_char__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_char__Ifmt(this, fmt, "ld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?put@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@DU?$char_traits@D@std@@@2@V32@AAVios_base@2@DJ@Z */
@@ -7598,12 +7662,11 @@ ostreambuf_iterator_char* __thiscall num_put_char_do_put_ulong(const num_put *th
         ostreambuf_iterator_char dest, ios_base *base, char fill, ULONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_char__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_char__Ifmt(this, fmt, "lu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?put@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@DU?$char_traits@D@std@@@2@V32@AAVios_base@2@DK@Z */
@@ -7765,12 +7828,11 @@ ostreambuf_iterator_char* __thiscall num_put_char_do_put_int64(const num_put *th
         ostreambuf_iterator_char dest, ios_base *base, char fill, __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_char__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_char__Ifmt(this, fmt, "lld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?put@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@DU?$char_traits@D@std@@@2@V32@AAVios_base@2@D_J@Z */
@@ -7807,12 +7869,11 @@ ostreambuf_iterator_char* __thiscall num_put_char_do_put_uint64(const num_put *t
         ostreambuf_iterator_char dest, ios_base *base, char fill, unsigned __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_char__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_char__Ifmt(this, fmt, "llu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?put@?$num_put@DV?$ostreambuf_iterator@DU?$char_traits@D@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@DU?$char_traits@D@std@@@2@V32@AAVios_base@2@D_K@Z */
@@ -8471,12 +8532,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_wchar_do_put_long(const num_put *t
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, LONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_wchar__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "ld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?do_put@?$num_put@GV?$ostreambuf_iterator@GU?$char_traits@G@std@@@std@@@std@@MBE?AV?$ostreambuf_iterator@GU?$char_traits@G@std@@@2@V32@AAVios_base@2@GJ@Z */
@@ -8490,12 +8550,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_short_do_put_long(const num_put *t
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, LONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_short__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "ld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?put@?$num_put@_WV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@2@V32@AAVios_base@2@_WJ@Z */
@@ -8534,12 +8593,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_wchar_do_put_ulong(const num_put *
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, ULONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_wchar__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "lu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?do_put@?$num_put@GV?$ostreambuf_iterator@GU?$char_traits@G@std@@@std@@@std@@MBE?AV?$ostreambuf_iterator@GU?$char_traits@G@std@@@2@V32@AAVios_base@2@GK@Z */
@@ -8553,12 +8611,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_short_do_put_ulong(const num_put *
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, ULONG v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d %d)\n", this, ret, base, fill, v);
 
     return num_put_short__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "lu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?put@?$num_put@_WV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@2@V32@AAVios_base@2@_WK@Z */
@@ -8773,12 +8830,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_wchar_do_put_int64(const num_put *
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_wchar__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "lld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?do_put@?$num_put@GV?$ostreambuf_iterator@GU?$char_traits@G@std@@@std@@@std@@MBE?AV?$ostreambuf_iterator@GU?$char_traits@G@std@@@2@V32@AAVios_base@2@G_J@Z */
@@ -8792,12 +8848,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_short_do_put_int64(const num_put *
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_short__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "lld", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), TRUE, base->fmtfl));
 }
 
 /* ?put@?$num_put@_WV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@2@V32@AAVios_base@2@_W_J@Z */
@@ -8836,12 +8891,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_wchar_do_put_uint64(const num_put
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, unsigned __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_wchar__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "llu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?do_put@?$num_put@GV?$ostreambuf_iterator@GU?$char_traits@G@std@@@std@@@std@@MBE?AV?$ostreambuf_iterator@GU?$char_traits@G@std@@@2@V32@AAVios_base@2@G_K@Z */
@@ -8855,12 +8909,11 @@ ostreambuf_iterator_wchar* __thiscall num_put_short_do_put_uint64(const num_put
         ostreambuf_iterator_wchar dest, ios_base *base, wchar_t fill, unsigned __int64 v)
 {
     char tmp[48]; /* 22(8^22>2^64)*2(separators between every digit) + 3(strlen("+0x"))+1 */
-    char fmt[7]; /* strlen("%+#lld")+1 */
 
     TRACE("(%p %p %p %d)\n", this, ret, base, fill);
 
     return num_put_short__Iput(this, ret, dest, base, fill, tmp,
-            sprintf(tmp, num_put_wchar__Ifmt(this, fmt, "llu", base->fmtfl), v));
+            num_put_format_int(tmp, v, sizeof(v), FALSE, base->fmtfl));
 }
 
 /* ?put@?$num_put@_WV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@std@@@std@@QBE?AV?$ostreambuf_iterator@_WU?$char_traits@_W@std@@@2@V32@AAVios_base@2@_W_K@Z */
@@ -1582,6 +1582,24 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_rfind_ch(
     return MSVCP_basic_string_char_rfind_cstr_substr(this, &ch, pos, 1);
 }
 
+/* bitmap of the characters passed to find_*_of functions, so each character
+ * of the searched string is checked in constant time */
+typedef struct {
+    unsigned int bits[256/32];
+} char_set;
+
+static void char_set_init(char_set *set, const char *chars, MSVCP_size_t len)
+{
+    memset(set, 0, sizeof(*set));
+    for(; len; len--, chars++)
+        set->bits[(unsigned char)*chars/32] |= 1u << ((unsigned char)*chars%32);
+}
+
+static inline BOOL char_set_contains(const char_set *set, char ch)
+{
+    return (set->bits[(unsigned char)ch/32] >> ((unsigned char)ch%32)) & 1;
+}
+
 /* ?find_first_of@?$basic_string@DU?$char_traits@D@std@@V?$allocator@D@2@@std@@QBEIPBDII@Z */
 /* ?find_first_of@?$basic_string@DU?$char_traits@D@std@@V?$allocator@D@2@@std@@QEBA_KPEBD_K1@Z */
 DEFINE_THISCALL_WRAPPER(MSVCP_basic_string_char_find_first_of_cstr_substr, 16)
@@ -1589,13 +1607,15 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_first_of_cstr_substr(
         const basic_string_char *this, const char *find, MSVCP_size_t off, MSVCP_size_t len)
 {
     const char *p, *end;
+    char_set set;
 
     TRACE("%p %p %lu %lu\n", this, find, off, len);
 
     if(len>0 && off<this->size) {
+        char_set_init(&set, find, len);
         end = basic_string_char_const_ptr(this)+this->size;
         for(p=basic_string_char_const_ptr(this)+off; p<end; p++)
-            if(MSVCP_char_traits_char_find(find, len, p))
+            if(char_set_contains(&set, *p))
                 return p-basic_string_char_const_ptr(this);
     }
 
@@ -1824,13 +1844,15 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_first_not_of_cstr_substr(
         const basic_string_char *this, const char *find, MSVCP_size_t off, MSVCP_size_t len)
 {
     const char *p, *end;
+    char_set set;
 
     TRACE("%p %p %lu %lu\n", this, find, off, len);
 
     if(off<this->size) {
+        char_set_init(&set, find, len);
         end = basic_string_char_const_ptr(this)+this->size;
         for(p=basic_string_char_const_ptr(this)+off; p<end; p++)
-            if(!MSVCP_char_traits_char_find(find, len, p))
+            if(!char_set_contains(&set, *p))
                 return p-basic_string_char_const_ptr(this);
     }
 
@@ -1873,6 +1895,7 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_last_of_cstr_substr(
         const basic_string_char *this, const char *find, MSVCP_size_t off, MSVCP_size_t len)
 {
     const char *p, *beg;
+    char_set set;
 
     TRACE("%p %p %lu %lu\n", this, find, off, len);
 
@@ -1880,9 +1903,10 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_last_of_cstr_substr(
         if(off >= this->size)
             off = this->size-1;
 
+        char_set_init(&set, find, len);
         beg = basic_string_char_const_ptr(this);
         for(p=beg+off; p>=beg; p--)
-            if(MSVCP_char_traits_char_find(find, len, p))
+            if(char_set_contains(&set, *p))
                 return p-beg;
     }
 
@@ -1925,6 +1949,7 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_last_not_of_cstr_substr(
         const basic_string_char *this, const char *find, MSVCP_size_t off, MSVCP_size_t len)
 {
     const char *p, *beg;
+    char_set set;
 
     TRACE("%p %p %lu %lu\n", this, find, off, len);
 
@@ -1932,9 +1957,10 @@ MSVCP_size_t __thiscall MSVCP_basic_string_char_find_last_not_of_cstr_substr(
         if(off >= this->size)
             off = this->size-1;
 
+        char_set_init(&set, find, len);
         beg = basic_string_char_const_ptr(this);
         for(p=beg+off; p>=beg; p--)
-            if(!MSVCP_char_traits_char_find(find, len, p))
+            if(!char_set_contains(&set, *p))
                 return p-beg;
     }
 
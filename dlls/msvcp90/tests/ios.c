@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <locale.h>
+#include <limits.h>
 #include <sys/stat.h>
 
 #include <windef.h>
@@ -508,6 +509,11 @@ static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_float)(basic_
 
 static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_double)(basic_ostream_char*, double);
 
+static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_long)(basic_ostream_char*, LONG);
+static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_ulong)(basic_ostream_char*, ULONG);
+static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_int64)(basic_ostream_char*, LONGLONG);
+static basic_ostream_char* (*__thiscall p_basic_ostream_char_print_uint64)(basic_ostream_char*, ULONGLONG);
+
 static basic_ostream_wchar* (*__thiscall p_basic_ostream_wchar_print_double)(basic_ostream_wchar*, double);
 
 static basic_ostream_char* (*__cdecl p_basic_ostream_char_print_complex_float)(basic_ostream_char*, complex_float*);
@@ -596,6 +602,7 @@ static void * (WINAPI *call_thiscall_func5)( void *func, void *this, const void
 static void * (WINAPI *call_thiscall_func2_ptr_dbl)( void *func, void *this, double a );
 static void * (WINAPI *call_thiscall_func2_ptr_flt)( void *func, void *this, float a );
 static void * (WINAPI *call_thiscall_func2_ptr_fpos)( void *func, void *this, fpos_int a );
+static void * (WINAPI *call_thiscall_func2_ptr_int64)( void *func, void *this, ULONGLONG a );
 
 static void init_thiscall_thunk(void)
 {
@@ -615,6 +622,7 @@ static void init_thiscall_thunk(void)
     call_thiscall_func2_ptr_dbl  = (void *)thunk;
     call_thiscall_func2_ptr_flt  = (void *)thunk;
     call_thiscall_func2_ptr_fpos = (void *)thunk;
+    call_thiscall_func2_ptr_int64 = (void *)thunk;
 }
 
 #define call_func1(func,_this) call_thiscall_func1(func,_this)
@@ -628,6 +636,7 @@ static void init_thiscall_thunk(void)
 #define call_func2_ptr_dbl(func,_this,a)  call_thiscall_func2_ptr_dbl(func,_this,a)
 #define call_func2_ptr_flt(func,_this,a)  call_thiscall_func2_ptr_flt(func,_this,a)
 #define call_func2_ptr_fpos(func,_this,a) call_thiscall_func2_ptr_fpos(func,_this,a)
+#define call_func2_ptr_int64(func,_this,a) call_thiscall_func2_ptr_int64(func,_this,a)
 
 #else
 
@@ -641,6 +650,7 @@ static void init_thiscall_thunk(void)
 #define call_func2_ptr_dbl   call_func2
 #define call_func2_ptr_flt   call_func2
 #define call_func2_ptr_fpos  call_func2
+#define call_func2_ptr_int64 call_func2
 
 #endif /* __i386__ */
 
@@ -748,6 +758,15 @@ static BOOL init(void)
         SET(p_basic_ostream_char_print_double,
             "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QEAAAEAV01@N@Z");
 
+        SET(p_basic_ostream_char_print_long,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QEAAAEAV01@J@Z");
+        SET(p_basic_ostream_char_print_ulong,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QEAAAEAV01@K@Z");
+        SET(p_basic_ostream_char_print_int64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QEAAAEAV01@_J@Z");
+        SET(p_basic_ostream_char_print_uint64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QEAAAEAV01@_K@Z");
+
         SET(p_basic_ostream_wchar_print_double,
             "??6?$basic_ostream@_WU?$char_traits@_W@std@@@std@@QEAAAEAV01@N@Z");
 
@@ -901,6 +920,15 @@ static BOOL init(void)
         SET(p_basic_ostream_char_print_double,
             "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAAAAV01@N@Z");
 
+        SET(p_basic_ostream_char_print_long,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAAAAV01@J@Z");
+        SET(p_basic_ostream_char_print_ulong,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAAAAV01@K@Z");
+        SET(p_basic_ostream_char_print_int64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAAAAV01@_J@Z");
+        SET(p_basic_ostream_char_print_uint64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAAAAV01@_K@Z");
+
         SET(p_basic_ostream_wchar_print_double,
             "??6?$basic_ostream@_WU?$char_traits@_W@std@@@std@@QAAAAV01@N@Z");
 
@@ -1050,6 +1078,15 @@ static BOOL init(void)
         SET(p_basic_ostream_char_print_double,
             "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAEAAV01@N@Z");
 
+        SET(p_basic_ostream_char_print_long,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAEAAV01@J@Z");
+        SET(p_basic_ostream_char_print_ulong,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAEAAV01@K@Z");
+        SET(p_basic_ostream_char_print_int64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAEAAV01@_J@Z");
+        SET(p_basic_ostream_char_print_uint64,
+            "??6?$basic_ostream@DU?$char_traits@D@std@@@std@@QAEAAV01@_K@Z");
+
         SET(p_basic_ostream_wchar_print_double,
             "??6?$basic_ostream@_WU?$char_traits@_W@std@@@std@@QAEAAV01@N@Z");
 
@@ -1534,6 +1571,128 @@ static void test_num_put_put_double(void)
 }
 
 
+static void test_num_put_put_int64(void)
+{
+    basic_stringstream_char ss;
+    basic_string_char pstr;
+    const char *str;
+    int i;
+
+    struct _test_num_put {
+        ULONGLONG     val;
+        BOOL          is_signed;
+        IOSB_fmtflags fmtfl;
+        const char    *str;
+    } tests[] = {
+        { 0,                            TRUE,  0, "0" },
+        { 1234567890123456789,          TRUE,  0, "1234567890123456789" },
+        { -1234567890123456789,         TRUE,  0, "-1234567890123456789" },
+        { _I64_MAX,                     TRUE,  0, "9223372036854775807" },
+        { _I64_MIN,                     TRUE,  0, "-9223372036854775808" },
+        { _UI64_MAX,                    FALSE, 0, "18446744073709551615" },
+
+        /* negative values are printed as unsigned in hex and octal */
+        { -1,                           TRUE,  FMTFLAG_hex, "ffffffffffffffff" },
+        { -1,                           TRUE,  FMTFLAG_oct, "1777777777777777777777" },
+        { _I64_MIN,                     TRUE,  FMTFLAG_hex, "8000000000000000" },
+        { _I64_MIN,                     TRUE,  FMTFLAG_oct, "1000000000000000000000" },
+        { 0x123456789abcdef0,           TRUE,  FMTFLAG_hex, "123456789abcdef0" },
+        { 0x123456789abcdef0,           TRUE,  FMTFLAG_hex|FMTFLAG_uppercase, "123456789ABCDEF0" },
+
+        /* showpos only applies to signed decimal values */
+        { 42,                           TRUE,  FMTFLAG_showpos, "+42" },
+        { 0,                            TRUE,  FMTFLAG_showpos, "+0" },
+        { -42,                          TRUE,  FMTFLAG_showpos, "-42" },
+        { 42,                           FALSE, FMTFLAG_showpos, "42" },
+        { 42,                           TRUE,  FMTFLAG_showpos|FMTFLAG_hex, "2a" },
+
+        /* showbase is not applied to 0 */
+        { 255,                          TRUE,  FMTFLAG_showbase|FMTFLAG_hex, "0xff" },
+        { 255,                          TRUE,  FMTFLAG_showbase|FMTFLAG_hex|FMTFLAG_uppercase, "0XFF" },
+        { 8,                            TRUE,  FMTFLAG_showbase|FMTFLAG_oct, "010" },
+        { 42,                           TRUE,  FMTFLAG_showbase, "42" },
+        { 0,                            TRUE,  FMTFLAG_showbase|FMTFLAG_hex, "0" },
+        { 0,                            TRUE,  FMTFLAG_showbase|FMTFLAG_oct, "0" },
+        { 0,                            FALSE, FMTFLAG_showbase|FMTFLAG_hex, "0" },
+        { -1,                           TRUE,  FMTFLAG_showbase|FMTFLAG_hex|FMTFLAG_uppercase,
+            "0XFFFFFFFFFFFFFFFF" },
+    };
+
+    for(i=0; i<ARRAY_SIZE(tests); i++) {
+        call_func1(p_basic_stringstream_char_ctor, &ss);
+        call_func3(p_ios_base_setf_mask, &ss.basic_ios.base, tests[i].fmtfl, FMTFLAG_mask);
+        if(tests[i].is_signed)
+            call_func2_ptr_int64(p_basic_ostream_char_print_int64, &ss.base.base2, tests[i].val);
+        else
+            call_func2_ptr_int64(p_basic_ostream_char_print_uint64, &ss.base.base2, tests[i].val);
+
+        call_func2(p_basic_stringstream_char_str_get, &ss, &pstr);
+        str = call_func1(p_basic_string_char_cstr, &pstr);
+        ok(!strcmp(tests[i].str, str), "%d) wrong output, expected = %s found = %s\n", i, tests[i].str, str);
+        call_func1(p_basic_string_char_dtor, &pstr);
+        call_func1(p_basic_stringstream_char_vbase_dtor, &ss);
+    }
+}
+
+static void test_num_put_put_long(void)
+{
+    basic_stringstream_char ss;
+    basic_string_char pstr;
+    const char *str;
+    int i;
+
+    struct _test_num_put {
+        LONG          val;
+        BOOL          is_signed;
+        IOSB_fmtflags fmtfl;
+        const char    *str;
+    } tests[] = {
+        { 0,            TRUE,  0, "0" },
+        { 123456789,    TRUE,  0, "123456789" },
+        { -123456789,   TRUE,  0, "-123456789" },
+        { LONG_MAX,     TRUE,  0, "2147483647" },
+        { LONG_MIN,     TRUE,  0, "-2147483648" },
+        { -1,           FALSE, 0, "4294967295" },
+
+        /* negative values are printed as unsigned in hex and octal */
+        { -1,           TRUE,  FMTFLAG_hex, "ffffffff" },
+        { -1,           TRUE,  FMTFLAG_oct, "37777777777" },
+        { LONG_MIN,     TRUE,  FMTFLAG_hex, "80000000" },
+        { LONG_MIN,     TRUE,  FMTFLAG_oct, "20000000000" },
+        { 0x7abcdef0,   TRUE,  FMTFLAG_hex|FMTFLAG_uppercase, "7ABCDEF0" },
+
+        /* showpos only applies to signed decimal values */
+        { 42,           TRUE,  FMTFLAG_showpos, "+42" },
+        { 0,            TRUE,  FMTFLAG_showpos, "+0" },
+        { LONG_MIN,     TRUE,  FMTFLAG_showpos, "-2147483648" },
+        { 42,           FALSE, FMTFLAG_showpos, "42" },
+        { 42,           TRUE,  FMTFLAG_showpos|FMTFLAG_oct, "52" },
+
+        /* showbase is not applied to 0 */
+        { 255,          TRUE,  FMTFLAG_showbase|FMTFLAG_hex, "0xff" },
+        { 255,          FALSE, FMTFLAG_showbase|FMTFLAG_hex|FMTFLAG_uppercase, "0XFF" },
+        { 8,            TRUE,  FMTFLAG_showbase|FMTFLAG_oct, "010" },
+        { 0,            TRUE,  FMTFLAG_showbase|FMTFLAG_hex, "0" },
+        { 0,            FALSE, FMTFLAG_showbase|FMTFLAG_oct, "0" },
+        { -1,           TRUE,  FMTFLAG_showbase|FMTFLAG_hex|FMTFLAG_uppercase, "0XFFFFFFFF" },
+    };
+
+    for(i=0; i<ARRAY_SIZE(tests); i++) {
+        call_func1(p_basic_stringstream_char_ctor, &ss);
+        call_func3(p_ios_base_setf_mask, &ss.basic_ios.base, tests[i].fmtfl, FMTFLAG_mask);
+        if(tests[i].is_signed)
+            call_func2(p_basic_ostream_char_print_long, &ss.base.base2, tests[i].val);
+        else
+            call_func2(p_basic_ostream_char_print_ulong, &ss.base.base2, tests[i].val);
+
+        call_func2(p_basic_stringstream_char_str_get, &ss, &pstr);
+        str = call_func1(p_basic_string_char_cstr, &pstr);
+        ok(!strcmp(tests[i].str, str), "%d) wrong output, expected = %s found = %s\n", i, tests[i].str, str);
+        call_func1(p_basic_string_char_dtor, &pstr);
+        call_func1(p_basic_stringstream_char_vbase_dtor, &ss);
+    }
+}
+
 static void test_istream_ipfx(void)
 {
     unsigned short testus, nextus;
@@ -2512,6 +2671,8 @@ START_TEST(ios)
     test_num_get_get_uint64();
     test_num_get_get_double();
     test_num_put_put_double();
+    test_num_put_put_int64();
+    test_num_put_put_long();
     test_istream_ipfx();
     test_istream_ignore();
     test_istream_seekg();
@@ -148,10 +148,19 @@ typedef struct {
     char pad[64];
 } event;
 
+struct ContextVtbl;
 typedef struct {
-    void *vtable;
+    struct ContextVtbl *vtable;
 } Context;
 
+struct ContextVtbl {
+    unsigned int (__thiscall *GetId)(Context*);
+    unsigned int (__thiscall *GetVirtualProcessorId)(Context*);
+    unsigned int (__thiscall *GetScheduleGroupId)(Context*);
+    void (__thiscall *Unblock)(Context*);
+    MSVCRT_bool (__thiscall *IsSynchronouslyBlocked)(Context*);
+};
+
 typedef struct {
     void *policy_container;
 } SchedulerPolicy;
@@ -170,8 +179,8 @@ struct SchedulerVtbl {
     unsigned int (__thiscall *Release)(Scheduler*);
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
-    /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*,void (__cdecl*)(void*),void*);
 };
 
 static int* (__cdecl *p_errno)(void);
@@ -223,6 +232,7 @@ static int (__cdecl *p_event_wait_for_multiple)(event**, size_t, MSVCRT_bool, un
 
 static Context* (__cdecl *p_Context_CurrentContext)(void);
 static unsigned int (__cdecl *p_Context_Id)(void);
+static void (__cdecl *p_Context_Block)(void);
 static SchedulerPolicy* (__thiscall *p_SchedulerPolicy_ctor)(SchedulerPolicy*);
 static void (__thiscall *p_SchedulerPolicy_SetConcurrencyLimits)(SchedulerPolicy*, unsigned int, unsigned int);
 static void (__thiscall *p_SchedulerPolicy_dtor)(SchedulerPolicy*);
@@ -272,6 +282,7 @@ static BOOL init(void)
     SET(p_setlocale, "setlocale");
 
     SET(p_Context_Id, "?Id@Context@Concurrency@@SAIXZ");
+    SET(p_Context_Block, "?Block@Context@Concurrency@@SAXXZ");
     SET(p_CurrentScheduler_Detach, "?Detach@CurrentScheduler@Concurrency@@SAXXZ");
     SET(p_CurrentScheduler_Id, "?Id@CurrentScheduler@Concurrency@@SAIXZ");
 
@@ -942,6 +953,33 @@ static void test_ExternalContextBase(void)
     CloseHandle(thread);
 }
 
+static LONG scheduled_tasks;
+static HANDLE scheduled_tasks_done;
+
+static void __cdecl scheduled_task_proc(void *arg)
+{
+    ok(arg == &scheduled_tasks, "arg = %p\n", arg);
+    if(!InterlockedDecrement(&scheduled_tasks))
+        SetEvent(scheduled_tasks_done);
+}
+
+static void __cdecl unblock_task_proc(void *arg)
+{
+    Context *ctx = arg;
+    call_func1(ctx->vtable->Unblock, ctx);
+}
+
+static void __cdecl block_task_proc(void *arg)
+{
+    Scheduler *scheduler = arg;
+    Context *ctx = p_Context_CurrentContext();
+
+    /* the task can only run while this one is blocked */
+    call_func3(scheduler->vtable->ScheduleTask, scheduler, unblock_task_proc, ctx);
+    p_Context_Block();
+    SetEvent(scheduled_tasks_done);
+}
+
 static void test_Scheduler(void)
 {
     Scheduler *scheduler, *current_scheduler;
@@ -971,6 +1009,19 @@ static void test_Scheduler(void)
 
     i = call_func1(scheduler->vtable->GetNumberOfVirtualProcessors, scheduler);
     ok(i == 1, "Scheduler::GetNumberOfVirtualProcessors() = %u\n", i);
+
+    scheduled_tasks = 100;
+    scheduled_tasks_done = CreateEventW(NULL, FALSE, FALSE, NULL);
+    for(i=0; i<100; i++)
+        call_func3(scheduler->vtable->ScheduleTask, scheduler, scheduled_task_proc, &scheduled_tasks);
+    i = WaitForSingleObject(scheduled_tasks_done, 5000);
+    ok(i == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", i);
+    ok(!scheduled_tasks, "%d tasks were not run\n", scheduled_tasks);
+
+    call_func3(scheduler->vtable->ScheduleTask, scheduler, block_task_proc, scheduler);
+    i = WaitForSingleObject(scheduled_tasks_done, 5000);
+    ok(i == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", i);
+    CloseHandle(scheduled_tasks_done);
     call_func1(scheduler->vtable->Release, scheduler);
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
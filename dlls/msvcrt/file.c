@@ -2811,15 +2811,32 @@ static int read_i(int fd, ioinfo *fdinfo, void *buf, unsigned int count)
         }
         else if (fdinfo->wxflag & WX_TEXT)
         {
-            DWORD i, j;
+            DWORD i, j, eof = num_read;
+            char *p;
 
             if (bufstart[0]=='\n' && (!utf16 || bufstart[1]==0))
                 fdinfo->wxflag |= WX_READNL;
             else
                 fdinfo->wxflag &= ~WX_READNL;
 
+            if (!utf16 && (p = memchr(bufstart, 0x1a, num_read)))
+                eof = p - bufstart;
+
             for (i=0, j=0; i<num_read; i+=1+utf16)
             {
+                /* move runs of characters without \r or ^Z at once */
+                if (!utf16 && i<eof && bufstart[i]!='\r')
+                {
+                    DWORD len;
+
+                    p = memchr(bufstart+i, '\r', eof-i);
+                    len = (p ? p-bufstart : eof) - i;
+                    if (j != i) memmove(bufstart+j, bufstart+i, len);
+                    j += len;
+                    i += len-1;
+                    continue;
+                }
+
                 /* in text mode, a ctrl-z signals EOF */
                 if (bufstart[i]==0x1a && (!utf16 || bufstart[i+1]==0))
                 {
@@ -3486,20 +3503,32 @@ int CDECL MSVCRT__write(int fd, const void* buf, unsigned int count)
 
         if (!(info->exflag & (EF_UTF8|EF_UTF16)))
         {
+            const char *lf;
+
             /* find number of \n */
-            for (nr_lf=0, i=0; i<count; i++)
-                if (s[i] == '\n')
-                    nr_lf++;
+            for (nr_lf=0, lf=s; (lf = memchr(lf, '\n', s+count-lf)); lf++)
+                nr_lf++;
             if (nr_lf)
             {
                 size = count+nr_lf;
                 if ((q = p = MSVCRT_malloc(size)))
                 {
-                    for (s = buf, i = 0, j = 0; i < count; i++)
+                    /* copy whole lines at once, prepending \r to every \n */
+                    for (s = buf, i = 0, j = 0; i < count; )
                     {
-                        if (s[i] == '\n')
+                        unsigned int len;
+
+                        lf = memchr(s+i, '\n', count-i);
+                        len = lf ? lf-s-i : count-i;
+                        memcpy(p+j, s+i, len);
+                        i += len;
+                        j += len;
+                        if (lf)
+                        {
                             p[j++] = '\r';
-                        p[j++] = s[i];
+                            p[j++] = '\n';
+                            i++;
+                        }
                     }
                 }
                 else
@@ -24,6 +24,7 @@
 #include "msvcrt.h"
 #include "mtdll.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
 
@@ -52,8 +53,236 @@ static unsigned int MSVCRT_amblksiz = 16;
 /* FIXME - According to documentation it should be 480 bytes, at runtime default is 0 */
 static MSVCRT_size_t MSVCRT_sbh_threshold = 0;
 
+/* Freed blocks of up to HEAP_CACHE_MAX_SIZE bytes are kept in a per-thread
+ * cache, with a separate list for every block size, and are handed out again
+ * without taking the heap lock. Blocks are reused only for allocations of
+ * exactly the same size so that _msize keeps returning the requested size.
+ * The cache is only used if the WINE_MSVCRT_HEAP_CACHE environment variable
+ * is set to 1. */
+#define HEAP_CACHE_MAX_SIZE   256
+#define HEAP_CACHE_MAX_BLOCKS 16
+#define HEAP_CACHE_MAX_BYTES  (64 * 1024)
+#define HEAP_CACHE_RECENT     256
+#define HEAP_CACHE_BUSY       ((void*)1)
+
+static BOOL use_heap_cache;
+
+struct heap_cache
+{
+    CRITICAL_SECTION cs;
+    struct list entry;
+    void *blocks[HEAP_CACHE_MAX_SIZE + 1];
+    BYTE count[HEAP_CACHE_MAX_SIZE + 1];
+    MSVCRT_size_t bytes;
+};
+
+/* Recently allocated blocks and their size, so that freeing a block doesn't
+ * need HeapSize. The table is shared by all threads: every allocation
+ * replaces or clears the entry for its address, so the entry of a block that
+ * was freed by another thread can't outlive it. A writer claims an entry by
+ * setting ptr to HEAP_CACHE_BUSY. */
+static struct
+{
+    void * volatile ptr;
+    MSVCRT_size_t size;
+} heap_cache_recent[HEAP_CACHE_RECENT];
+
+static struct list heap_caches = LIST_INIT(heap_caches);
+
+static CRITICAL_SECTION heap_caches_cs;
+static CRITICAL_SECTION_DEBUG heap_caches_cs_debug =
+{
+    0, 0, &heap_caches_cs,
+    { &heap_caches_cs_debug.ProcessLocksList, &heap_caches_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": heap_caches_cs") }
+};
+static CRITICAL_SECTION heap_caches_cs = { &heap_caches_cs_debug, -1, 0, 0, 0, 0 };
+
+static inline BOOL heap_cache_enabled(void)
+{
+    return use_heap_cache && !sb_heap;
+}
+
+static inline BOOL is_cached_size(MSVCRT_size_t size)
+{
+    return size >= sizeof(void*) && size <= HEAP_CACHE_MAX_SIZE && heap_cache_enabled();
+}
+
+static inline unsigned int heap_cache_recent_idx(void *ptr)
+{
+    return ((ULONG_PTR)ptr / 16) % HEAP_CACHE_RECENT;
+}
+
+static void heap_cache_set_recent(void *ptr, MSVCRT_size_t size)
+{
+    unsigned int idx = heap_cache_recent_idx(ptr);
+    void *old = heap_cache_recent[idx].ptr;
+
+    /* if another thread is writing the entry, it replaces any stale one */
+    if(old == HEAP_CACHE_BUSY || InterlockedCompareExchangePointer(
+                (void**)&heap_cache_recent[idx].ptr, HEAP_CACHE_BUSY, old) != old)
+        return;
+    heap_cache_recent[idx].size = size;
+    InterlockedExchangePointer((void**)&heap_cache_recent[idx].ptr, ptr);
+}
+
+static void heap_cache_clear_recent(void *ptr)
+{
+    unsigned int idx = heap_cache_recent_idx(ptr);
+
+    if(heap_cache_recent[idx].ptr == ptr)
+        InterlockedCompareExchangePointer((void**)&heap_cache_recent[idx].ptr, NULL, ptr);
+}
+
+/* returns the size of a recently allocated block and removes its entry */
+static BOOL heap_cache_take_recent(void *ptr, MSVCRT_size_t *size)
+{
+    unsigned int idx = heap_cache_recent_idx(ptr);
+
+    if(heap_cache_recent[idx].ptr != ptr)
+        return FALSE;
+    *size = heap_cache_recent[idx].size;
+    return InterlockedCompareExchangePointer((void**)&heap_cache_recent[idx].ptr, NULL, ptr) == ptr;
+}
+
+/* don't create thread data here, the heap may be used on thread exit */
+static struct heap_cache* heap_cache_get(BOOL create)
+{
+    struct heap_cache *cache;
+    thread_data_t *data;
+    DWORD err;
+
+    err = GetLastError();
+    data = TlsGetValue(msvcrt_tls_index);
+    SetLastError(err);
+    if(!data)
+        return NULL;
+    if(data->heap_cache || !create)
+        return data->heap_cache;
+
+    cache = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*cache));
+    if(!cache)
+        return NULL;
+    InitializeCriticalSection(&cache->cs);
+    cache->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": heap_cache.cs");
+
+    EnterCriticalSection(&heap_caches_cs);
+    list_add_head(&heap_caches, &cache->entry);
+    LeaveCriticalSection(&heap_caches_cs);
+
+    data->heap_cache = cache;
+    return cache;
+}
+
+static void* heap_cache_alloc(DWORD flags, MSVCRT_size_t size)
+{
+    struct heap_cache *cache = heap_cache_get(TRUE);
+    void *ret = NULL;
+
+    if(cache) {
+        EnterCriticalSection(&cache->cs);
+        if((ret = cache->blocks[size])) {
+            cache->blocks[size] = *(void**)ret;
+            cache->count[size]--;
+            cache->bytes -= size;
+        }
+        LeaveCriticalSection(&cache->cs);
+    }
+
+    if(ret) {
+        if(flags & HEAP_ZERO_MEMORY)
+            memset(ret, 0, size);
+    }else if(!(ret = HeapAlloc(heap, flags, size))) {
+        return NULL;
+    }
+
+    heap_cache_set_recent(ret, size);
+    return ret;
+}
+
+static BOOL heap_cache_free(void *ptr)
+{
+    struct heap_cache *cache = heap_cache_get(FALSE);
+    MSVCRT_size_t size;
+    BOOL ret = FALSE;
+
+    if(!heap_cache_take_recent(ptr, &size) || !cache)
+        return FALSE;
+
+    if(WARN_ON(msvcrt) && HeapSize(heap, 0, ptr) != size) {
+        ERR("block %p has size %ld, expected %ld\n", ptr, HeapSize(heap, 0, ptr), size);
+        return FALSE;
+    }
+
+    EnterCriticalSection(&cache->cs);
+    if(cache->count[size] < HEAP_CACHE_MAX_BLOCKS
+            && cache->bytes + size <= HEAP_CACHE_MAX_BYTES) {
+        *(void**)ptr = cache->blocks[size];
+        cache->blocks[size] = ptr;
+        cache->count[size]++;
+        cache->bytes += size;
+        ret = TRUE;
+    }
+    LeaveCriticalSection(&cache->cs);
+    return ret;
+}
+
+/* must be called with cache->cs held */
+static void heap_cache_flush(struct heap_cache *cache)
+{
+    void *block, *next;
+    int i;
+
+    for(i=0; i<=HEAP_CACHE_MAX_SIZE; i++) {
+        for(block=cache->blocks[i]; block; block=next) {
+            next = *(void**)block;
+            HeapFree(heap, 0, block);
+        }
+        cache->blocks[i] = NULL;
+        cache->count[i] = 0;
+    }
+    cache->bytes = 0;
+}
+
+/* returns blocks cached by all threads to the heap */
+static void heap_cache_flush_all(void)
+{
+    struct heap_cache *cache;
+
+    EnterCriticalSection(&heap_caches_cs);
+    LIST_FOR_EACH_ENTRY(cache, &heap_caches, struct heap_cache, entry) {
+        EnterCriticalSection(&cache->cs);
+        heap_cache_flush(cache);
+        LeaveCriticalSection(&cache->cs);
+    }
+    LeaveCriticalSection(&heap_caches_cs);
+}
+
+void msvcrt_free_heap_cache(thread_data_t *data)
+{
+    struct heap_cache *cache = data->heap_cache;
+
+    if(!cache)
+        return;
+
+    EnterCriticalSection(&heap_caches_cs);
+    list_remove(&cache->entry);
+    LeaveCriticalSection(&heap_caches_cs);
+
+    heap_cache_flush(cache);
+    cache->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&cache->cs);
+    HeapFree(GetProcessHeap(), 0, cache);
+    data->heap_cache = NULL;
+}
+
 static void* msvcrt_heap_alloc(DWORD flags, MSVCRT_size_t size)
 {
+    void *ret;
+
+    if(is_cached_size(size))
+        return heap_cache_alloc(flags, size);
+
     if(size < MSVCRT_sbh_threshold)
     {
         void *memblock, *temp, **saved;
@@ -67,11 +296,16 @@ static void* msvcrt_heap_alloc(DWORD flags, MSVCRT_size_t size)
         return memblock;
     }
 
-    return HeapAlloc(heap, flags, size);
+    ret = HeapAlloc(heap, flags, size);
+    if(ret && heap_cache_enabled())
+        heap_cache_clear_recent(ret);
+    return ret;
 }
 
 static void* msvcrt_heap_realloc(DWORD flags, void *ptr, MSVCRT_size_t size)
 {
+    void *ret;
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         /* TODO: move data to normal heap if it exceeds sbh_threshold limit */
@@ -99,11 +333,19 @@ static void* msvcrt_heap_realloc(DWORD flags, void *ptr, MSVCRT_size_t size)
         return memblock;
     }
 
-    return HeapReAlloc(heap, flags, ptr, size);
+    if(ptr && heap_cache_enabled())
+        heap_cache_clear_recent(ptr);
+    ret = HeapReAlloc(heap, flags, ptr, size);
+    if(ret && heap_cache_enabled())
+        heap_cache_clear_recent(ret);
+    return ret;
 }
 
 static BOOL msvcrt_heap_free(void *ptr)
 {
+    if(ptr && heap_cache_enabled() && heap_cache_free(ptr))
+        return TRUE;
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         void **saved = SAVED_PTR(ptr);
@@ -268,6 +510,8 @@ int CDECL _heapchk(void)
  */
 int CDECL _heapmin(void)
 {
+  heap_cache_flush_all();
+
   if (!HeapCompact( heap, 0 ) ||
           (sb_heap && !HeapCompact( sb_heap, 0 )))
   {
@@ -288,6 +532,10 @@ int CDECL _heapwalk(struct MSVCRT__heapinfo* next)
   if (sb_heap)
       FIXME("small blocks heap not supported\n");
 
+  /* report blocks kept in the per-thread caches as free */
+  if (!next->_pentry)
+      heap_cache_flush_all();
+
   LOCK_HEAP;
   phe.lpData = next->_pentry;
   phe.cbData = next->_size;
@@ -870,6 +1118,11 @@ int CDECL MSVCRT_strncpy_s(char *dest, MSVCRT_size_t numberOfElements,
 
 BOOL msvcrt_init_heap(void)
 {
+    char value[2];
+
+    if(GetEnvironmentVariableA("WINE_MSVCRT_HEAP_CACHE", value, sizeof(value)) == 1 && value[0] == '1')
+        use_heap_cache = TRUE;
+
     heap = HeapCreate(0, 0, 0);
     return heap != NULL;
 }
@@ -79,6 +79,9 @@ static inline void msvcrt_free_tls_mem(void)
         free_locinfo(tls->locinfo);
         free_mbcinfo(tls->mbcinfo);
     }
+    /* the heap may still be used on thread exit, e.g. by DLLs detached later */
+    TlsSetValue(msvcrt_tls_index, NULL);
+    msvcrt_free_heap_cache(tls);
   }
   HeapFree(GetProcessHeap(), 0, tls);
 }
@@ -275,6 +275,8 @@ float CDECL MSVCRT_coshf( float x )
 float CDECL MSVCRT_expf( float x )
 {
   float ret = expf(x);
+  /* a finite non-zero result can't be an error */
+  if (finitef(ret) && ret) return ret;
   if (isnanf(x)) math_error(_DOMAIN, "expf", x, 0, ret);
   else if (finitef(x) && !ret) math_error(_UNDERFLOW, "expf", x, 0, ret);
   else if (finitef(x) && !finitef(ret)) math_error(_OVERFLOW, "expf", x, 0, ret);
@@ -319,6 +321,9 @@ float CDECL MSVCRT_log10f( float x )
 float CDECL MSVCRT_powf( float x, float y )
 {
   float z = powf(x,y);
+  /* domain and singularity errors give NaN or infinity, overflow and underflow
+   * give infinity or zero, so a finite non-zero result is never an error */
+  if (finitef(z) && z) return z;
   if (x < 0 && y != floorf(y)) math_error(_DOMAIN, "powf", x, y, z);
   else if (!x && finitef(y) && y < 0) math_error(_SING, "powf", x, y, z);
   else if (finitef(x) && finitef(y) && !finitef(z)) math_error(_OVERFLOW, "powf", x, y, z);
@@ -489,6 +494,8 @@ double CDECL MSVCRT_cosh( double x )
 double CDECL MSVCRT_exp( double x )
 {
   double ret = exp(x);
+  /* a finite non-zero result can't be an error */
+  if (isfinite(ret) && ret) return ret;
   if (isnan(x)) math_error(_DOMAIN, "exp", x, 0, ret);
   else if (isfinite(x) && !ret) math_error(_UNDERFLOW, "exp", x, 0, ret);
   else if (isfinite(x) && !isfinite(ret)) math_error(_OVERFLOW, "exp", x, 0, ret);
@@ -533,6 +540,9 @@ double CDECL MSVCRT_log10( double x )
 double CDECL MSVCRT_pow( double x, double y )
 {
   double z = pow(x,y);
+  /* domain and singularity errors give NaN or infinity, overflow and underflow
+   * give infinity or zero, so a finite non-zero result is never an error */
+  if (isfinite(z) && z) return z;
   if (x < 0 && y != floor(y)) math_error(_DOMAIN, "pow", x, y, z);
   else if (!x && isfinite(y) && y < 0) math_error(_SING, "pow", x, y, z);
   else if (isfinite(x) && isfinite(y) && !isfinite(z)) math_error(_OVERFLOW, "pow", x, y, z);
@@ -257,8 +257,28 @@ void CDECL _chkesp(void)
 
 static inline void swap(char *l, char *r, MSVCRT_size_t size)
 {
+    UINT64 tmp64;
+    UINT32 tmp32;
     char tmp;
 
+    /* elements don't have to be aligned, memcpy with a constant size
+     * is turned into plain loads and stores by the compiler */
+    while(size >= sizeof(tmp64)) {
+        memcpy(&tmp64, l, sizeof(tmp64));
+        memcpy(l, r, sizeof(tmp64));
+        memcpy(r, &tmp64, sizeof(tmp64));
+        l += sizeof(tmp64);
+        r += sizeof(tmp64);
+        size -= sizeof(tmp64);
+    }
+    if(size >= sizeof(tmp32)) {
+        memcpy(&tmp32, l, sizeof(tmp32));
+        memcpy(l, r, sizeof(tmp32));
+        memcpy(r, &tmp32, sizeof(tmp32));
+        l += sizeof(tmp32);
+        r += sizeof(tmp32);
+        size -= sizeof(tmp32);
+    }
     while(size--) {
         tmp = *l;
         *l++ = *r;
@@ -285,20 +305,71 @@ static void small_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
     }
 }
 
+static void sift_down(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context,
+        MSVCRT_size_t cur)
+{
+    MSVCRT_size_t c;
+
+#define X(i) ((char*)base+size*(i))
+    while((c = 2*cur+1) < nmemb) {
+        if(c+1 < nmemb && compar(context, X(c+1), X(c)) > 0)
+            c++;
+        if(compar(context, X(c), X(cur)) <= 0)
+            break;
+        swap(X(c), X(cur), size);
+        cur = c;
+    }
+#undef X
+}
+
+static void heap_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    MSVCRT_size_t i;
+
+    for(i=nmemb/2; i>0; i--)
+        sift_down(base, nmemb, size, compar, context, i-1);
+
+    for(i=nmemb-1; i>0; i--) {
+        swap(base, (char*)base+size*i, size);
+        sift_down(base, i, size, compar, context, 0);
+    }
+}
+
+static inline void sort3(char *a, char *b, char *c, MSVCRT_size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    if(compar(context, a, b) > 0)
+        swap(a, b, size);
+    if(compar(context, a, c) > 0)
+        swap(a, c, size);
+    if(compar(context, b, c) > 0)
+        swap(b, c, size);
+}
+
 static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
         int (CDECL *compar)(void *, const void *, const void *), void *context)
 {
     MSVCRT_size_t stack_lo[8*sizeof(MSVCRT_size_t)], stack_hi[8*sizeof(MSVCRT_size_t)];
-    MSVCRT_size_t beg, end, lo, hi, med;
+    unsigned int stack_depth[8*sizeof(MSVCRT_size_t)];
+    MSVCRT_size_t beg, end, lo, hi, med, n;
+    unsigned int depth;
     int stack_pos;
 
     stack_pos = 0;
     stack_lo[stack_pos] = 0;
     stack_hi[stack_pos] = nmemb-1;
 
+    /* fall back to heap sort after 2*log2(nmemb) bad partitions */
+    stack_depth[stack_pos] = 0;
+    for(n=nmemb; n>1; n>>=1)
+        stack_depth[stack_pos] += 2;
+
 #define X(i) ((char*)base+size*(i))
     while(stack_pos >= 0) {
         beg = stack_lo[stack_pos];
+        depth = stack_depth[stack_pos];
         end = stack_hi[stack_pos--];
 
         if(end-beg < 8) {
@@ -306,9 +377,22 @@ static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
             continue;
         }
 
+        if(!depth) {
+            heap_sort(X(beg), end-beg+1, size, compar, context);
+            continue;
+        }
+        depth--;
+
         lo = beg;
         hi = end;
         med = lo + (hi-lo+1)/2;
+        if(hi-lo >= 128) {
+            /* use the median of three medians (ninther) on big partitions */
+            n = (hi-lo+1)/8;
+            sort3(X(lo+n), X(lo), X(lo+2*n), size, compar, context);
+            sort3(X(med-n), X(med), X(med+n), size, compar, context);
+            sort3(X(hi-2*n), X(hi), X(hi-n), size, compar, context);
+        }
         if(compar(context, X(lo), X(med)) > 0)
             swap(X(lo), X(med), size);
         if(compar(context, X(lo), X(hi)) > 0)
@@ -350,13 +434,17 @@ static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
         if(hi-beg >= end-lo) {
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
         }else {
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
         }
     }
 #undef X
@@ -272,6 +272,7 @@ struct __thread_data {
 #if _MSVCR_VER >= 140
     MSVCRT_invalid_parameter_handler invalid_parameter_handler;
 #endif
+    struct heap_cache              *heap_cache;         /* freed small blocks kept for reuse */
 };
 
 typedef struct __thread_data thread_data_t;
@@ -343,6 +344,7 @@ extern void msvcrt_free_signals(void) DECLSPEC_HIDDEN;
 extern void msvcrt_free_popen_data(void) DECLSPEC_HIDDEN;
 extern BOOL msvcrt_init_heap(void) DECLSPEC_HIDDEN;
 extern void msvcrt_destroy_heap(void) DECLSPEC_HIDDEN;
+extern void msvcrt_free_heap_cache(thread_data_t*) DECLSPEC_HIDDEN;
 
 #if _MSVCR_VER >= 100
 extern void msvcrt_init_scheduler(void*) DECLSPEC_HIDDEN;
@@ -1092,6 +1094,7 @@ void __cdecl MSVCRT__free_locale(MSVCRT__locale_t);
 void free_locinfo(MSVCRT_pthreadlocinfo) DECLSPEC_HIDDEN;
 void free_mbcinfo(MSVCRT_pthreadmbcinfo) DECLSPEC_HIDDEN;
 int _setmbcp_l(int, LCID, MSVCRT_pthreadmbcinfo) DECLSPEC_HIDDEN;
+BOOL msvcrt_exact_pow10(unsigned __int64, int, double*) DECLSPEC_HIDDEN;
 
 #ifndef __WINE_MSVCRT_TEST
 int            __cdecl MSVCRT__write(int,const void*,unsigned int);
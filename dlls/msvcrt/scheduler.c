@@ -25,6 +25,7 @@
 #include "windef.h"
 #include "winternl.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "msvcrt.h"
 #include "cppexcept.h"
 #include "cxx.h"
@@ -115,6 +116,9 @@ typedef struct {
     struct scheduler_list scheduler;
     unsigned int id;
     union allocator_cache_entry *allocator_cache[8];
+    LONG blocked;
+    HANDLE blocked_event;
+    struct Scheduler *worker_scheduler;
 } ExternalContextBase;
 extern const vtable_ptr MSVCRT_ExternalContextBase_vtable;
 static void ExternalContextBase_ctor(ExternalContextBase*);
@@ -156,9 +160,26 @@ typedef struct {
     int shutdown_size;
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
+    struct list tasks;
+    unsigned int task_count;
+    unsigned int workers;
+    unsigned int idle_workers;
+    unsigned int blocked_workers;
+    unsigned int min_workers;
+    BOOL released;
+    CONDITION_VARIABLE tasks_cv;
 } ThreadScheduler;
 extern const vtable_ptr MSVCRT_ThreadScheduler_vtable;
 
+struct scheduled_task {
+    struct list entry;
+    void (__cdecl *proc)(void*);
+    void *data;
+};
+
+/* how long an idle worker thread waits for new tasks before exiting */
+#define SCHEDULER_WORKER_IDLE_TIMEOUT 5000
+
 typedef struct {
     Scheduler *scheduler;
 } _Scheduler;
@@ -181,6 +202,7 @@ static SchedulerPolicy default_scheduler_policy;
 static ThreadScheduler *default_scheduler;
 
 static void create_default_scheduler(void);
+static void ThreadScheduler_worker_blocked(ThreadScheduler*, BOOL);
 
 static Context* try_get_current_context(void)
 {
@@ -256,22 +278,62 @@ unsigned int __cdecl Context_Id(void)
     return ctx ? call_Context_GetId(ctx) : -1;
 }
 
+static HANDLE ExternalContextBase_get_blocked_event(ExternalContextBase *this)
+{
+    HANDLE event;
+
+    if (this->blocked_event)
+        return this->blocked_event;
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!event) {
+        throw_exception(EXCEPTION_SCHEDULER_RESOURCE_ALLOCATION_ERROR,
+                HRESULT_FROM_WIN32(GetLastError()), NULL);
+        return NULL;
+    }
+
+    if (InterlockedCompareExchangePointer(&this->blocked_event, event, NULL))
+        CloseHandle(event);
+    return this->blocked_event;
+}
+
 /* ?Block@Context@Concurrency@@SAXXZ */
 void __cdecl Context_Block(void)
 {
-    FIXME("()\n");
+    ExternalContextBase *context = (ExternalContextBase*)get_current_context();
+    HANDLE event;
+
+    TRACE("()\n");
+
+    if (context->context.vtable != &MSVCRT_ExternalContextBase_vtable) {
+        ERR("unknown context set\n");
+        return;
+    }
+
+    /* the event has to exist before a concurrent Unblock can see us blocked */
+    event = ExternalContextBase_get_blocked_event(context);
+    if (InterlockedDecrement(&context->blocked) >= 0)
+        return;
+
+    if (context->worker_scheduler)
+        ThreadScheduler_worker_blocked((ThreadScheduler*)context->worker_scheduler, TRUE);
+    WaitForSingleObject(event, INFINITE);
+    if (context->worker_scheduler)
+        ThreadScheduler_worker_blocked((ThreadScheduler*)context->worker_scheduler, FALSE);
 }
 
 /* ?Yield@Context@Concurrency@@SAXXZ */
 void __cdecl Context_Yield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    SwitchToThread();
 }
 
 /* ?_SpinYield@Context@Concurrency@@SAXXZ */
 void __cdecl Context__SpinYield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    Sleep(0);
 }
 
 /* ?IsCurrentTaskCollectionCanceling@Context@Concurrency@@SA_NXZ */
@@ -327,14 +389,17 @@ unsigned int __thiscall ExternalContextBase_GetScheduleGroupId(const ExternalCon
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Unblock, 4)
 void __thiscall ExternalContextBase_Unblock(ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
+    TRACE("(%p)->()\n", this);
+
+    if (InterlockedIncrement(&this->blocked) <= 0)
+        SetEvent(this->blocked_event);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_IsSynchronouslyBlocked, 4)
 MSVCRT_bool __thiscall ExternalContextBase_IsSynchronouslyBlocked(const ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
-    return FALSE;
+    TRACE("(%p)->()\n", this);
+    return this->blocked < 0;
 }
 
 static void ExternalContextBase_dtor(ExternalContextBase *this)
@@ -360,6 +425,9 @@ static void ExternalContextBase_dtor(ExternalContextBase *this)
             MSVCRT_operator_delete(scheduler_cur);
         }
     }
+
+    if (this->blocked_event)
+        CloseHandle(this->blocked_event);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_vector_dtor, 8)
@@ -625,11 +693,18 @@ void __thiscall SchedulerPolicy_dtor(SchedulerPolicy *this)
 
 static void ThreadScheduler_dtor(ThreadScheduler *this)
 {
+    struct scheduled_task *task, *next;
     int i;
 
     if(this->ref != 0) WARN("ref = %d\n", this->ref);
     SchedulerPolicy_dtor(&this->policy);
 
+    LIST_FOR_EACH_ENTRY_SAFE(task, next, &this->tasks, struct scheduled_task, entry) {
+        WARN("dropping task %p\n", task);
+        list_remove(&task->entry);
+        MSVCRT_operator_delete(task);
+    }
+
     for(i=0; i<this->shutdown_count; i++)
         SetEvent(this->shutdown_events[i]);
     MSVCRT_operator_delete(this->shutdown_events);
@@ -675,6 +750,16 @@ unsigned int __thiscall ThreadScheduler_Release(ThreadScheduler *this)
     TRACE("(%p)\n", this);
 
     if(!ret) {
+        EnterCriticalSection(&this->cs);
+        if(this->workers) {
+            /* the last worker thread to exit destroys the scheduler */
+            this->released = TRUE;
+            WakeAllConditionVariable(&this->tasks_cv);
+            LeaveCriticalSection(&this->cs);
+            return ret;
+        }
+        LeaveCriticalSection(&this->cs);
+
         ThreadScheduler_dtor(this);
         MSVCRT_operator_delete(this);
     }
@@ -742,18 +827,168 @@ DEFINE_THISCALL_WRAPPER(ThreadScheduler_CreateScheduleGroup, 4)
     return NULL;
 }
 
-DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
-void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
-        void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
+/* Worker threads don't hold a reference to the scheduler, they exit once
+ * the scheduler is released and the last one destroys it. */
+static DWORD WINAPI ThreadScheduler_worker_proc(void *arg)
+{
+    ThreadScheduler *this = arg;
+    ExternalContextBase *context;
+    struct scheduled_task *task;
+    struct scheduler_list *entry = NULL;
+    HMODULE module;
+    BOOL destroy;
+
+    TRACE("(%p) worker started\n", this);
+
+    /* the module was pinned by ThreadScheduler_start_worker */
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (const WCHAR*)ThreadScheduler_worker_proc, &module);
+
+    context = (ExternalContextBase*)get_current_context();
+    if(context->scheduler.scheduler != &this->scheduler) {
+        entry = MSVCRT_operator_new(sizeof(*entry));
+        *entry = context->scheduler;
+        context->scheduler.scheduler = &this->scheduler;
+        context->scheduler.next = entry;
+    }
+    context->worker_scheduler = &this->scheduler;
+
+    EnterCriticalSection(&this->cs);
+    for(;;) {
+        if(!list_empty(&this->tasks)) {
+            task = LIST_ENTRY(list_head(&this->tasks), struct scheduled_task, entry);
+            list_remove(&task->entry);
+            this->task_count--;
+            LeaveCriticalSection(&this->cs);
+
+            TRACE("(%p) running %p(%p)\n", this, task->proc, task->data);
+            task->proc(task->data);
+            MSVCRT_operator_delete(task);
+
+            EnterCriticalSection(&this->cs);
+            continue;
+        }
+
+        if(this->released)
+            break;
+
+        /* keep MinConcurrency workers around until the scheduler is released */
+        this->idle_workers++;
+        if(!SleepConditionVariableCS(&this->tasks_cv, &this->cs, SCHEDULER_WORKER_IDLE_TIMEOUT)
+                && list_empty(&this->tasks) && this->workers > this->min_workers) {
+            this->idle_workers--;
+            break;
+        }
+        this->idle_workers--;
+    }
+    this->workers--;
+    destroy = this->released && !this->workers;
+    LeaveCriticalSection(&this->cs);
+
+    TRACE("(%p) worker exiting\n", this);
+
+    context->worker_scheduler = NULL;
+    if(entry) {
+        entry = context->scheduler.next;
+        context->scheduler = *entry;
+        MSVCRT_operator_delete(entry);
+    }
+
+    if(destroy) {
+        ThreadScheduler_dtor(this);
+        MSVCRT_operator_delete(this);
+    }
+    FreeLibraryAndExitThread(module, 0);
+    return 0;
+}
+
+/* must be called with this->cs held */
+static BOOL ThreadScheduler_start_worker(ThreadScheduler *this)
+{
+    HMODULE module;
+    HANDLE thread;
+
+    /* keep the module loaded while the worker runs */
+    if(!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                (const WCHAR*)ThreadScheduler_worker_proc, &module)) {
+        WARN("failed to reference module: %u\n", GetLastError());
+        return FALSE;
+    }
+
+    thread = CreateThread(NULL, 0, ThreadScheduler_worker_proc, this, 0, NULL);
+    if(!thread) {
+        WARN("failed to create worker thread: %u\n", GetLastError());
+        FreeLibrary(module);
+        return FALSE;
+    }
+    CloseHandle(thread);
+    this->workers++;
+    return TRUE;
+}
+
+/* only start a new worker if the idle and running ones can't keep up */
+static inline BOOL ThreadScheduler_needs_worker(const ThreadScheduler *this)
 {
-    FIXME("(%p %p %p %p) stub\n", this, proc, data, placement);
+    return this->task_count > this->idle_workers
+        && this->workers - this->blocked_workers < this->virt_proc_no;
+}
+
+static void ThreadScheduler_worker_blocked(ThreadScheduler *this, BOOL blocked)
+{
+    EnterCriticalSection(&this->cs);
+    if(blocked) {
+        /* let another worker run the queued tasks while this one waits */
+        this->blocked_workers++;
+        if(ThreadScheduler_needs_worker(this))
+            ThreadScheduler_start_worker(this);
+    }else {
+        this->blocked_workers--;
+    }
+    LeaveCriticalSection(&this->cs);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask, 12)
 void __thiscall ThreadScheduler_ScheduleTask(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data)
 {
-    FIXME("(%p %p %p) stub\n", this, proc, data);
+    struct scheduled_task *task;
+    BOOL run_inline = FALSE;
+
+    TRACE("(%p %p %p)\n", this, proc, data);
+
+    task = MSVCRT_operator_new(sizeof(*task));
+    task->proc = proc;
+    task->data = data;
+
+    EnterCriticalSection(&this->cs);
+    list_add_tail(&this->tasks, &task->entry);
+    this->task_count++;
+
+    if(this->idle_workers)
+        WakeConditionVariable(&this->tasks_cv);
+
+    if(ThreadScheduler_needs_worker(this) && !ThreadScheduler_start_worker(this)
+            && this->workers == this->blocked_workers) {
+        list_remove(&task->entry);
+        this->task_count--;
+        run_inline = TRUE;
+    }
+    LeaveCriticalSection(&this->cs);
+
+    if(run_inline) {
+        proc(data);
+        MSVCRT_operator_delete(task);
+    }
+}
+
+DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
+void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
+        void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
+{
+    TRACE("(%p %p %p %p)\n", this, proc, data, placement);
+
+    /* all virtual processors are equivalent, placement is only a hint */
+    ThreadScheduler_ScheduleTask(this, proc, data);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_IsAvailableLocation, 8)
@@ -804,6 +1039,14 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
     this->shutdown_count = this->shutdown_size = 0;
     this->shutdown_events = NULL;
 
+    list_init(&this->tasks);
+    this->task_count = this->workers = this->idle_workers = this->blocked_workers = 0;
+    this->min_workers = SchedulerPolicy_GetPolicyValue(&this->policy, MinConcurrency);
+    if(this->min_workers > this->virt_proc_no)
+        this->min_workers = this->virt_proc_no;
+    this->released = FALSE;
+    InitializeConditionVariable(&this->tasks_cv);
+
     InitializeCriticalSection(&this->cs);
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
     return this;
@@ -325,6 +325,45 @@ void CDECL MSVCRT__swab(char* src, char* dst, int len)
   }
 }
 
+/* Computes d*10^exp if it can be done with a single correctly rounded
+ * floating point operation: both d and 10^exp need to be exactly
+ * representable as doubles (Clinger's fast path). Changes the x87
+ * precision control, callers are expected to restore the control word. */
+BOOL msvcrt_exact_pow10(unsigned __int64 d, int exp, double *ret)
+{
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const unsigned __int64 max_mantissa = (unsigned __int64)1 << 53;
+
+    if(!d) {
+        *ret = 0.0;
+        return TRUE;
+    }
+
+    /* 10^15 < 2^53 < 10^16, so at most 15 powers of ten fit in the mantissa */
+    if(d >= max_mantissa || exp < -22 || exp > 22+15)
+        return FALSE;
+
+    /* move the excess exponent to the mantissa as long as it stays exact */
+    for(; exp > 22; exp--) {
+        if(d >= max_mantissa / 10)
+            return FALSE;
+        d *= 10;
+    }
+
+#ifdef __i386__
+    /* avoid double rounding of the extended precision result */
+    _control87(MSVCRT__PC_53, MSVCRT__MCW_PC);
+#endif
+    if(exp < 0)
+        *ret = (double)d / pow10[-exp];
+    else
+        *ret = (double)d * pow10[exp];
+    return TRUE;
+}
+
 static double strtod_helper(const char *str, char **end, MSVCRT__locale_t locale, int *err)
 {
     MSVCRT_pthreadlocinfo locinfo;
@@ -475,16 +514,20 @@ static double strtod_helper(const char *str, char **end, MSVCRT__locale_t locale
     _control87(MSVCRT__EM_DENORMAL|MSVCRT__EM_INVALID|MSVCRT__EM_ZERODIVIDE
             |MSVCRT__EM_OVERFLOW|MSVCRT__EM_UNDERFLOW|MSVCRT__EM_INEXACT, 0xffffffff);
 
-    negexp = (exp < 0);
-    if(negexp)
-        exp = -exp;
-    while(exp) {
-        if(exp & 1)
-            lret *= expcnt;
-        exp /= 2;
-        expcnt = expcnt*expcnt;
+    if(base == 10 && msvcrt_exact_pow10(d, exp, &ret)) {
+        ret *= sign;
+    }else {
+        negexp = (exp < 0);
+        if(negexp)
+            exp = -exp;
+        while(exp) {
+            if(exp & 1)
+                lret *= expcnt;
+            exp /= 2;
+            expcnt = expcnt*expcnt;
+        }
+        ret = (long double)sign * (negexp ? d/lret : d*lret);
     }
-    ret = (long double)sign * (negexp ? d/lret : d*lret);
 
     _control87(fpcontrol, 0xffffffff);
 
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <malloc.h>
 #include <errno.h>
+#include <string.h>
 #include "wine/test.h"
 
 static void (__cdecl *p_aligned_free)(void*) = NULL;
@@ -479,6 +480,65 @@ static void test_calloc(void)
     free(ptr);
 }
 
+static void test_small_blocks(void)
+{
+    unsigned char *ptr[32];
+    _HEAPINFO hi;
+    size_t size;
+    int i, j, ret;
+
+    for(i=0; i<32; i++) {
+        ptr[i] = malloc(24);
+        ok(ptr[i] != NULL, "malloc failed\n");
+        memset(ptr[i], 0xcc, 24);
+    }
+    for(i=0; i<32; i++)
+        free(ptr[i]);
+
+    for(i=0; i<32; i++) {
+        ptr[i] = calloc(1, 24);
+        ok(ptr[i] != NULL, "calloc failed\n");
+        for(j=0; j<24; j++)
+            if(ptr[i][j]) break;
+        ok(j == 24, "ptr[%d][%d] = %x\n", i, j, ptr[i][j]);
+        size = _msize(ptr[i]);
+        ok(size == 24, "_msize returned %d\n", (int)size);
+    }
+    for(i=0; i<32; i++)
+        free(ptr[i]);
+
+    for(i=0; i<32; i++) {
+        ptr[i] = malloc(17 + i);
+        ok(ptr[i] != NULL, "malloc failed\n");
+        size = _msize(ptr[i]);
+        ok(size == 17 + i, "_msize returned %d, expected %d\n", (int)size, 17 + i);
+        free(ptr[i]);
+    }
+
+    for(i=0; i<32; i++) {
+        ptr[i] = malloc(64);
+        ok(ptr[i] != NULL, "malloc failed\n");
+        ptr[i] = realloc(ptr[i], 16);
+        ok(ptr[i] != NULL, "realloc failed\n");
+        free(ptr[i]);
+        ptr[i] = malloc(64);
+        ok(ptr[i] != NULL, "malloc failed\n");
+        size = _msize(ptr[i]);
+        ok(size == 64, "_msize returned %d\n", (int)size);
+        free(ptr[i]);
+    }
+
+    ptr[0] = malloc(24);
+    ok(ptr[0] != NULL, "malloc failed\n");
+    free(ptr[0]);
+    memset(&hi, 0, sizeof(hi));
+    while((ret = _heapwalk(&hi)) == _HEAPOK) {
+        if(hi._pentry == (int*)ptr[0] && hi._useflag == _USEDENTRY)
+            break;
+    }
+    ok(ret == _HEAPEND, "freed block reported as used (%d)\n", ret);
+}
+
 START_TEST(heap)
 {
     void *mem;
@@ -502,6 +562,7 @@ START_TEST(heap)
     free(mem);
 
     test_aligned();
+    test_small_blocks();
     test_sbheap();
     test_calloc();
 }
@@ -1878,6 +1878,22 @@ static void test__strtod(void)
     ok(almost_equal(d, 0.1e238L), "d = %lf\n", d);
     d = strtod("0.1D-4736", NULL);
     ok(almost_equal(d, 0.1e-4736L), "d = %lf\n", d);
+    d = strtod("9007199254740991", NULL);
+    ok(d == 9007199254740991.0, "d = %lf\n", d);
+    d = strtod("9007199254740992", NULL);
+    ok(d == 9007199254740992.0, "d = %lf\n", d);
+    d = strtod("1e22", NULL);
+    ok(d == 1e22, "d = %le\n", d);
+    d = strtod("1e-22", NULL);
+    ok(d == 1e-22, "d = %le\n", d);
+    d = strtod("1e23", NULL);
+    ok(almost_equal(d, 1e23), "d = %le\n", d);
+    d = strtod("1e-23", NULL);
+    ok(almost_equal(d, 1e-23), "d = %le\n", d);
+    d = strtod("0e2000000000", NULL);
+    ok(d == 0.0, "d = %lf\n", d);
+    d = strtod("-0e-2000000000", NULL);
+    ok(d == 0.0, "d = %lf\n", d);
 
     errno = 0xdeadbeef;
     strtod(overflow, &end);
@@ -3387,6 +3403,46 @@ static void test__strupr(void)
     VirtualFree(mem, sizeof(str), MEM_RELEASE);
 }
 
+static void test_wcslen_wcschr(void)
+{
+    static const wchar_t abcW[] = {'a','b','c',0};
+    SYSTEM_INFO si;
+    wchar_t *str;
+    char *mem;
+    DWORD prot;
+    int len, i, misalign;
+
+    ok(wcslen(abcW) == 3, "wcslen returned %d\n", (int)wcslen(abcW));
+    ok(wcschr(abcW, 'c') == abcW + 2, "wcschr returned %p, expected %p\n", wcschr(abcW, 'c'), abcW + 2);
+    ok(wcschr(abcW, 0) == abcW + 3, "wcschr returned %p, expected %p\n", wcschr(abcW, 0), abcW + 3);
+    ok(!wcschr(abcW, 'd'), "wcschr returned %p\n", wcschr(abcW, 'd'));
+
+    /* strings ending right before an inaccessible page */
+    GetSystemInfo(&si);
+    mem = VirtualAlloc(NULL, si.dwPageSize * 2, MEM_COMMIT, PAGE_READWRITE);
+    ok(mem != NULL, "VirtualAlloc failed\n");
+    ok(VirtualProtect(mem + si.dwPageSize, si.dwPageSize, PAGE_NOACCESS, &prot), "VirtualProtect failed\n");
+
+    for(misalign = 0; misalign < 2; misalign++) {
+        for(len = 0; len < 40; len++) {
+            str = (wchar_t*)(mem + si.dwPageSize - misalign - (len + 1) * sizeof(wchar_t));
+            for(i = 0; i < len; i++)
+                str[i] = 'a' + i % 26;
+            str[len] = 0;
+
+            ok(wcslen(str) == len, "%d %d) wcslen returned %d\n", misalign, len, (int)wcslen(str));
+            ok(wcschr(str, 0) == str + len, "%d %d) wcschr returned %p, expected %p\n",
+                    misalign, len, wcschr(str, 0), str + len);
+            ok(!wcschr(str, '#'), "%d %d) wcschr returned %p\n", misalign, len, wcschr(str, '#'));
+            if(len)
+                ok(wcschr(str, str[len - 1]) == str + (len - 1) % 26, "%d %d) wcschr returned %p, expected %p\n",
+                        misalign, len, wcschr(str, str[len - 1]), str + (len - 1) % 26);
+        }
+    }
+
+    VirtualFree(mem, 0, MEM_RELEASE);
+}
+
 static void test__tcsncoll(void)
 {
     struct test {
@@ -3679,6 +3735,7 @@ START_TEST(string)
     test__memicmp();
     test__memicmp_l();
     test__strupr();
+    test_wcslen_wcschr();
     test__tcsncoll();
     test__tcsnicoll();
 }
@@ -25,6 +25,9 @@
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
 #include "msvcrt.h"
 #include "winnls.h"
 #include "wtypes.h"
@@ -447,16 +450,20 @@ double CDECL MSVCRT__wcstod_l(const MSVCRT_wchar_t* str, MSVCRT_wchar_t** end,
     _control87(MSVCRT__EM_DENORMAL|MSVCRT__EM_INVALID|MSVCRT__EM_ZERODIVIDE
             |MSVCRT__EM_OVERFLOW|MSVCRT__EM_UNDERFLOW|MSVCRT__EM_INEXACT, 0xffffffff);
 
-    negexp = (exp < 0);
-    if(negexp)
-        exp = -exp;
-    while(exp) {
-        if(exp & 1)
-            lret *= expcnt;
-        exp /= 2;
-        expcnt = expcnt*expcnt;
+    if(msvcrt_exact_pow10(d, exp, &ret)) {
+        ret *= sign;
+    }else {
+        negexp = (exp < 0);
+        if(negexp)
+            exp = -exp;
+        while(exp) {
+            if(exp & 1)
+                lret *= expcnt;
+            exp /= 2;
+            expcnt = expcnt*expcnt;
+        }
+        ret = (long double)sign * (negexp ? d/lret : d*lret);
     }
-    ret = (long double)sign * (negexp ? d/lret : d*lret);
 
     _control87(fpcontrol, 0xffffffff);
 
@@ -2423,12 +2430,64 @@ int CDECL MSVCRT_towlower(MSVCRT_wint_t c)
     return MSVCRT__towlower_l(c, NULL);
 }
 
+/* same block scan helpers as in ntdll */
+#ifdef __x86_64__
+
+typedef __m128i scan_block;
+
+static inline BOOL block_has_null(const scan_block *block)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(*block, _mm_setzero_si128())) != 0;
+}
+
+static inline BOOL block_has_char(const scan_block *block, MSVCRT_wchar_t ch)
+{
+    __m128i match = _mm_or_si128(_mm_cmpeq_epi16(*block, _mm_setzero_si128()),
+                                 _mm_cmpeq_epi16(*block, _mm_set1_epi16(ch)));
+    return _mm_movemask_epi8(match) != 0;
+}
+
+#else
+
+typedef ULONG_PTR scan_block;
+
+#define WORD_ONES  (~(ULONG_PTR)0 / 0xffff)
+#define WORD_HIGHS (WORD_ONES << 15)
+#define WORD_HAS_NULL(w) (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+static inline BOOL block_has_null(const scan_block *block)
+{
+    return WORD_HAS_NULL(*block) != 0;
+}
+
+static inline BOOL block_has_char(const scan_block *block, MSVCRT_wchar_t ch)
+{
+    return WORD_HAS_NULL(*block) || WORD_HAS_NULL(*block ^ (WORD_ONES * ch));
+}
+
+#endif
+
+static inline BOOL is_block_aligned(const MSVCRT_wchar_t *str)
+{
+    return !((ULONG_PTR)str % sizeof(scan_block));
+}
+
 /*********************************************************************
  *              wcschr (MSVCRT.@)
  */
 MSVCRT_wchar_t* CDECL MSVCRT_wcschr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t ch)
 {
-    return strchrW(str, ch);
+    const scan_block *block;
+
+    for(; !is_block_aligned(str); str++) {
+        if(*str == ch) return (MSVCRT_wchar_t*)str;
+        if(!*str) return NULL;
+    }
+    for(block = (const scan_block*)str; !block_has_char(block, ch); block++);
+    for(str = (const MSVCRT_wchar_t*)block; ; str++) {
+        if(*str == ch) return (MSVCRT_wchar_t*)str;
+        if(!*str) return NULL;
+    }
 }
 
 /***********************************************************************
@@ -2436,7 +2495,14 @@ MSVCRT_wchar_t* CDECL MSVCRT_wcschr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t ch
  */
 int CDECL MSVCRT_wcslen(const MSVCRT_wchar_t *str)
 {
-    return strlenW(str);
+    const MSVCRT_wchar_t *s;
+    const scan_block *block;
+
+    for(s = str; !is_block_aligned(s); s++)
+        if(!*s) return s - str;
+    for(block = (const scan_block*)s; !block_has_null(block); block++);
+    for(s = (const MSVCRT_wchar_t*)block; *s; s++);
+    return s - str;
 }
 
 /*********************************************************************
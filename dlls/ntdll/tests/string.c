@@ -55,6 +55,7 @@ static LPWSTR   (__cdecl *p_wcslwr)(LPWSTR);
 static LPWSTR   (__cdecl *p_wcsupr)(LPWSTR);
 
 static LPWSTR   (WINAPIV *p_wcschr)(LPCWSTR, WCHAR);
+static INT      (__cdecl *p_wcslen)(LPCWSTR);
 static LPWSTR   (WINAPIV *p_wcsrchr)(LPCWSTR, WCHAR);
 
 static void     (__cdecl *p_qsort)(void *,size_t,size_t, int(__cdecl *compar)(const void *, const void *) );
@@ -94,6 +95,7 @@ static void InitFunctionPtrs(void)
         p_wcsupr = (void *)GetProcAddress(hntdll, "_wcsupr");
 
 	p_wcschr= (void *)GetProcAddress(hntdll, "wcschr");
+	p_wcslen= (void *)GetProcAddress(hntdll, "wcslen");
 	p_wcsrchr= (void *)GetProcAddress(hntdll, "wcsrchr");
 	p_qsort= (void *)GetProcAddress(hntdll, "qsort");
 	p_bsearch= (void *)GetProcAddress(hntdll, "bsearch");
@@ -1127,6 +1129,42 @@ static void test_wcschr(void)
        "wcschr should have returned NULL\n");
 }
 
+static void test_wcs_page_boundary(void)
+{
+    SYSTEM_INFO si;
+    WCHAR *str;
+    char *mem;
+    DWORD prot;
+    int len, i, misalign;
+
+    /* strings ending right before an inaccessible page */
+    GetSystemInfo(&si);
+    mem = VirtualAlloc(NULL, si.dwPageSize * 2, MEM_COMMIT, PAGE_READWRITE);
+    ok(mem != NULL, "VirtualAlloc failed\n");
+    ok(VirtualProtect(mem + si.dwPageSize, si.dwPageSize, PAGE_NOACCESS, &prot), "VirtualProtect failed\n");
+
+    for (misalign = 0; misalign < 2; misalign++)
+    {
+        for (len = 0; len < 40; len++)
+        {
+            str = (WCHAR *)(mem + si.dwPageSize - misalign - (len + 1) * sizeof(WCHAR));
+            for (i = 0; i < len; i++)
+                str[i] = 'a' + i % 26;
+            str[len] = 0;
+
+            ok(p_wcslen(str) == len, "%d %d) wcslen returned %d\n", misalign, len, p_wcslen(str));
+            ok(p_wcschr(str, 0) == str + len, "%d %d) wcschr returned %p, expected %p\n",
+               misalign, len, p_wcschr(str, 0), str + len);
+            ok(p_wcschr(str, '#') == NULL, "%d %d) wcschr returned %p\n", misalign, len, p_wcschr(str, '#'));
+            if (len)
+                ok(p_wcschr(str, str[len - 1]) == str + (len - 1) % 26, "%d %d) wcschr returned %p, expected %p\n",
+                   misalign, len, p_wcschr(str, str[len - 1]), str + (len - 1) % 26);
+        }
+    }
+
+    VirtualFree(mem, 0, MEM_RELEASE);
+}
+
 static void test_wcsrchr(void)
 {
     static const WCHAR teststringW[] = {'a','b','r','a','c','a','d','a','b','r','a',0};
@@ -1321,6 +1359,8 @@ START_TEST(string)
         test_wcschr();
     if (p_wcsrchr)
         test_wcsrchr();
+    if (p_wcschr && p_wcslen)
+        test_wcs_page_boundary();
     if (p_wcslwr && p_wcsupr)
         test_wcslwrupr();
     if (patoi)
@@ -28,11 +28,58 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
 
 #include "windef.h"
 #include "winternl.h"
 #include "wine/unicode.h"
 
+/* Helpers to scan strings a block at a time. Only aligned blocks are read,
+ * so the scan never touches a page that doesn't contain the string. SSE2 is
+ * always available on x86_64, elsewhere a block is a machine word. */
+#ifdef __x86_64__
+
+typedef __m128i scan_block;
+
+static inline BOOL block_has_null( const scan_block *block )
+{
+    return _mm_movemask_epi8( _mm_cmpeq_epi16( *block, _mm_setzero_si128() )) != 0;
+}
+
+static inline BOOL block_has_char( const scan_block *block, WCHAR ch )
+{
+    __m128i match = _mm_or_si128( _mm_cmpeq_epi16( *block, _mm_setzero_si128() ),
+                                  _mm_cmpeq_epi16( *block, _mm_set1_epi16( ch )));
+    return _mm_movemask_epi8( match ) != 0;
+}
+
+#else
+
+typedef ULONG_PTR scan_block;
+
+#define WORD_ONES  (~(ULONG_PTR)0 / 0xffff)
+#define WORD_HIGHS (WORD_ONES << 15)
+#define WORD_HAS_NULL(w) (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+static inline BOOL block_has_null( const scan_block *block )
+{
+    return WORD_HAS_NULL( *block ) != 0;
+}
+
+static inline BOOL block_has_char( const scan_block *block, WCHAR ch )
+{
+    return WORD_HAS_NULL( *block ) || WORD_HAS_NULL( *block ^ (WORD_ONES * ch) );
+}
+
+#endif
+
+static inline BOOL is_block_aligned( const WCHAR *str )
+{
+    return !((ULONG_PTR)str % sizeof(scan_block));
+}
+
 /*********************************************************************
  *           _wcsicmp    (NTDLL.@)
  */
@@ -101,7 +148,20 @@ LPWSTR __cdecl NTDLL_wcscat( LPWSTR dst, LPCWSTR src )
  */
 LPWSTR __cdecl NTDLL_wcschr( LPCWSTR str, WCHAR ch )
 {
-    return strchrW( str, ch );
+    const scan_block *block;
+
+    for (; !is_block_aligned( str ); str++)
+    {
+        if (*str == ch) return (LPWSTR)str;
+        if (!*str) return NULL;
+    }
+    for (block = (const scan_block *)str; !block_has_char( block, ch ); block++)
+        ;
+    for (str = (LPCWSTR)block; ; str++)
+    {
+        if (*str == ch) return (LPWSTR)str;
+        if (!*str) return NULL;
+    }
 }
 
 
@@ -137,7 +197,16 @@ INT __cdecl NTDLL_wcscspn( LPCWSTR str, LPCWSTR reject )
  */
 INT __cdecl NTDLL_wcslen( LPCWSTR str )
 {
-    return strlenW( str );
+    const scan_block *block;
+    LPCWSTR s;
+
+    for (s = str; !is_block_aligned( s ); s++)
+        if (!*s) return s - str;
+    for (block = (const scan_block *)s; !block_has_null( block ); block++)
+        ;
+    for (s = (LPCWSTR)block; *s; s++)
+        ;
+    return s - str;
 }
 
 
@@ -43,6 +43,7 @@ static DWORD   vcomp_context_tls = TLS_OUT_OF_INDEXES;
 static HMODULE vcomp_module;
 static int     vcomp_max_threads;
 static int     vcomp_num_threads;
+static int     vcomp_num_procs;
 static BOOL    vcomp_nested_fork = FALSE;
 
 static RTL_CRITICAL_SECTION vcomp_section;
@@ -59,6 +60,9 @@ static RTL_CRITICAL_SECTION vcomp_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 #define VCOMP_DYNAMIC_FLAGS_GUIDED      0x03
 #define VCOMP_DYNAMIC_FLAGS_INCREMENT   0x40
 
+/* number of times a thread polls a barrier before going to sleep */
+#define VCOMP_BARRIER_SPIN_COUNT        4000
+
 struct vcomp_thread_data
 {
     struct vcomp_team_data  *team;
@@ -82,6 +86,11 @@ struct vcomp_thread_data
     unsigned int            dynamic_type;
     unsigned int            dynamic_begin;
     unsigned int            dynamic_end;
+    unsigned int            dynamic_first;
+    unsigned int            dynamic_last;
+    unsigned int            dynamic_iterations;
+    int                     dynamic_step;
+    unsigned int            dynamic_chunksize;
 };
 
 struct vcomp_team_data
@@ -96,7 +105,7 @@ struct vcomp_team_data
     __ms_va_list            valist;
 
     /* barrier */
-    unsigned int            barrier;
+    volatile int            barrier;
     int                     barrier_count;
 };
 
@@ -112,11 +121,9 @@ struct vcomp_task_data
 
     /* dynamic */
     unsigned int            dynamic;
-    unsigned int            dynamic_first;
-    unsigned int            dynamic_last;
-    unsigned int            dynamic_iterations;
-    int                     dynamic_step;
-    unsigned int            dynamic_chunksize;
+    /* generation of the loop in the high 32 bits, number of iterations
+     * handed out so far in the low 32 bits, updated atomically */
+    __int64                 dynamic_state;
 };
 
 #if defined(__i386__)
@@ -389,6 +396,13 @@ static inline void vcomp_set_thread_data(struct vcomp_thread_data *thread_data)
     TlsSetValue(vcomp_context_tls, thread_data);
 }
 
+static inline void vcomp_pause(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__( "rep;nop" : : : "memory" );
+#endif
+}
+
 static struct vcomp_thread_data *vcomp_init_thread_data(void)
 {
     struct vcomp_thread_data *thread_data = vcomp_get_thread_data();
@@ -408,6 +422,7 @@ static struct vcomp_thread_data *vcomp_init_thread_data(void)
     data->task.single           = 0;
     data->task.section          = 0;
     data->task.dynamic          = 0;
+    data->task.dynamic_state    = 0;
 
     thread_data = &data->thread;
     thread_data->team           = NULL;
@@ -1054,25 +1069,40 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    int barrier, i;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    barrier = team_data->barrier;
+    if (interlocked_xchg_add(&team_data->barrier_count, 1) + 1 >= team_data->num_threads)
     {
-        team_data->barrier++;
-        team_data->barrier_count = 0;
+        /* last thread to arrive, release the others */
+        interlocked_xchg(&team_data->barrier_count, 0);
+        EnterCriticalSection(&vcomp_section);
+        interlocked_xchg_add((int *)&team_data->barrier, 1);
         WakeAllConditionVariable(&team_data->cond);
+        LeaveCriticalSection(&vcomp_section);
+        return;
     }
-    else
+
+    /* the other threads usually arrive shortly, so spin for a while
+     * before falling back to the condition variable, unless they have
+     * to share processors with this one */
+    if (team_data->num_threads <= vcomp_num_procs)
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
-            SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        for (i = 0; i < VCOMP_BARRIER_SPIN_COUNT; i++)
+        {
+            if (team_data->barrier != barrier) return;
+            vcomp_pause();
+        }
     }
+
+    EnterCriticalSection(&vcomp_section);
+    while (team_data->barrier == barrier)
+        SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
     LeaveCriticalSection(&vcomp_section);
 }
 
@@ -1099,18 +1129,21 @@ int CDECL _vcomp_single_begin(int flags)
 {
     struct vcomp_thread_data *thread_data = vcomp_init_thread_data();
     struct vcomp_task_data *task_data = thread_data->task;
+    unsigned int single;
     int ret = FALSE;
 
     TRACE("(%x): semi-stub\n", flags);
 
-    EnterCriticalSection(&vcomp_section);
+    /* the first thread to get here moves the task on to the next block */
     thread_data->single++;
-    if ((int)(thread_data->single - task_data->single) > 0)
+    while ((int)(thread_data->single - (single = task_data->single)) > 0)
     {
-        task_data->single = thread_data->single;
-        ret = TRUE;
+        if (interlocked_cmpxchg((int *)&task_data->single, thread_data->single, single) == single)
+        {
+            ret = TRUE;
+            break;
+        }
     }
-    LeaveCriticalSection(&vcomp_section);
 
     return ret;
 }
@@ -1294,6 +1327,7 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
     int num_threads = team_data ? team_data->num_threads : 1;
     int thread_num = thread_data->thread_num;
     unsigned int type = flags & ~VCOMP_DYNAMIC_FLAGS_INCREMENT;
+    __int64 state, prev;
 
     TRACE("(%u, %u, %u, %d, %u)\n", flags, first, last, step, chunksize);
 
@@ -1339,17 +1373,25 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
             type = VCOMP_DYNAMIC_FLAGS_GUIDED;
         }
 
-        EnterCriticalSection(&vcomp_section);
+        /* all threads of the team are called with the same arguments, so
+         * only the number of iterations handed out has to be shared */
         thread_data->dynamic++;
-        thread_data->dynamic_type = type;
+        thread_data->dynamic_type       = type;
+        thread_data->dynamic_first      = first;
+        thread_data->dynamic_last       = last;
+        thread_data->dynamic_iterations = iterations;
+        thread_data->dynamic_step       = step;
+        thread_data->dynamic_chunksize  = chunksize ? chunksize : 1;
+
+        EnterCriticalSection(&vcomp_section);
         if ((int)(thread_data->dynamic - task_data->dynamic) > 0)
         {
-            task_data->dynamic              = thread_data->dynamic;
-            task_data->dynamic_first        = first;
-            task_data->dynamic_last         = last;
-            task_data->dynamic_iterations   = iterations;
-            task_data->dynamic_step         = step;
-            task_data->dynamic_chunksize    = chunksize;
+            task_data->dynamic = thread_data->dynamic;
+            /* start handing out chunks of the new loop */
+            state = interlocked_cmpxchg64(&task_data->dynamic_state, 0, 0);
+            while ((prev = interlocked_cmpxchg64(&task_data->dynamic_state,
+                    (__int64)thread_data->dynamic << 32, state)) != state)
+                state = prev;
         }
         LeaveCriticalSection(&vcomp_section);
     }
@@ -1374,26 +1416,41 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int done, remaining, iterations;
+        __int64 state, prev;
+
+        /* Chunks are handed out with a compare-and-swap on the loop state.
+         * A thread only starts the next loop once all iterations of this
+         * one have been handed out, so a different generation means that
+         * there is nothing left to do. */
+        state = interlocked_cmpxchg64(&task_data->dynamic_state, 0, 0);
+        for (;;)
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            if ((unsigned int)(state >> 32) != thread_data->dynamic)
+                return 0;
+
+            done = (unsigned int)state;
+            if (done >= thread_data->dynamic_iterations)
+                return 0;
+
+            remaining  = thread_data->dynamic_iterations - done;
+            iterations = min(remaining, thread_data->dynamic_chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * thread_data->dynamic_chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
-                *end = task_data->dynamic_last;
+
+            prev = interlocked_cmpxchg64(&task_data->dynamic_state, state + iterations, state);
+            if (prev == state) break;
+            state = prev;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+
+        *begin = thread_data->dynamic_first + done * thread_data->dynamic_step;
+        *end   = *begin + (iterations - 1) * thread_data->dynamic_step;
+        if (iterations == remaining)
+            *end = thread_data->dynamic_last;
+        return 1;
     }
 
     return 0;
@@ -1478,6 +1535,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
     task_data.single            = 0;
     task_data.section           = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_state     = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -1693,6 +1751,7 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
             vcomp_module      = instance;
             vcomp_max_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_threads = sysinfo.dwNumberOfProcessors;
+            vcomp_num_procs   = sysinfo.dwNumberOfProcessors;
             break;
         }
 
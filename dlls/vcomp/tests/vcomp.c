@@ -1224,6 +1224,51 @@ static void CDECL for_dynamic_guided_cb(unsigned int flags, LONG *a, LONG *b, LO
     }
 }
 
+#define NOWAIT_LOOPS 100
+
+static void CDECL for_dynamic_nowait_cb(LONG *counts)
+{
+    unsigned int begin, end, i, flags;
+    int loop;
+
+    /* back to back loops without a barrier, threads may still be
+     * working on a loop while others already start the next one */
+    for (loop = 0; loop < NOWAIT_LOOPS; loop++)
+    {
+        flags = (loop & 1) ? VCOMP_DYNAMIC_FLAGS_GUIDED : VCOMP_DYNAMIC_FLAGS_CHUNKED;
+        p_vcomp_for_dynamic_init(flags | VCOMP_DYNAMIC_FLAGS_INCREMENT, 0, loop, 1, 1 + loop % 3);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+        {
+            ok(begin <= end && end <= loop, "loop %d: got %u and %u\n", loop, begin, end);
+            for (i = begin; i <= end && i <= loop; i++)
+                InterlockedIncrement(&counts[loop * NOWAIT_LOOPS + i]);
+        }
+    }
+}
+
+static void test_vcomp_for_dynamic_nowait(void)
+{
+    static LONG counts[NOWAIT_LOOPS * NOWAIT_LOOPS];
+    int max_threads = pomp_get_max_threads();
+    int i, loop, j, errors;
+
+    pomp_set_num_threads(4);
+
+    for (i = 0; i < 20; i++)
+    {
+        memset(counts, 0, sizeof(counts));
+        p_vcomp_fork(TRUE, 1, for_dynamic_nowait_cb, counts);
+
+        errors = 0;
+        for (loop = 0; loop < NOWAIT_LOOPS; loop++)
+            for (j = 0; j <= loop; j++)
+                if (counts[loop * NOWAIT_LOOPS + j] != 1) errors++;
+        ok(!errors, "%d iterations were not executed exactly once\n", errors);
+    }
+
+    pomp_set_num_threads(max_threads);
+}
+
 static void test_vcomp_for_dynamic_init(void)
 {
     static const int guided_a[] = {0, 6041, 9072, 11179};
@@ -2234,6 +2279,7 @@ START_TEST(vcomp)
     test_vcomp_for_static_simple_init();
     test_vcomp_for_static_init();
     test_vcomp_for_dynamic_init();
+    test_vcomp_for_dynamic_nowait();
     test_vcomp_master_begin();
     test_vcomp_single_begin();
     test_vcomp_enter_critsect();
@@ -134,6 +134,139 @@ static inline FormatConverter *impl_from_IWICFormatConverter(IWICFormatConverter
     return CONTAINING_RECORD(iface, FormatConverter, IWICFormatConverter_iface);
 }
 
+/* The following functions expand one row of pixels in place. The source
+ * pixels are at the start of the row, and are converted from right to left,
+ * so no source pixel is overwritten before it is read. */
+
+static void expand_8bppGray_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+        dst[x] = 0xff000000 | (row[x] << 16) | (row[x] << 8) | row[x];
+}
+
+static void expand_16bppGray_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+    {
+        BYTE gray = row[2 * x];
+        dst[x] = 0xff000000 | (gray << 16) | (gray << 8) | gray;
+    }
+}
+
+static void expand_16bppBGR555_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+    {
+        WORD srcval = ((const WORD *)row)[x];
+        dst[x] = 0xff000000 | /* constant 255 alpha */
+                 ((srcval << 9) & 0xf80000) | /* r */
+                 ((srcval << 4) & 0x070000) | /* r - 3 bits */
+                 ((srcval << 6) & 0x00f800) | /* g */
+                 ((srcval << 1) & 0x000700) | /* g - 3 bits */
+                 ((srcval << 3) & 0x0000f8) | /* b */
+                 ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void expand_16bppBGR565_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+    {
+        WORD srcval = ((const WORD *)row)[x];
+        dst[x] = 0xff000000 | /* constant 255 alpha */
+                 ((srcval << 8) & 0xf80000) | /* r */
+                 ((srcval << 3) & 0x070000) | /* r - 3 bits */
+                 ((srcval << 5) & 0x00fc00) | /* g */
+                 ((srcval >> 1) & 0x000300) | /* g - 2 bits */
+                 ((srcval << 3) & 0x0000f8) | /* b */
+                 ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void expand_16bppBGRA5551_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+    {
+        WORD srcval = ((const WORD *)row)[x];
+        dst[x] = ((srcval & 0x8000) ? 0xff000000 : 0) | /* alpha */
+                 ((srcval << 9) & 0xf80000) | /* r */
+                 ((srcval << 4) & 0x070000) | /* r - 3 bits */
+                 ((srcval << 6) & 0x00f800) | /* g */
+                 ((srcval << 1) & 0x000700) | /* g - 3 bits */
+                 ((srcval << 3) & 0x0000f8) | /* b */
+                 ((srcval >> 2) & 0x000007);  /* b - 3 bits */
+    }
+}
+
+static void expand_24bppBGR_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+        dst[x] = 0xff000000 | (row[3 * x + 2] << 16) | (row[3 * x + 1] << 8) | row[3 * x];
+}
+
+static void expand_24bppRGB_to_32bppBGRA(BYTE *row, UINT width)
+{
+    DWORD *dst = (DWORD *)row;
+    UINT x;
+
+    for (x = width; x--;)
+        dst[x] = 0xff000000 | (row[3 * x] << 16) | (row[3 * x + 1] << 8) | row[3 * x + 2];
+}
+
+static void expand_8bppGray_to_24bppBGR(BYTE *row, UINT width)
+{
+    UINT x;
+
+    for (x = width; x--;)
+    {
+        BYTE gray = row[x];
+        row[3 * x] = row[3 * x + 1] = row[3 * x + 2] = gray;
+    }
+}
+
+/* Copies the source pixels straight into the destination buffer and expands
+ * them there, which avoids a temporary copy of the source data. */
+static HRESULT copypixels_expand(struct FormatConverter *This, const WICRect *prc,
+    UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer, UINT dst_bpp,
+    void (*expand_row)(BYTE *row, UINT width))
+{
+    UINT bytesperrow = (prc->Width * dst_bpp + 7) / 8;
+    HRESULT hr;
+    INT y;
+
+    if (prc->Width <= 0 || prc->Height <= 0)
+        return IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+
+    if (cbStride < bytesperrow || (ULONGLONG)cbStride * (prc->Height - 1) + bytesperrow > cbBufferSize)
+        return E_INVALIDARG;
+
+    hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+    if (FAILED(hr)) return hr;
+
+    for (y = 0; y < prc->Height; y++)
+        expand_row(pbBuffer + cbStride * y, prc->Width);
+
+    return S_OK;
+}
+
 static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRect *prc,
     UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer, enum pixelformat source_format)
 {
@@ -332,45 +465,8 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         return S_OK;
     case format_8bppGray:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcbyte;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcbyte = srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++)
-                    {
-                        *dstpixel++ = 0xff000000|(*srcbyte<<16)|(*srcbyte<<8)|*srcbyte;
-                        srcbyte++;
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_8bppGray_to_32bppBGRA);
         return S_OK;
     case format_8bppIndexed:
         if (prc)
@@ -427,280 +523,33 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         return S_OK;
     case format_16bppGray:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcbyte;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = prc->Width * 2;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcbyte = srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++)
-                    {
-                        *dstpixel++ = 0xff000000|(*srcbyte<<16)|(*srcbyte<<8)|*srcbyte;
-                        srcbyte+=2;
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_16bppGray_to_32bppBGRA);
         return S_OK;
     case format_16bppBGR555:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const WORD *srcpixel;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = 2 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=(const WORD*)srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        WORD srcval;
-                        srcval=*srcpixel++;
-                        *dstpixel++=0xff000000 | /* constant 255 alpha */
-                                    ((srcval << 9) & 0xf80000) | /* r */
-                                    ((srcval << 4) & 0x070000) | /* r - 3 bits */
-                                    ((srcval << 6) & 0x00f800) | /* g */
-                                    ((srcval << 1) & 0x000700) | /* g - 3 bits */
-                                    ((srcval << 3) & 0x0000f8) | /* b */
-                                    ((srcval >> 2) & 0x000007);  /* b - 3 bits */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_16bppBGR555_to_32bppBGRA);
         return S_OK;
     case format_16bppBGR565:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const WORD *srcpixel;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = 2 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=(const WORD*)srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        WORD srcval;
-                        srcval=*srcpixel++;
-                        *dstpixel++=0xff000000 | /* constant 255 alpha */
-                                    ((srcval << 8) & 0xf80000) | /* r */
-                                    ((srcval << 3) & 0x070000) | /* r - 3 bits */
-                                    ((srcval << 5) & 0x00fc00) | /* g */
-                                    ((srcval >> 1) & 0x000300) | /* g - 2 bits */
-                                    ((srcval << 3) & 0x0000f8) | /* b */
-                                    ((srcval >> 2) & 0x000007);  /* b - 3 bits */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_16bppBGR565_to_32bppBGRA);
         return S_OK;
     case format_16bppBGRA5551:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const WORD *srcpixel;
-            BYTE *dstrow;
-            DWORD *dstpixel;
-
-            srcstride = 2 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=(const WORD*)srcrow;
-                    dstpixel=(DWORD*)dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        WORD srcval;
-                        srcval=*srcpixel++;
-                        *dstpixel++=((srcval & 0x8000) ? 0xff000000 : 0) | /* alpha */
-                                    ((srcval << 9) & 0xf80000) | /* r */
-                                    ((srcval << 4) & 0x070000) | /* r - 3 bits */
-                                    ((srcval << 6) & 0x00f800) | /* g */
-                                    ((srcval << 1) & 0x000700) | /* g - 3 bits */
-                                    ((srcval << 3) & 0x0000f8) | /* b */
-                                    ((srcval >> 2) & 0x000007);  /* b - 3 bits */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_16bppBGRA5551_to_32bppBGRA);
         return S_OK;
     case format_24bppBGR:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        *dstpixel++=*srcpixel++; /* blue */
-                        *dstpixel++=*srcpixel++; /* green */
-                        *dstpixel++=*srcpixel++; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_24bppBGR_to_32bppBGRA);
         return S_OK;
     case format_24bppRGB:
         if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-            BYTE tmppixel[3];
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        tmppixel[0]=*srcpixel++; /* red */
-                        tmppixel[1]=*srcpixel++; /* green */
-                        tmppixel[2]=*srcpixel++; /* blue */
-
-                        *dstpixel++=tmppixel[2]; /* blue */
-                        *dstpixel++=tmppixel[1]; /* green */
-                        *dstpixel++=tmppixel[0]; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            HeapFree(GetProcessHeap(), 0, srcdata);
-
-            return res;
-        }
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 32,
+                expand_24bppRGB_to_32bppBGRA);
         return S_OK;
     case format_32bppBGR:
         if (prc)
@@ -924,6 +773,11 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
             return hr;
         }
         return S_OK;
+    case format_8bppGray:
+        if (prc)
+            return copypixels_expand(This, prc, cbStride, cbBufferSize, pbBuffer, 24,
+                expand_8bppGray_to_24bppBGR);
+        return S_OK;
     case format_32bppBGR:
     case format_32bppBGRA:
     case format_32bppPBGRA:
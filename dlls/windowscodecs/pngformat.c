@@ -335,6 +335,7 @@ MAKE_FUNCPTR(png_set_write_fn);
 MAKE_FUNCPTR(png_read_end);
 MAKE_FUNCPTR(png_read_image);
 MAKE_FUNCPTR(png_read_info);
+MAKE_FUNCPTR(png_read_rows);
 MAKE_FUNCPTR(png_write_end);
 MAKE_FUNCPTR(png_write_info);
 MAKE_FUNCPTR(png_write_rows);
@@ -401,6 +402,7 @@ static void *load_libpng(void)
         LOAD_FUNCPTR(png_read_end);
         LOAD_FUNCPTR(png_read_image);
         LOAD_FUNCPTR(png_read_info);
+        LOAD_FUNCPTR(png_read_rows);
         LOAD_FUNCPTR(png_write_end);
         LOAD_FUNCPTR(png_write_info);
         LOAD_FUNCPTR(png_write_rows);
@@ -452,6 +454,10 @@ typedef struct {
     UINT stride;
     const WICPixelFormatGUID *format;
     BYTE *image_bits;
+    int passes;
+    UINT decoded_rows; /* rows of image_bits that have been decoded */
+    BOOL decode_failed;
+    ULARGE_INTEGER decode_pos; /* stream position where decoding continues */
     CRITICAL_SECTION lock; /* must be held when png structures are accessed or initialized is set */
     ULONG metadata_count;
     metadata_block_info* metadata_blocks;
@@ -572,9 +578,6 @@ static HRESULT WINAPI PngDecoder_Initialize(IWICBitmapDecoder *iface, IStream *p
     PngDecoder *This = impl_from_IWICBitmapDecoder(iface);
     LARGE_INTEGER seek;
     HRESULT hr=S_OK;
-    png_bytep *row_pointers=NULL;
-    UINT image_size;
-    UINT i;
     int color_type, bit_depth;
     png_bytep trans;
     int num_trans;
@@ -620,7 +623,6 @@ static HRESULT WINAPI PngDecoder_Initialize(IWICBitmapDecoder *iface, IStream *p
     if (setjmp(jmpbuf))
     {
         ppng_destroy_read_struct(&This->png_ptr, &This->info_ptr, &This->end_info);
-        HeapFree(GetProcessHeap(), 0, row_pointers);
         This->png_ptr = NULL;
         hr = E_FAIL;
         goto end;
@@ -731,35 +733,15 @@ static HRESULT WINAPI PngDecoder_Initialize(IWICBitmapDecoder *iface, IStream *p
         goto end;
     }
 
-    /* read the image data */
     This->width = ppng_get_image_width(This->png_ptr, This->info_ptr);
     This->height = ppng_get_image_height(This->png_ptr, This->info_ptr);
     This->stride = (This->width * This->bpp + 7) / 8;
-    image_size = This->stride * This->height;
-
-    This->image_bits = HeapAlloc(GetProcessHeap(), 0, image_size);
-    if (!This->image_bits)
-    {
-        hr = E_OUTOFMEMORY;
-        goto end;
-    }
-
-    row_pointers = HeapAlloc(GetProcessHeap(), 0, sizeof(png_bytep)*This->height);
-    if (!row_pointers)
-    {
-        hr = E_OUTOFMEMORY;
-        goto end;
-    }
-
-    for (i=0; i<This->height; i++)
-        row_pointers[i] = This->image_bits + i * This->stride;
-
-    ppng_read_image(This->png_ptr, row_pointers);
-
-    HeapFree(GetProcessHeap(), 0, row_pointers);
-    row_pointers = NULL;
+    This->passes = ppng_set_interlace_handling(This->png_ptr);
 
-    ppng_read_end(This->png_ptr, This->end_info);
+    /* The image data is decoded on demand by CopyPixels, remember where it starts. */
+    seek.QuadPart = 0;
+    hr = IStream_Seek(pIStream, seek, STREAM_SEEK_CUR, &This->decode_pos);
+    if (FAILED(hr)) goto end;
 
     /* Find the metadata chunks in the file. */
     seek.QuadPart = 8;
@@ -1090,15 +1072,92 @@ end:
     return hr;
 }
 
+/* Decodes the image up to (but not including) row max_row. Must be called with
+ * the lock held. Interlaced images can only be decoded as a whole. */
+static HRESULT PngDecoder_decode_rows(PngDecoder *This, UINT max_row)
+{
+    png_bytep *row_pointers;
+    LARGE_INTEGER seek;
+    jmp_buf jmpbuf;
+    HRESULT hr;
+    UINT i, count;
+
+    if (!This->image_bits)
+    {
+        This->image_bits = HeapAlloc(GetProcessHeap(), 0, This->stride * This->height);
+        if (!This->image_bits) return E_OUTOFMEMORY;
+    }
+
+    if (This->passes > 1) max_row = This->height;
+    if (max_row <= This->decoded_rows) return S_OK;
+    if (This->decode_failed) return E_FAIL;
+
+    count = max_row - This->decoded_rows;
+    row_pointers = HeapAlloc(GetProcessHeap(), 0, sizeof(png_bytep) * count);
+    if (!row_pointers) return E_OUTOFMEMORY;
+
+    for (i = 0; i < count; i++)
+        row_pointers[i] = This->image_bits + (This->decoded_rows + i) * This->stride;
+
+    /* the stream may have been used by a metadata reader in the meantime */
+    seek.QuadPart = This->decode_pos.QuadPart;
+    hr = IStream_Seek(This->stream, seek, STREAM_SEEK_SET, NULL);
+    if (FAILED(hr))
+    {
+        HeapFree(GetProcessHeap(), 0, row_pointers);
+        return hr;
+    }
+
+    if (setjmp(jmpbuf))
+    {
+        HeapFree(GetProcessHeap(), 0, row_pointers);
+        This->decode_failed = TRUE;
+        return E_FAIL;
+    }
+    ppng_set_error_fn(This->png_ptr, jmpbuf, user_error_fn, user_warning_fn);
+
+    if (This->passes > 1)
+        ppng_read_image(This->png_ptr, row_pointers);
+    else
+        ppng_read_rows(This->png_ptr, row_pointers, NULL, count);
+
+    HeapFree(GetProcessHeap(), 0, row_pointers);
+    This->decoded_rows = max_row;
+
+    seek.QuadPart = 0;
+    return IStream_Seek(This->stream, seek, STREAM_SEEK_CUR, &This->decode_pos);
+}
+
 static HRESULT WINAPI PngDecoder_Frame_CopyPixels(IWICBitmapFrameDecode *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
     PngDecoder *This = impl_from_IWICBitmapFrameDecode(iface);
+    UINT max_row;
+    HRESULT hr;
     TRACE("(%p,%p,%u,%u,%p)\n", iface, prc, cbStride, cbBufferSize, pbBuffer);
 
-    return copy_pixels(This->bpp, This->image_bits,
-        This->width, This->height, This->stride,
-        prc, cbStride, cbBufferSize, pbBuffer);
+    if (prc)
+    {
+        if (prc->X < 0 || prc->Y < 0 || prc->X+prc->Width > This->width || prc->Y+prc->Height > This->height)
+            return E_INVALIDARG;
+        max_row = prc->Y + prc->Height;
+    }
+    else
+        max_row = This->height;
+
+    /* Only the rows down to the bottom of the requested rectangle are decoded,
+     * so reading an image from top to bottom decodes it incrementally. */
+    EnterCriticalSection(&This->lock);
+
+    hr = PngDecoder_decode_rows(This, max_row);
+    if (SUCCEEDED(hr))
+        hr = copy_pixels(This->bpp, This->image_bits,
+            This->width, This->height, This->stride,
+            prc, cbStride, cbBufferSize, pbBuffer);
+
+    LeaveCriticalSection(&This->lock);
+
+    return hr;
 }
 
 static HRESULT WINAPI PngDecoder_Frame_GetMetadataQueryReader(IWICBitmapFrameDecode *iface,
@@ -1312,6 +1371,10 @@ HRESULT PngDecoder_CreateInstance(REFIID iid, void** ppv)
     This->stream = NULL;
     This->initialized = FALSE;
     This->image_bits = NULL;
+    This->passes = 1;
+    This->decoded_rows = 0;
+    This->decode_failed = FALSE;
+    This->decode_pos.QuadPart = 0;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": PngDecoder.lock");
     This->metadata_count = 0;
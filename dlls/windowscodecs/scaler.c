@@ -19,6 +19,7 @@
 #include "config.h"
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -32,6 +33,17 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+/* Filter weights for one axis, in 1.14 fixed point. Destination pixel i is
+ * computed from source pixels start[i] .. start[i]+taps-1. */
+struct scaler_weights
+{
+    UINT taps;
+    UINT *start;
+    INT *weights;
+};
+
+#define SCALER_WEIGHT_BITS 14
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -42,6 +54,14 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    struct scaler_weights x_weights, y_weights;
+    INT *accum;
+    /* ring buffer of source rows, see BitmapScaler_CopyPixels */
+    BYTE *cache;
+    BYTE **cache_rows;
+    UINT cache_size, cache_stride;
+    INT cache_x, cache_width;
+    INT cache_first, cache_count;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -84,6 +104,14 @@ static ULONG WINAPI BitmapScaler_AddRef(IWICBitmapScaler *iface)
     return ref;
 }
 
+static void free_scaler_weights(struct scaler_weights *w)
+{
+    HeapFree(GetProcessHeap(), 0, w->start);
+    HeapFree(GetProcessHeap(), 0, w->weights);
+    w->start = NULL;
+    w->weights = NULL;
+}
+
 static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
 {
     BitmapScaler *This = impl_from_IWICBitmapScaler(iface);
@@ -96,6 +124,11 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        free_scaler_weights(&This->x_weights);
+        free_scaler_weights(&This->y_weights);
+        HeapFree(GetProcessHeap(), 0, This->accum);
+        HeapFree(GetProcessHeap(), 0, This->cache);
+        HeapFree(GetProcessHeap(), 0, This->cache_rows);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -190,6 +223,263 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+static double filter_linear(double x)
+{
+    x = fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+static double filter_cubic(double x)
+{
+    /* Keys' cubic convolution with a = -0.5 */
+    x = fabs(x);
+    if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+static HRESULT init_scaler_weights(struct scaler_weights *w, UINT src_size, UINT dst_size,
+    WICBitmapInterpolationMode mode)
+{
+    double scale, support = 0.0, total, *tmp;
+    INT first, last, start, j, sum;
+    UINT i, k, max_k;
+
+    scale = (double)src_size / dst_size;
+    if (mode == WICBitmapInterpolationModeFant)
+        w->taps = (UINT)ceil(scale) + 1;
+    else
+    {
+        support = mode == WICBitmapInterpolationModeCubic ? 2.0 : 1.0;
+        w->taps = 2 * (UINT)support;
+    }
+    if (w->taps > src_size) w->taps = src_size;
+
+    w->start = HeapAlloc(GetProcessHeap(), 0, dst_size * sizeof(*w->start));
+    w->weights = HeapAlloc(GetProcessHeap(), 0, dst_size * w->taps * sizeof(*w->weights));
+    tmp = HeapAlloc(GetProcessHeap(), 0, w->taps * sizeof(*tmp));
+    if (!w->start || !w->weights || !tmp)
+    {
+        free_scaler_weights(w);
+        HeapFree(GetProcessHeap(), 0, tmp);
+        return E_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < dst_size; i++)
+    {
+        double center = (i + 0.5) * scale;
+
+        if (mode == WICBitmapInterpolationModeFant)
+        {
+            first = (INT)floor(i * scale);
+            last = (INT)ceil((i + 1) * scale) - 1;
+        }
+        else
+        {
+            first = (INT)floor(center - 0.5 - support) + 1;
+            last = (INT)ceil(center - 0.5 + support) - 1;
+        }
+
+        start = min(max(first, 0), (INT)(src_size - w->taps));
+        w->start[i] = start;
+        for (k = 0; k < w->taps; k++) tmp[k] = 0.0;
+
+        /* Samples outside of the source are replaced by the edge pixels. */
+        total = 0.0;
+        for (j = first; j <= last; j++)
+        {
+            double weight;
+
+            if (mode == WICBitmapInterpolationModeFant)
+                weight = min(j + 1, (i + 1) * scale) - max(j, i * scale);
+            else if (mode == WICBitmapInterpolationModeCubic)
+                weight = filter_cubic(j + 0.5 - center);
+            else
+                weight = filter_linear(j + 0.5 - center);
+
+            k = min(max(j, 0), (INT)src_size - 1) - start;
+            tmp[k] += weight;
+            total += weight;
+        }
+
+        /* Normalize, and make sure the weights add up to exactly one, so
+         * that flat areas are preserved. */
+        sum = max_k = 0;
+        for (k = 0; k < w->taps; k++)
+        {
+            w->weights[i * w->taps + k] = (INT)floor(tmp[k] / total * (1 << SCALER_WEIGHT_BITS) + 0.5);
+            sum += w->weights[i * w->taps + k];
+            if (tmp[k] > tmp[max_k]) max_k = k;
+        }
+        w->weights[i * w->taps + max_k] += (1 << SCALER_WEIGHT_BITS) - sum;
+    }
+
+    HeapFree(GetProcessHeap(), 0, tmp);
+    return S_OK;
+}
+
+static HRESULT init_filter(BitmapScaler *This)
+{
+    HRESULT hr;
+
+    hr = init_scaler_weights(&This->x_weights, This->src_width, This->width, This->mode);
+    if (SUCCEEDED(hr))
+        hr = init_scaler_weights(&This->y_weights, This->src_height, This->height, This->mode);
+    if (SUCCEEDED(hr))
+    {
+        This->accum = HeapAlloc(GetProcessHeap(), 0, This->src_width * (This->bpp / 8) * sizeof(*This->accum));
+        if (!This->accum) hr = E_OUTOFMEMORY;
+    }
+
+    if (FAILED(hr))
+    {
+        free_scaler_weights(&This->x_weights);
+        free_scaler_weights(&This->y_weights);
+    }
+
+    return hr;
+}
+
+static BOOL is_filter_format(const WICPixelFormatGUID *format)
+{
+    /* Formats with one byte per channel, which can be filtered directly. */
+    return IsEqualGUID(format, &GUID_WICPixelFormat8bppGray) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat24bppBGR) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat24bppRGB) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppBGR) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppBGRA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppPBGRA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppRGBA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppPRGBA);
+}
+
+static void Filter_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    src_rect->X = This->x_weights.start[x];
+    src_rect->Y = This->y_weights.start[y];
+    src_rect->Width = This->x_weights.taps;
+    src_rect->Height = This->y_weights.taps;
+}
+
+static void Filter_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT channels = This->bpp / 8;
+    UINT x_taps = This->x_weights.taps, y_taps = This->y_weights.taps;
+    const INT *weights = This->y_weights.weights + dst_y * y_taps;
+    INT *accum = This->accum;
+    UINT i, j, c, k, count;
+
+    count = (This->x_weights.start[dst_x + dst_width - 1] + x_taps - src_data_x) * channels;
+
+    /* Vertical pass into the accumulator, keeping 7 bits of fraction. */
+    for (i = 0; i < count; i++)
+        accum[i] = 0;
+    for (k = 0; k < y_taps; k++)
+    {
+        const BYTE *src = src_data[k];
+        INT weight = weights[k];
+
+        for (i = 0; i < count; i++)
+            accum[i] += weight * src[i];
+    }
+    for (i = 0; i < count; i++)
+        accum[i] = (accum[i] + (1 << (SCALER_WEIGHT_BITS - 8))) >> (SCALER_WEIGHT_BITS - 7);
+
+    /* Horizontal pass. */
+    for (j = 0; j < dst_width; j++)
+    {
+        const INT *src = accum + (This->x_weights.start[dst_x + j] - src_data_x) * channels;
+
+        weights = This->x_weights.weights + (dst_x + j) * x_taps;
+        for (c = 0; c < channels; c++)
+        {
+            INT sum = 1 << (SCALER_WEIGHT_BITS + 6);
+
+            for (k = 0; k < x_taps; k++)
+                sum += weights[k] * src[k * channels + c];
+            sum >>= SCALER_WEIGHT_BITS + 7;
+            *pbBuffer++ = sum < 0 ? 0 : (sum > 255 ? 255 : sum);
+        }
+    }
+}
+
+static HRESULT prepare_row_cache(BitmapScaler *This, INT x, INT width, UINT rows)
+{
+    UINT stride = (width * This->bpp + 7) / 8;
+
+    if (This->cache && This->cache_x == x && This->cache_width == width)
+        return S_OK;
+
+    if (rows * stride > This->cache_size * This->cache_stride || rows > This->cache_size)
+    {
+        BYTE *cache;
+        BYTE **cache_rows;
+
+        cache = HeapAlloc(GetProcessHeap(), 0, rows * stride);
+        cache_rows = HeapAlloc(GetProcessHeap(), 0, rows * sizeof(*cache_rows));
+        if (!cache || !cache_rows)
+        {
+            HeapFree(GetProcessHeap(), 0, cache);
+            HeapFree(GetProcessHeap(), 0, cache_rows);
+            return E_OUTOFMEMORY;
+        }
+        HeapFree(GetProcessHeap(), 0, This->cache);
+        HeapFree(GetProcessHeap(), 0, This->cache_rows);
+        This->cache = cache;
+        This->cache_rows = cache_rows;
+    }
+
+    This->cache_size = rows;
+    This->cache_stride = stride;
+    This->cache_x = x;
+    This->cache_width = width;
+    This->cache_first = This->cache_count = 0;
+
+    return S_OK;
+}
+
+static HRESULT get_cached_rows(BitmapScaler *This, INT first, INT count)
+{
+    HRESULT hr;
+    WICRect rc;
+    INT y;
+
+    if (first < This->cache_first || first > This->cache_first + This->cache_count)
+    {
+        This->cache_first = first;
+        This->cache_count = 0;
+    }
+    else
+    {
+        This->cache_count -= first - This->cache_first;
+        This->cache_first = first;
+    }
+
+    rc.X = This->cache_x;
+    rc.Width = This->cache_width;
+    rc.Height = 1;
+    while (This->cache_count < count)
+    {
+        rc.Y = This->cache_first + This->cache_count;
+        hr = IWICBitmapSource_CopyPixels(This->source, &rc, This->cache_stride, This->cache_stride,
+            This->cache + (rc.Y % This->cache_size) * This->cache_stride);
+        if (FAILED(hr))
+        {
+            This->cache_count = 0;
+            return hr;
+        }
+        This->cache_count++;
+    }
+
+    for (y = 0; y < count; y++)
+        This->cache_rows[y] = This->cache + ((first + y) % This->cache_size) * This->cache_stride;
+
+    return S_OK;
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -197,12 +487,8 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     HRESULT hr;
     WICRect dest_rect;
     WICRect src_rect_ul, src_rect_br, src_rect;
-    BYTE **src_rows;
-    BYTE *src_bits;
     ULONG bytesperrow;
-    ULONG src_bytesperrow;
-    ULONG buffer_size;
-    UINT y;
+    INT y;
 
     TRACE("(%p,%p,%u,%u,%p)\n", iface, prc, cbStride, cbBufferSize, pbBuffer);
 
@@ -244,55 +530,38 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
         goto end;
     }
 
-    /* MSDN recommends calling CopyPixels once for each scanline from top to
-     * bottom, and claims codecs optimize for this. Ideally, when called in this
-     * way, we should avoid requesting a scanline from the source more than
-     * once, by saving the data that will be useful for the next scanline after
-     * the call returns. The GetRequiredSourceRect/CopyScanline functions are
-     * designed to make it possible to do this in a generic way, but for now we
-     * just grab all the data we need in each call. */
+    if (!dest_rect.Width || !dest_rect.Height)
+    {
+        hr = S_OK;
+        goto end;
+    }
+
+    /* We produce one scanline at a time, and keep the source rows that may
+     * still be needed in a small ring buffer, so each source row is requested
+     * only once, and memory use does not depend on the height of the image.
+     * The source may have changed since the last call, so cached rows are
+     * not reused across calls. */
 
     This->fn_get_required_source_rect(This, dest_rect.X, dest_rect.Y, &src_rect_ul);
     This->fn_get_required_source_rect(This, dest_rect.X+dest_rect.Width-1,
-        dest_rect.Y+dest_rect.Height-1, &src_rect_br);
+        dest_rect.Y, &src_rect_br);
 
     src_rect.X = src_rect_ul.X;
-    src_rect.Y = src_rect_ul.Y;
     src_rect.Width = src_rect_br.Width + src_rect_br.X - src_rect_ul.X;
-    src_rect.Height = src_rect_br.Height + src_rect_br.Y - src_rect_ul.Y;
-
-    src_bytesperrow = (src_rect.Width * This->bpp + 7)/8;
-    buffer_size = src_bytesperrow * src_rect.Height;
 
-    src_rows = HeapAlloc(GetProcessHeap(), 0, sizeof(BYTE*) * src_rect.Height);
-    src_bits = HeapAlloc(GetProcessHeap(), 0, buffer_size);
+    hr = prepare_row_cache(This, src_rect.X, src_rect.Width, src_rect_ul.Height);
+    This->cache_count = 0;
 
-    if (!src_rows || !src_bits)
+    for (y=0; SUCCEEDED(hr) && y < dest_rect.Height; y++)
     {
-        HeapFree(GetProcessHeap(), 0, src_rows);
-        HeapFree(GetProcessHeap(), 0, src_bits);
-        hr = E_OUTOFMEMORY;
-        goto end;
-    }
-
-    for (y=0; y<src_rect.Height; y++)
-        src_rows[y] = src_bits + y * src_bytesperrow;
+        This->fn_get_required_source_rect(This, dest_rect.X, dest_rect.Y+y, &src_rect);
 
-    hr = IWICBitmapSource_CopyPixels(This->source, &src_rect, src_bytesperrow,
-        buffer_size, src_bits);
-
-    if (SUCCEEDED(hr))
-    {
-        for (y=0; y < dest_rect.Height; y++)
-        {
+        hr = get_cached_rows(This, src_rect.Y, src_rect.Height);
+        if (SUCCEEDED(hr))
             This->fn_copy_scanline(This, dest_rect.X, dest_rect.Y+y, dest_rect.Width,
-                src_rows, src_rect.X, src_rect.Y, pbBuffer + cbStride * y);
-        }
+                This->cache_rows, src_rect_ul.X, src_rect.Y, pbBuffer + cbStride * y);
     }
 
-    HeapFree(GetProcessHeap(), 0, src_rows);
-    HeapFree(GetProcessHeap(), 0, src_bits);
-
 end:
     LeaveCriticalSection(&This->lock);
 
@@ -306,6 +575,7 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
     BitmapScaler *This = impl_from_IWICBitmapScaler(iface);
     HRESULT hr;
     GUID src_pixelformat;
+    BOOL filter;
 
     TRACE("(%p,%p,%u,%u,%u)\n", iface, pISource, uiWidth, uiHeight, mode);
 
@@ -337,22 +607,53 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
         {
         default:
             FIXME("unsupported mode %i\n", mode);
-            /* fall-through */
+            filter = FALSE;
+            break;
         case WICBitmapInterpolationModeNearestNeighbor:
-            if ((This->bpp % 8) == 0)
-            {
-                IWICBitmapSource_AddRef(pISource);
-                This->source = pISource;
-            }
-            else
+            filter = FALSE;
+            break;
+        case WICBitmapInterpolationModeLinear:
+        case WICBitmapInterpolationModeCubic:
+        case WICBitmapInterpolationModeFant:
+            /* Formats which are not byte aligned are converted to 32bppBGRA
+             * below, like for nearest neighbor. */
+            filter = (This->bpp % 8) != 0 || is_filter_format(&src_pixelformat);
+            if (!filter)
+                FIXME("interpolation not implemented for format %s\n", debugstr_guid(&src_pixelformat));
+            /* Nothing to interpolate from or to, nearest neighbor handles it. */
+            if (!This->src_width || !This->src_height || !This->width || !This->height)
+                filter = FALSE;
+            break;
+        }
+
+        if ((This->bpp % 8) == 0)
+        {
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+        }
+        else
+        {
+            hr = WICConvertBitmapSource(&GUID_WICPixelFormat32bppBGRA,
+                pISource, &This->source);
+            This->bpp = 32;
+        }
+
+        if (filter)
+        {
+            if (SUCCEEDED(hr))
+                hr = init_filter(This);
+            if (FAILED(hr) && This->source)
             {
-                hr = WICConvertBitmapSource(&GUID_WICPixelFormat32bppBGRA,
-                    pISource, &This->source);
-                This->bpp = 32;
+                IWICBitmapSource_Release(This->source);
+                This->source = NULL;
             }
+            This->fn_get_required_source_rect = Filter_GetRequiredSourceRect;
+            This->fn_copy_scanline = Filter_CopyScanline;
+        }
+        else
+        {
             This->fn_get_required_source_rect = NearestNeighbor_GetRequiredSourceRect;
             This->fn_copy_scanline = NearestNeighbor_CopyScanline;
-            break;
         }
     }
 
@@ -390,6 +691,15 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    memset(&This->x_weights, 0, sizeof(This->x_weights));
+    memset(&This->y_weights, 0, sizeof(This->y_weights));
+    This->accum = NULL;
+    This->cache = NULL;
+    This->cache_rows = NULL;
+    This->cache_size = 0;
+    This->cache_stride = 0;
+    This->cache_x = This->cache_width = 0;
+    This->cache_first = This->cache_count = 0;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
@@ -972,6 +972,178 @@ static void test_clipper(void)
     IWICBitmapClipper_Release(clipper);
 }
 
+static void test_scaler(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeNearestNeighbor,
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+    };
+    static const UINT sizes[][2] = { {3, 2}, {11, 7} };
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    DWORD src[7 * 5], whole[11 * 7], row[11];
+    UINT i, j, x, y, width, height;
+    WICRect rect;
+    HRESULT hr;
+
+    for (i = 0; i < ARRAY_SIZE(src); i++)
+        src[i] = 0x80c04020;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 7, 5, &GUID_WICPixelFormat32bppBGRA,
+        7 * 4, sizeof(src), (BYTE *)src, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(sizes); j++)
+        {
+            width = sizes[j][0];
+            height = sizes[j][1];
+
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "got 0x%08x\n", hr);
+
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, width, height, modes[i]);
+            ok(hr == S_OK, "mode %u: got 0x%08x\n", modes[i], hr);
+
+            /* a flat image stays flat in every mode */
+            memset(whole, 0, sizeof(whole));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, width * 4, sizeof(whole), (BYTE *)whole);
+            ok(hr == S_OK, "mode %u: got 0x%08x\n", modes[i], hr);
+            for (x = 0; x < width * height; x++)
+                ok(whole[x] == 0x80c04020, "mode %u, %ux%u: got %08x at %u\n",
+                   modes[i], width, height, whole[x], x);
+
+            /* copying one scanline at a time gives the same result */
+            rect.X = 0;
+            rect.Width = width;
+            rect.Height = 1;
+            for (y = 0; y < height; y++)
+            {
+                rect.Y = y;
+                memset(row, 0, sizeof(row));
+                hr = IWICBitmapScaler_CopyPixels(scaler, &rect, width * 4, sizeof(row), (BYTE *)row);
+                ok(hr == S_OK, "mode %u: got 0x%08x\n", modes[i], hr);
+                ok(!memcmp(row, whole + y * width, width * 4), "mode %u, %ux%u: row %u differs\n",
+                   modes[i], width, height, y);
+            }
+
+            IWICBitmapScaler_Release(scaler);
+        }
+    }
+
+    IWICBitmap_Release(bitmap);
+}
+
+static void test_scaler_interpolation(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmapLock *lock;
+    IWICBitmap *bitmap;
+    BYTE src[8 * 8], dst[4 * 4], *data;
+    UINT i, t, x, y, size;
+    WICPixelFormatGUID format;
+    WICRect rect;
+    HRESULT hr;
+
+    for (t = 0; t < 2; t++)
+    {
+        /* a gradient, and a checkerboard of single pixels */
+        for (y = 0; y < 8; y++)
+            for (x = 0; x < 8; x++)
+                src[y * 8 + x] = t ? ((x ^ y) & 1) * 255 : (x + y) * 16;
+
+        hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 8, &GUID_WICPixelFormat8bppGray,
+            8, sizeof(src), src, &bitmap);
+        ok(hr == S_OK, "got 0x%08x\n", hr);
+
+        for (i = 0; i < ARRAY_SIZE(modes); i++)
+        {
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "got 0x%08x\n", hr);
+
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 4, 4, modes[i]);
+            ok(hr == S_OK, "mode %u: got 0x%08x\n", modes[i], hr);
+
+            hr = IWICBitmapScaler_GetPixelFormat(scaler, &format);
+            ok(hr == S_OK, "got 0x%08x\n", hr);
+            ok(IsEqualGUID(&format, &GUID_WICPixelFormat8bppGray), "mode %u: got %s\n",
+               modes[i], wine_dbgstr_guid(&format));
+
+            memset(dst, 0xcc, sizeof(dst));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 4, sizeof(dst), dst);
+            ok(hr == S_OK, "mode %u: got 0x%08x\n", modes[i], hr);
+
+            /* Each destination pixel is centered between four source pixels,
+             * so the result is their average. The cubic filter reaches past
+             * the edge of the source, only check the inner pixels for it. */
+            for (y = 0; y < 4; y++)
+            {
+                for (x = 0; x < 4; x++)
+                {
+                    BYTE expect = t ? 128 : (x + y) * 32 + 16;
+
+                    if (modes[i] == WICBitmapInterpolationModeCubic && (x % 3 == 0 || y % 3 == 0))
+                        continue;
+                    ok(abs(dst[y * 4 + x] - expect) <= 1, "mode %u, source %u: got %u at %u,%u, expected %u\n",
+                       modes[i], t, dst[y * 4 + x], x, y, expect);
+                }
+            }
+
+            IWICBitmapScaler_Release(scaler);
+        }
+
+        IWICBitmap_Release(bitmap);
+    }
+
+    /* changes to the source are picked up by later calls */
+    memset(src, 0, sizeof(src));
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 8, 8, &GUID_WICPixelFormat8bppGray,
+        8, sizeof(src), src, &bitmap);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 4, 4, WICBitmapInterpolationModeFant);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+
+    rect.X = rect.Y = 0;
+    rect.Width = 4;
+    rect.Height = 1;
+    memset(dst, 0xcc, sizeof(dst));
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 4, 4, dst);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(!dst[0], "got %u\n", dst[0]);
+
+    rect.Width = 8;
+    rect.Height = 8;
+    hr = IWICBitmap_Lock(bitmap, &rect, WICBitmapLockWrite, &lock);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    hr = IWICBitmapLock_GetDataPointer(lock, &size, &data);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    memset(data, 0xff, size);
+    IWICBitmapLock_Release(lock);
+
+    rect.Width = 4;
+    rect.Height = 1;
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 4, 4, dst);
+    ok(hr == S_OK, "got 0x%08x\n", hr);
+    ok(dst[0] == 0xff, "got %u\n", dst[0]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
 static HRESULT (WINAPI *pWICCreateBitmapFromSectionEx)
     (UINT, UINT, REFWICPixelFormatGUID, HANDLE, UINT, UINT, WICSectionAccessLevel, IWICBitmap **);
 
@@ -1046,6 +1218,8 @@ START_TEST(bitmap)
     test_CreateBitmapFromHICON();
     test_CreateBitmapFromHBITMAP();
     test_clipper();
+    test_scaler();
+    test_scaler_interpolation();
 
     IWICImagingFactory_Release(factory);
 
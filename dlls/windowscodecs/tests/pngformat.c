@@ -658,7 +658,7 @@ static void test_color_formats(void)
         const GUID *format_PLTE;
         const GUID *format_PLTE_tRNS;
         BOOL todo;
-        BOOL todo_load;
+        BOOL todo_decode;
     } td[] =
     {
         /* 2 - PNG_COLOR_TYPE_RGB */
@@ -666,11 +666,11 @@ static void test_color_formats(void)
         { 2, 2, NULL, NULL, NULL },
         { 4, 2, NULL, NULL, NULL },
         { 8, 2, &GUID_WICPixelFormat24bppBGR, &GUID_WICPixelFormat24bppBGR, &GUID_WICPixelFormat24bppBGR },
-        /* libpng refuses to load our test image complaining about extra compressed data,
-         * but libpng is still able to load the image with other combination of type/depth
-         * making RGB 16 bpp case special for some reason. Therefore todo = TRUE.
+        /* libpng refuses to decode our test image complaining about extra compressed data,
+         * but libpng is still able to decode the image with other combination of type/depth
+         * making RGB 16 bpp case special for some reason. Therefore todo_decode = TRUE.
          */
-        { 16, 2, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, TRUE, TRUE },
+        { 16, 2, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, &GUID_WICPixelFormat48bppRGB, FALSE, TRUE },
         { 24, 2, NULL, NULL, NULL },
         { 32, 2, NULL, NULL, NULL },
         /* 0 - PNG_COLOR_TYPE_GRAY */
@@ -691,6 +691,7 @@ static void test_color_formats(void)
         { 32, 3,  NULL, NULL, NULL },
     };
     char buf[sizeof(png_1x1_data)];
+    BYTE pixels[8];
     HRESULT hr;
     IWICBitmapDecoder *decoder;
     IWICBitmapFrameDecode *frame;
@@ -729,7 +730,6 @@ static void test_color_formats(void)
 todo_wine
             ok(hr == WINCODEC_ERR_UNKNOWNIMAGEFORMAT, "%d: wrong error %#x\n", i, hr);
         else
-todo_wine_if(td[i].todo_load)
             ok(hr == S_OK, "%d: Failed to load PNG image data (type %d, bpp %d) %#x\n", i, td[i].color_type, td[i].bit_depth, hr);
         if (hr != S_OK) goto next_1;
 
@@ -743,6 +743,10 @@ todo_wine_if(td[i].todo)
            "PLTE+tRNS: expected %s, got %s (type %d, bpp %d)\n",
             wine_dbgstr_guid(td[i].format_PLTE_tRNS), wine_dbgstr_guid(&format), td[i].color_type, td[i].bit_depth);
 
+        hr = IWICBitmapFrameDecode_CopyPixels(frame, NULL, sizeof(pixels), sizeof(pixels), pixels);
+todo_wine_if(td[i].todo_decode)
+        ok(hr == S_OK, "%d: CopyPixels error %#x\n", i, hr);
+
         IWICBitmapFrameDecode_Release(frame);
         IWICBitmapDecoder_Release(decoder);
 
@@ -758,7 +762,6 @@ next_1:
 todo_wine
             ok(hr == WINCODEC_ERR_UNKNOWNIMAGEFORMAT, "%d: wrong error %#x\n", i, hr);
         else
-todo_wine_if(td[i].todo_load)
             ok(hr == S_OK, "%d: Failed to load PNG image data (type %d, bpp %d) %#x\n", i, td[i].color_type, td[i].bit_depth, hr);
         if (hr != S_OK) goto next_2;
 
@@ -771,6 +774,10 @@ todo_wine_if(td[i].todo_load)
            "PLTE: expected %s, got %s (type %d, bpp %d)\n",
             wine_dbgstr_guid(td[i].format_PLTE), wine_dbgstr_guid(&format), td[i].color_type, td[i].bit_depth);
 
+        hr = IWICBitmapFrameDecode_CopyPixels(frame, NULL, sizeof(pixels), sizeof(pixels), pixels);
+todo_wine_if(td[i].todo_decode)
+        ok(hr == S_OK, "%d: CopyPixels error %#x\n", i, hr);
+
         IWICBitmapFrameDecode_Release(frame);
         IWICBitmapDecoder_Release(decoder);
 
@@ -787,7 +794,6 @@ next_2:
 todo_wine
             ok(hr == WINCODEC_ERR_UNKNOWNIMAGEFORMAT, "%d: wrong error %#x\n", i, hr);
         else
-todo_wine_if(td[i].todo_load)
             ok(hr == S_OK, "%d: Failed to load PNG image data (type %d, bpp %d) %#x\n", i, td[i].color_type, td[i].bit_depth, hr);
         if (hr != S_OK) goto next_3;
 
@@ -800,6 +806,10 @@ todo_wine_if(td[i].todo_load)
            "expected %s, got %s (type %d, bpp %d)\n",
             wine_dbgstr_guid(td[i].format), wine_dbgstr_guid(&format), td[i].color_type, td[i].bit_depth);
 
+        hr = IWICBitmapFrameDecode_CopyPixels(frame, NULL, sizeof(pixels), sizeof(pixels), pixels);
+todo_wine_if(td[i].todo_decode)
+        ok(hr == S_OK, "%d: CopyPixels error %#x\n", i, hr);
+
         IWICBitmapFrameDecode_Release(frame);
         IWICBitmapDecoder_Release(decoder);
 
@@ -815,7 +825,6 @@ next_3:
 todo_wine
             ok(hr == WINCODEC_ERR_UNKNOWNIMAGEFORMAT, "%d: wrong error %#x\n", i, hr);
         else
-todo_wine_if(td[i].todo_load)
             ok(hr == S_OK, "%d: Failed to load PNG image data (type %d, bpp %d) %#x\n", i, td[i].color_type, td[i].bit_depth, hr);
         if (hr != S_OK) continue;
 
@@ -829,6 +838,10 @@ todo_wine_if(td[i].todo)
            "tRNS: expected %s, got %s (type %d, bpp %d)\n",
             wine_dbgstr_guid(td[i].format_PLTE_tRNS), wine_dbgstr_guid(&format), td[i].color_type, td[i].bit_depth);
 
+        hr = IWICBitmapFrameDecode_CopyPixels(frame, NULL, sizeof(pixels), sizeof(pixels), pixels);
+todo_wine_if(td[i].todo_decode)
+        ok(hr == S_OK, "%d: CopyPixels error %#x\n", i, hr);
+
         IWICBitmapFrameDecode_Release(frame);
         IWICBitmapDecoder_Release(decoder);
     }
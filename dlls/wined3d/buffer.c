@@ -793,6 +793,7 @@ ULONG CDECL wined3d_buffer_decref(struct wined3d_buffer *buffer)
 
     if (!refcount)
     {
+        wined3d_cs_release_upload_bo(buffer);
         buffer->resource.parent_ops->wined3d_object_destroyed(buffer->resource.parent);
         resource_cleanup(&buffer->resource);
         wined3d_cs_destroy_object(buffer->resource.device->cs, wined3d_buffer_destroy_object, buffer);
@@ -889,7 +890,9 @@ void wined3d_buffer_load(struct wined3d_buffer *buffer, struct wined3d_context *
 
     TRACE("buffer %p.\n", buffer);
 
-    if (buffer->resource.map_count)
+    /* Streamed maps don't map the buffer's own storage, see
+     * wined3d_cs_map_upload_bo(). */
+    if (buffer->resource.map_count > *(volatile unsigned int *)&buffer->upload_map_count)
     {
         WARN("Buffer is mapped, skipping preload.\n");
         return;
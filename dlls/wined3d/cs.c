@@ -21,6 +21,7 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
 
@@ -76,6 +77,19 @@ enum wined3d_cs_op
     WINED3D_CS_OP_STOP,
 };
 
+struct wined3d_cs_stats
+{
+    unsigned int op_count[WINED3D_CS_OP_STOP];
+    unsigned int stall_count[WINED3D_CS_QUEUE_COUNT];
+    unsigned int finish_wait_count[WINED3D_CS_QUEUE_COUNT];
+    unsigned int max_queue_depth[WINED3D_CS_QUEUE_COUNT];
+    unsigned int inline_upload_count;
+    unsigned int heap_upload_count;
+    unsigned int sync_upload_count;
+    unsigned int upload_bo_count;
+    unsigned int upload_bo_fallback_count;
+};
+
 struct wined3d_cs_packet
 {
     size_t size;
@@ -408,6 +422,9 @@ struct wined3d_cs_update_sub_resource
     unsigned int sub_resource_idx;
     struct wined3d_box box;
     struct wined3d_sub_resource_data data;
+    void *upload;
+    LONG upload_size;
+    struct wined3d_cs_upload_block *upload_block;
 };
 
 struct wined3d_cs_add_dirty_texture_region
@@ -2235,6 +2252,9 @@ void wined3d_cs_emit_blt_sub_resource(struct wined3d_cs *cs, struct wined3d_reso
 {
     struct wined3d_cs_blt_sub_resource *op;
 
+    if (dst_resource->type == WINED3D_RTYPE_BUFFER)
+        wined3d_cs_release_upload_bo(buffer_from_resource(dst_resource));
+
     op = cs->ops->require_space(cs, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
     op->opcode = WINED3D_CS_OP_BLT_SUB_RESOURCE;
     op->dst_resource = dst_resource;
@@ -2276,6 +2296,20 @@ static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const voi
     {
         struct wined3d_buffer *buffer = buffer_from_resource(resource);
 
+        /* The BO may have been dropped after the update was queued. */
+        if (!(buffer->flags & WINED3D_BUFFER_USE_BO))
+        {
+            if (!wined3d_buffer_load_location(buffer, context, WINED3D_LOCATION_SYSMEM))
+            {
+                ERR("Failed to load buffer location.\n");
+                goto done;
+            }
+
+            memcpy((BYTE *)buffer->resource.heap_memory + box->left, op->data.data, box->right - box->left);
+            wined3d_buffer_invalidate_location(buffer, ~WINED3D_LOCATION_SYSMEM);
+            goto done;
+        }
+
         if (!wined3d_buffer_load_location(buffer, context, WINED3D_LOCATION_BUFFER))
         {
             ERR("Failed to load buffer location.\n");
@@ -2316,15 +2350,95 @@ done:
     context_release(context);
 
     wined3d_resource_release(resource);
+
+    if (op->upload)
+    {
+        heap_free(op->upload);
+        InterlockedExchangeAdd(&cs->pending_upload_size, -op->upload_size);
+    }
+    if (op->upload_block)
+        InterlockedDecrement(&op->upload_block->refcount);
+}
+
+static size_t wined3d_cs_get_update_size(const struct wined3d_resource *resource,
+        const struct wined3d_box *box, unsigned int row_pitch, unsigned int slice_pitch)
+{
+    unsigned int width, height, depth, row_count;
+    unsigned int row_size, size;
+
+    width = box->right - box->left;
+    if (resource->type == WINED3D_RTYPE_BUFFER)
+        return width;
+
+    height = box->bottom - box->top;
+    depth = box->back - box->front;
+    /* This takes care of block based and height scaled formats. */
+    wined3d_format_calculate_pitch(resource->format, 1, width, height, &row_size, &size);
+    row_count = size / row_size;
+
+    return (size_t)(depth - 1) * slice_pitch + (size_t)(row_count - 1) * row_pitch + row_size;
 }
 
 void wined3d_cs_emit_update_sub_resource(struct wined3d_cs *cs, struct wined3d_resource *resource,
         unsigned int sub_resource_idx, const struct wined3d_box *box, const void *data, unsigned int row_pitch,
         unsigned int slice_pitch)
 {
+    enum wined3d_cs_queue_id queue_id = WINED3D_CS_QUEUE_MAP;
     struct wined3d_cs_update_sub_resource *op;
+    size_t size = 0, op_size = sizeof(*op);
+    void *upload = NULL;
 
-    op = cs->ops->require_space(cs, sizeof(*op), WINED3D_CS_QUEUE_MAP);
+    if (resource->type == WINED3D_RTYPE_BUFFER)
+        wined3d_cs_release_upload_bo(buffer_from_resource(resource));
+
+    /* The data pointer may go away once we return. Unless the command is
+     * executed right away, copy small updates into the command stream and
+     * larger ones into a separate upload buffer, so that we don't have to
+     * wait for the CS thread. Such updates are queued on the default queue,
+     * and are therefore ordered with the commands that use the resource. */
+    if (cs->thread && cs->thread_id != GetCurrentThreadId())
+    {
+        size = wined3d_cs_get_update_size(resource, box, row_pitch, slice_pitch);
+
+        if (size <= WINED3D_CS_INLINE_UPLOAD_SIZE)
+        {
+            op_size += size;
+            queue_id = WINED3D_CS_QUEUE_DEFAULT;
+            if (cs->stats)
+                ++cs->stats->inline_upload_count;
+        }
+        else if (*(volatile LONG *)&cs->pending_upload_size + size <= WINED3D_CS_MAX_PENDING_UPLOAD
+                && (upload = heap_alloc(size)))
+        {
+            memcpy(upload, data, size);
+            data = upload;
+            InterlockedExchangeAdd(&cs->pending_upload_size, size);
+            queue_id = WINED3D_CS_QUEUE_DEFAULT;
+            if (cs->stats)
+                ++cs->stats->heap_upload_count;
+        }
+        else
+        {
+            TRACE_(d3d_perf)("Synchronous update of %lu bytes, %d bytes pending.\n",
+                    (unsigned long)size, cs->pending_upload_size);
+        }
+    }
+
+    /* Commands on the map queue are executed before commands on the default
+     * queue, so make sure earlier commands are done with the resource. */
+    if (queue_id == WINED3D_CS_QUEUE_MAP)
+    {
+        wined3d_resource_wait_idle(resource);
+        if (cs->stats)
+            ++cs->stats->sync_upload_count;
+    }
+
+    op = cs->ops->require_space(cs, op_size, queue_id);
+    if (op_size > sizeof(*op))
+    {
+        memcpy(op + 1, data, size);
+        data = op + 1;
+    }
     op->opcode = WINED3D_CS_OP_UPDATE_SUB_RESOURCE;
     op->resource = resource;
     op->sub_resource_idx = sub_resource_idx;
@@ -2332,13 +2446,233 @@ void wined3d_cs_emit_update_sub_resource(struct wined3d_cs *cs, struct wined3d_r
     op->data.row_pitch = row_pitch;
     op->data.slice_pitch = slice_pitch;
     op->data.data = data;
+    op->upload = upload;
+    op->upload_size = upload ? size : 0;
+    op->upload_block = NULL;
 
     wined3d_resource_acquire(resource);
 
-    cs->ops->submit(cs, WINED3D_CS_QUEUE_MAP);
-    /* The data pointer may go away, so we need to wait until it is read.
-     * Copying the data may be faster if it's small. */
-    cs->ops->finish(cs, WINED3D_CS_QUEUE_MAP);
+    cs->ops->submit(cs, queue_id);
+    if (queue_id == WINED3D_CS_QUEUE_MAP)
+        cs->ops->finish(cs, queue_id);
+}
+
+static BYTE *wined3d_cs_upload_block_get_data(struct wined3d_cs_upload_block *block)
+{
+    return (BYTE *)block + RESOURCE_ALIGNMENT;
+}
+
+/* The upload ring is only accessed by the application thread. The CS thread
+ * releases blocks by decrementing their reference count, and the space is
+ * reclaimed here, in allocation order. */
+static struct wined3d_cs_upload_block *wined3d_cs_upload_ring_try_alloc(struct wined3d_cs_upload_ring *ring,
+        size_t size)
+{
+    struct wined3d_cs_upload_block *block;
+    size_t remaining;
+
+    while (ring->used)
+    {
+        block = (struct wined3d_cs_upload_block *)&ring->data[ring->tail];
+        if (*(volatile LONG *)&block->refcount)
+            break;
+        ring->tail = (ring->tail + block->size) & (WINED3D_CS_UPLOAD_RING_SIZE - 1);
+        ring->used -= block->size;
+    }
+
+    remaining = WINED3D_CS_UPLOAD_RING_SIZE - ring->head;
+    if (remaining < size)
+    {
+        if (ring->used + remaining + size > WINED3D_CS_UPLOAD_RING_SIZE)
+            return NULL;
+
+        /* Pad the end of the ring with an unused block. */
+        block = (struct wined3d_cs_upload_block *)&ring->data[ring->head];
+        block->refcount = 0;
+        block->size = remaining;
+        block->owner = NULL;
+        ring->head = 0;
+        ring->used += remaining;
+    }
+
+    if (ring->used + size > WINED3D_CS_UPLOAD_RING_SIZE)
+        return NULL;
+
+    block = (struct wined3d_cs_upload_block *)&ring->data[ring->head];
+    block->refcount = 1;
+    block->size = size;
+    block->owner = NULL;
+    ring->head = (ring->head + size) & (WINED3D_CS_UPLOAD_RING_SIZE - 1);
+    ring->used += size;
+
+    return block;
+}
+
+static struct wined3d_cs_upload_block *wined3d_cs_upload_ring_alloc(struct wined3d_cs *cs, size_t size)
+{
+    struct wined3d_cs_upload_ring *ring = &cs->upload_ring;
+    struct wined3d_cs_upload_block *block;
+
+    if (!ring->mem)
+    {
+        if (!(ring->mem = heap_alloc(WINED3D_CS_UPLOAD_RING_SIZE + RESOURCE_ALIGNMENT - 1)))
+            return NULL;
+        ring->data = (BYTE *)(((ULONG_PTR)ring->mem + RESOURCE_ALIGNMENT - 1) & ~(RESOURCE_ALIGNMENT - 1));
+    }
+
+    size = (RESOURCE_ALIGNMENT + size + RESOURCE_ALIGNMENT - 1) & ~(RESOURCE_ALIGNMENT - 1);
+    if ((block = wined3d_cs_upload_ring_try_alloc(ring, size)))
+        return block;
+
+    /* Since blocks are reclaimed in order, a buffer that keeps its block
+     * around, e.g. because it's only mapped with NOOVERWRITE, can hold up the
+     * entire ring. Evict it; the buffer falls back to regular maps until its
+     * next DISCARD map. */
+    block = (struct wined3d_cs_upload_block *)&ring->data[ring->tail];
+    if (!ring->used || !block->owner || block->owner->upload_map_count)
+        return NULL;
+    TRACE_(d3d_perf)("Evicting upload block of buffer %p.\n", block->owner);
+    wined3d_cs_release_upload_bo(block->owner);
+
+    return wined3d_cs_upload_ring_try_alloc(ring, size);
+}
+
+void wined3d_cs_release_upload_bo(struct wined3d_buffer *buffer)
+{
+    if (!buffer->upload_block)
+        return;
+
+    if (buffer->upload_map_count)
+    {
+        WARN("Buffer %p is still mapped.\n", buffer);
+        buffer->resource.map_count -= buffer->upload_map_count;
+        buffer->upload_map_count = 0;
+    }
+
+    buffer->upload_block->owner = NULL;
+    InterlockedDecrement(&buffer->upload_block->refcount);
+    buffer->upload_block = NULL;
+}
+
+/* DISCARD maps of dynamic buffers return a new block from the upload ring,
+ * and NOOVERWRITE maps return the block of the previous DISCARD map, so that
+ * these maps don't need to synchronise with the CS thread. The mapped range
+ * is uploaded by the CS thread when the buffer is unmapped; the rest of the
+ * buffer keeps its contents. */
+BOOL wined3d_cs_map_upload_bo(struct wined3d_cs *cs, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, struct wined3d_map_desc *map_desc,
+        const struct wined3d_box *box, DWORD flags)
+{
+    struct wined3d_cs_upload_block *block;
+    struct wined3d_buffer *buffer;
+    unsigned int start, end;
+
+    if (resource->type != WINED3D_RTYPE_BUFFER || sub_resource_idx)
+        return FALSE;
+    buffer = buffer_from_resource(resource);
+
+    /* A size of 0 maps the rest of the buffer, see wined3d_buffer_map(). */
+    start = box ? min(box->left, resource->size) : 0;
+    end = box && box->right > box->left ? min(box->right, resource->size) : resource->size;
+
+    /* Nested maps return the same memory. */
+    if (buffer->upload_map_count)
+    {
+        ++buffer->upload_map_count;
+        ++resource->map_count;
+        buffer->upload_start = min(buffer->upload_start, start);
+        buffer->upload_end = max(buffer->upload_end, end);
+        goto done;
+    }
+
+    if (!cs->thread || cs->thread_id == GetCurrentThreadId() || resource->map_count
+            || (flags & WINED3D_MAP_READ) || !(flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_NOOVERWRITE))
+            || !(buffer->flags & WINED3D_BUFFER_USE_BO) || (buffer->flags & WINED3D_BUFFER_PIN_SYSMEM)
+            || resource->size > WINED3D_CS_MAX_UPLOAD_BO_SIZE)
+        goto fallback;
+
+    if (flags & WINED3D_MAP_DISCARD)
+    {
+        if (!(block = wined3d_cs_upload_ring_alloc(cs, resource->size)))
+        {
+            TRACE_(d3d_perf)("Upload ring full, mapping buffer %p synchronously.\n", buffer);
+            goto fallback;
+        }
+
+        /* Only the mapped range is uploaded, so the rest of the buffer keeps
+         * its contents. Within the mapped range, bytes the application
+         * doesn't write keep the data of the previous block, if there is
+         * one; some applications depend on this. Without a previous block
+         * they are undefined, like for DISCARD maps on Windows. */
+        if (buffer->upload_block)
+        {
+            memcpy(wined3d_cs_upload_block_get_data(block),
+                    wined3d_cs_upload_block_get_data(buffer->upload_block), resource->size);
+            wined3d_cs_release_upload_bo(buffer);
+        }
+        buffer->upload_block = block;
+        block->owner = buffer;
+    }
+    else if (!buffer->upload_block)
+    {
+        goto fallback;
+    }
+    buffer->upload_start = start;
+    buffer->upload_end = end;
+    /* upload_map_count is incremented first and decremented last, so that
+     * wined3d_buffer_load() never mistakes a streamed map for a regular one. */
+    buffer->upload_map_count = 1;
+    ++resource->map_count;
+
+    if (cs->stats)
+        ++cs->stats->upload_bo_count;
+
+done:
+    map_desc->row_pitch = map_desc->slice_pitch = buffer->desc.byte_width;
+    map_desc->data = wined3d_cs_upload_block_get_data(buffer->upload_block) + start;
+    return TRUE;
+
+fallback:
+    /* Regular maps don't see the contents of the upload block. */
+    wined3d_cs_release_upload_bo(buffer);
+    if (cs->stats && (flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_NOOVERWRITE)))
+        ++cs->stats->upload_bo_fallback_count;
+    return FALSE;
+}
+
+BOOL wined3d_cs_unmap_upload_bo(struct wined3d_cs *cs, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx)
+{
+    struct wined3d_cs_update_sub_resource *op;
+    struct wined3d_buffer *buffer;
+
+    if (resource->type != WINED3D_RTYPE_BUFFER || sub_resource_idx)
+        return FALSE;
+    buffer = buffer_from_resource(resource);
+
+    if (!buffer->upload_map_count)
+        return FALSE;
+    --resource->map_count;
+    if (--buffer->upload_map_count)
+        return TRUE;
+
+    op = cs->ops->require_space(cs, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
+    op->opcode = WINED3D_CS_OP_UPDATE_SUB_RESOURCE;
+    op->resource = resource;
+    op->sub_resource_idx = 0;
+    wined3d_box_set(&op->box, buffer->upload_start, 0, buffer->upload_end, 1, 0, 1);
+    op->data.row_pitch = op->data.slice_pitch = buffer->desc.byte_width;
+    op->data.data = wined3d_cs_upload_block_get_data(buffer->upload_block) + buffer->upload_start;
+    op->upload = NULL;
+    op->upload_size = 0;
+    op->upload_block = buffer->upload_block;
+
+    InterlockedIncrement(&buffer->upload_block->refcount);
+    wined3d_resource_acquire(resource);
+
+    cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
+
+    return TRUE;
 }
 
 static void wined3d_cs_exec_add_dirty_texture_region(struct wined3d_cs *cs, const void *data)
@@ -2464,7 +2798,6 @@ static void wined3d_cs_emit_stop(struct wined3d_cs *cs)
     op->opcode = WINED3D_CS_OP_STOP;
 
     cs->ops->submit(cs, WINED3D_CS_QUEUE_DEFAULT);
-    cs->ops->finish(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
 static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void *data) =
@@ -2555,9 +2888,15 @@ static void wined3d_cs_st_submit(struct wined3d_cs *cs, enum wined3d_cs_queue_id
 
     opcode = *(const enum wined3d_cs_op *)&data[start];
     if (opcode >= WINED3D_CS_OP_STOP)
+    {
         ERR("Invalid opcode %#x.\n", opcode);
+    }
     else
+    {
+        if (cs->stats)
+            ++cs->stats->op_count[opcode];
         wined3d_cs_op_handlers[opcode](cs, &data[start]);
+    }
 
     if (cs->data == data)
         cs->start = cs->end = start;
@@ -2583,14 +2922,87 @@ static BOOL wined3d_cs_queue_is_empty(const struct wined3d_cs *cs, const struct
     return *(volatile LONG *)&queue->head == queue->tail;
 }
 
+/* Returns TRUE if the CS thread has consumed enough of the queue for a packet
+ * of "packet_size" bytes to fit, or, if "packet_size" is 0, if the queue is
+ * empty. */
+static BOOL wined3d_cs_queue_is_ready(const struct wined3d_cs_queue *queue, size_t packet_size)
+{
+    LONG tail = *(volatile LONG *)&queue->tail;
+    LONG head = queue->head;
+    LONG new_pos;
+
+    /* Empty. */
+    if (head == tail)
+        return TRUE;
+    if (!packet_size)
+        return FALSE;
+    new_pos = (head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1);
+    /* Head ahead of tail. We checked the remaining size before, so we only
+     * need to make sure we don't make head equal to tail. */
+    if (head > tail && (new_pos != tail))
+        return TRUE;
+    /* Tail ahead of head. Make sure the new head is before the tail as
+     * well. Note that new_pos is 0 when it's at the end of the queue. */
+    if (new_pos < tail && new_pos)
+        return TRUE;
+    return FALSE;
+}
+
+/* Wait for the CS thread to make progress on "queue". We spin for a little
+ * while, since the CS thread is usually close behind, and then block on
+ * "progress_event", which the CS thread signals after retiring a packet if
+ * "waiting_for_progress" is set. */
+static void wined3d_cs_queue_wait(struct wined3d_cs *cs, const struct wined3d_cs_queue *queue, size_t packet_size)
+{
+    unsigned int spin_count = 0;
+
+    for (;;)
+    {
+        if (wined3d_cs_queue_is_ready(queue, packet_size))
+            return;
+
+        if (++spin_count < WINED3D_CS_WAIT_SPIN_COUNT)
+        {
+            wined3d_pause();
+            continue;
+        }
+
+        InterlockedExchange(&cs->waiting_for_progress, TRUE);
+
+        /* Like in wined3d_cs_wait_event(), the CS thread may have made
+         * progress before "waiting_for_progress" was set. If it also reset
+         * "waiting_for_progress" in the meantime, it has signalled the
+         * event, and we need to consume that signal. */
+        if (wined3d_cs_queue_is_ready(queue, packet_size))
+        {
+            if (!InterlockedCompareExchange(&cs->waiting_for_progress, FALSE, TRUE))
+                WaitForSingleObject(cs->progress_event, INFINITE);
+            return;
+        }
+
+        WaitForSingleObject(cs->progress_event, INFINITE);
+    }
+}
+
 static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined3d_cs *cs)
 {
     struct wined3d_cs_packet *packet;
     size_t packet_size;
+    LONG head;
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
-    InterlockedExchange(&queue->head, (queue->head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1));
+    head = (queue->head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1);
+    InterlockedExchange(&queue->head, head);
+
+    if (cs->stats)
+    {
+        unsigned int depth = (head - *(volatile LONG *)&queue->tail) & (WINED3D_CS_QUEUE_SIZE - 1);
+        unsigned int queue_id = queue - cs->queue;
+
+        if (depth > cs->stats->max_queue_depth[queue_id])
+            cs->stats->max_queue_depth[queue_id] = depth;
+    }
 
     if (InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
         SetEvent(cs->event);
@@ -2637,27 +3049,13 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
         assert(!queue->head);
     }
 
-    for (;;)
+    if (!wined3d_cs_queue_is_ready(queue, packet_size))
     {
-        LONG tail = *(volatile LONG *)&queue->tail;
-        LONG head = queue->head;
-        LONG new_pos;
-
-        /* Empty. */
-        if (head == tail)
-            break;
-        new_pos = (head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1);
-        /* Head ahead of tail. We checked the remaining size above, so we only
-         * need to make sure we don't make head equal to tail. */
-        if (head > tail && (new_pos != tail))
-            break;
-        /* Tail ahead of head. Make sure the new head is before the tail as
-         * well. Note that new_pos is 0 when it's at the end of the queue. */
-        if (new_pos < tail && new_pos)
-            break;
-
         TRACE("Waiting for free space. Head %u, tail %u, packet size %lu.\n",
-                head, tail, (unsigned long)packet_size);
+                queue->head, queue->tail, (unsigned long)packet_size);
+        if (cs->stats)
+            ++cs->stats->stall_count[queue - cs->queue];
+        wined3d_cs_queue_wait(cs, queue, packet_size);
     }
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
@@ -2675,11 +3073,17 @@ static void *wined3d_cs_mt_require_space(struct wined3d_cs *cs, size_t size, enu
 
 static void wined3d_cs_mt_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
 {
+    struct wined3d_cs_queue *queue = &cs->queue[queue_id];
+
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(cs, queue_id);
 
-    while (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
-        wined3d_pause();
+    if (wined3d_cs_queue_is_ready(queue, 0))
+        return;
+
+    if (cs->stats)
+        ++cs->stats->finish_wait_count[queue_id];
+    wined3d_cs_queue_wait(cs, queue, 0);
 }
 
 static const struct wined3d_cs_ops wined3d_cs_mt_ops =
@@ -2778,6 +3182,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
                 break;
             }
 
+            if (cs->stats)
+                ++cs->stats->op_count[opcode];
             wined3d_cs_op_handlers[opcode](cs, packet->data);
             TRACE("%s executed.\n", debug_cs_op(opcode));
         }
@@ -2785,10 +3191,17 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
         tail += FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
         tail &= (WINED3D_CS_QUEUE_SIZE - 1);
         InterlockedExchange(&queue->tail, tail);
+
+        if (*(volatile LONG *)&cs->waiting_for_progress
+                && InterlockedCompareExchange(&cs->waiting_for_progress, FALSE, TRUE))
+            SetEvent(cs->progress_event);
     }
 
+    /* wined3d_cs_destroy() spins on the default queue here, since "cs" may
+     * be freed as soon as it sees the queue as empty. Don't touch "cs"
+     * after this. */
     cs->queue[WINED3D_CS_QUEUE_MAP].tail = cs->queue[WINED3D_CS_QUEUE_MAP].head;
-    cs->queue[WINED3D_CS_QUEUE_DEFAULT].tail = cs->queue[WINED3D_CS_QUEUE_DEFAULT].head;
+    InterlockedExchange(&cs->queue[WINED3D_CS_QUEUE_DEFAULT].tail, cs->queue[WINED3D_CS_QUEUE_DEFAULT].head);
     TRACE("Stopped.\n");
     FreeLibraryAndExitThread(wined3d_module, 0);
 }
@@ -2811,6 +3224,9 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
     if (!(cs->data = heap_alloc(cs->data_size)))
         goto fail;
 
+    if (TRACE_ON(d3d_perf))
+        cs->stats = heap_alloc_zero(sizeof(*cs->stats));
+
     if (wined3d_settings.cs_multithreaded
             && !RtlIsCriticalSectionLockedByThread(NtCurrentTeb()->Peb->LoaderLock))
     {
@@ -2823,10 +3239,19 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
             goto fail;
         }
 
+        if (!(cs->progress_event = CreateEventW(NULL, FALSE, FALSE, NULL)))
+        {
+            ERR("Failed to create command stream progress event.\n");
+            CloseHandle(cs->event);
+            heap_free(cs->data);
+            goto fail;
+        }
+
         if (!(GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
                 (const WCHAR *)wined3d_cs_run, &cs->wined3d_module)))
         {
             ERR("Failed to get wined3d module handle.\n");
+            CloseHandle(cs->progress_event);
             CloseHandle(cs->event);
             heap_free(cs->data);
             goto fail;
@@ -2836,6 +3261,7 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
         {
             ERR("Failed to create wined3d command stream thread.\n");
             FreeLibrary(cs->wined3d_module);
+            CloseHandle(cs->progress_event);
             CloseHandle(cs->event);
             heap_free(cs->data);
             goto fail;
@@ -2846,21 +3272,51 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
 
 fail:
     state_cleanup(&cs->state);
+    heap_free(cs->stats);
     heap_free(cs);
     return NULL;
 }
 
+static void wined3d_cs_dump_stats(const struct wined3d_cs *cs)
+{
+    const struct wined3d_cs_stats *stats = cs->stats;
+    unsigned int i;
+
+    TRACE_(d3d_perf)("cs %p: %u/%u stalls, %u/%u finish waits, max queue depth %u/%u bytes (default/map).\n",
+            cs, stats->stall_count[WINED3D_CS_QUEUE_DEFAULT], stats->stall_count[WINED3D_CS_QUEUE_MAP],
+            stats->finish_wait_count[WINED3D_CS_QUEUE_DEFAULT], stats->finish_wait_count[WINED3D_CS_QUEUE_MAP],
+            stats->max_queue_depth[WINED3D_CS_QUEUE_DEFAULT], stats->max_queue_depth[WINED3D_CS_QUEUE_MAP]);
+    TRACE_(d3d_perf)("cs %p: %u inline, %u out-of-band, %u synchronous sub-resource updates.\n",
+            cs, stats->inline_upload_count, stats->heap_upload_count, stats->sync_upload_count);
+    TRACE_(d3d_perf)("cs %p: %u streamed buffer maps, %u fallbacks.\n",
+            cs, stats->upload_bo_count, stats->upload_bo_fallback_count);
+    for (i = 0; i < ARRAY_SIZE(stats->op_count); ++i)
+    {
+        if (stats->op_count[i])
+            TRACE_(d3d_perf)("cs %p: %s executed %u times.\n", cs, debug_cs_op(i), stats->op_count[i]);
+    }
+}
+
 void wined3d_cs_destroy(struct wined3d_cs *cs)
 {
     if (cs->thread)
     {
         wined3d_cs_emit_stop(cs);
+        while (!wined3d_cs_queue_is_ready(&cs->queue[WINED3D_CS_QUEUE_DEFAULT], 0))
+            wined3d_pause();
         CloseHandle(cs->thread);
+        if (!CloseHandle(cs->progress_event))
+            ERR("Closing progress event failed.\n");
         if (!CloseHandle(cs->event))
             ERR("Closing event failed.\n");
     }
 
+    if (cs->stats)
+        wined3d_cs_dump_stats(cs);
+
     state_cleanup(&cs->state);
+    heap_free(cs->upload_ring.mem);
+    heap_free(cs->stats);
     heap_free(cs->data);
     heap_free(cs);
 }
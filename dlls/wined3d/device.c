@@ -4271,8 +4271,6 @@ void CDECL wined3d_device_update_sub_resource(struct wined3d_device *device, str
         return;
     }
 
-    wined3d_resource_wait_idle(resource);
-
     wined3d_cs_emit_update_sub_resource(device->cs, resource, sub_resource_idx, box, data, row_pitch, depth_pitch);
 }
 
@@ -5136,6 +5134,7 @@ HRESULT device_init(struct wined3d_device *device, struct wined3d *wined3d,
     device->device_parent = device_parent;
     list_init(&device->resources);
     list_init(&device->shaders);
+    list_init(&device->kept_dcs);
     device->surface_alignment = surface_alignment;
 
     /* Save the creation parameters. */
@@ -42,6 +42,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
 WINE_DECLARE_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_GLSL_SAMPLE_PROJECTED   0x01
@@ -128,6 +129,38 @@ struct constant_heap
 };
 
 /* GLSL shader private data */
+enum glsl_program_cache_state
+{
+    GLSL_PROGRAM_CACHE_UNKNOWN,
+    GLSL_PROGRAM_CACHE_DISABLED,
+    GLSL_PROGRAM_CACHE_ENABLED,
+};
+
+/* On-disk cache of linked program binaries, see ARB_get_program_binary. */
+struct glsl_program_cache
+{
+    enum glsl_program_cache_state state;
+    UINT64 driver_hash;
+    UINT64 size;
+    UINT64 max_size;
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int stores;
+    unsigned int evictions;
+};
+
+#define GLSL_PROGRAM_CACHE_MAGIC   0x43504757 /* "WGPC" */
+#define GLSL_PROGRAM_CACHE_VERSION 1
+
+struct glsl_program_cache_header
+{
+    DWORD magic;
+    DWORD version;
+    UINT64 key;
+    DWORD binary_format;
+    DWORD binary_size;
+};
+
 struct shader_glsl_priv
 {
     struct wined3d_string_buffer shader_buffer;
@@ -144,6 +177,8 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL ffp_proj_control;
     BOOL legacy_lighting;
+
+    struct glsl_program_cache program_cache;
 };
 
 struct glsl_vs_program
@@ -603,6 +638,347 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+static UINT64 glsl_program_cache_hash(UINT64 hash, const void *data, SIZE_T size)
+{
+    const BYTE *ptr = data;
+    SIZE_T i;
+
+    /* 64-bit FNV-1a. */
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= ptr[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static UINT64 glsl_program_cache_hash_string(UINT64 hash, const char *str)
+{
+    return glsl_program_cache_hash(hash, str ? str : "", str ? strlen(str) + 1 : 1);
+}
+
+static void glsl_program_cache_get_filename(UINT64 key, char *filename, SIZE_T size)
+{
+    snprintf(filename, size, "%s\\%08x%08x.bin", wined3d_settings.shader_cache_path,
+            (unsigned int)(key >> 32), (unsigned int)key);
+}
+
+struct glsl_program_cache_file
+{
+    FILETIME time;
+    UINT64 size;
+    char name[MAX_PATH];
+};
+
+static int glsl_program_cache_file_compare(const void *a, const void *b)
+{
+    const struct glsl_program_cache_file *f1 = a, *f2 = b;
+
+    return CompareFileTime(&f1->time, &f2->time);
+}
+
+/* Scans the cache directory. If "target_size" is not ~0, the least recently
+ * used programs are removed until the cache is smaller than it. */
+static void glsl_program_cache_scan(struct glsl_program_cache *cache, UINT64 target_size)
+{
+    struct glsl_program_cache_file *files = NULL, *new_files;
+    SIZE_T count = 0, capacity = 0, i;
+    char path[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    HANDLE find;
+
+    cache->size = 0;
+
+    snprintf(path, sizeof(path), "%s\\*.bin", wined3d_settings.shader_cache_path);
+    if ((find = FindFirstFileA(path, &data)) == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+    {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+
+        cache->size += ((UINT64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        if (target_size == ~(UINT64)0)
+            continue;
+
+        if (count == capacity)
+        {
+            capacity = max(capacity * 2, 64);
+            if (!(new_files = heap_realloc(files, capacity * sizeof(*files))))
+                break;
+            files = new_files;
+        }
+        files[count].time = data.ftLastWriteTime;
+        files[count].size = ((UINT64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        snprintf(files[count].name, sizeof(files[count].name), "%s\\%s",
+                wined3d_settings.shader_cache_path, data.cFileName);
+        ++count;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    if (files)
+    {
+        qsort(files, count, sizeof(*files), glsl_program_cache_file_compare);
+        for (i = 0; i < count && cache->size > target_size; ++i)
+        {
+            if (!DeleteFileA(files[i].name))
+                continue;
+            cache->size -= files[i].size;
+            ++cache->evictions;
+        }
+        heap_free(files);
+    }
+}
+
+static void glsl_program_cache_init(struct glsl_program_cache *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+
+    if (!wined3d_settings.shader_cache_path)
+    {
+        cache->state = GLSL_PROGRAM_CACHE_DISABLED;
+        return;
+    }
+
+    cache->max_size = (UINT64)wined3d_settings.shader_cache_size * 1024 * 1024;
+    CreateDirectoryA(wined3d_settings.shader_cache_path, NULL);
+    glsl_program_cache_scan(cache, ~(UINT64)0);
+    TRACE_(d3d_perf)("GLSL program cache %s: %s bytes on disk, limit %s bytes.\n",
+            debugstr_a(wined3d_settings.shader_cache_path), wine_dbgstr_longlong(cache->size),
+            wine_dbgstr_longlong(cache->max_size));
+}
+
+static void glsl_program_cache_cleanup(const struct glsl_program_cache *cache)
+{
+    if (cache->state != GLSL_PROGRAM_CACHE_ENABLED)
+        return;
+
+    TRACE_(d3d_perf)("GLSL program cache: %u hits, %u misses, %u stored, %u evicted, %s bytes on disk.\n",
+            cache->hits, cache->misses, cache->stores, cache->evictions, wine_dbgstr_longlong(cache->size));
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_enabled(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info)
+{
+    GLint format_count = 0;
+
+    if (cache->state != GLSL_PROGRAM_CACHE_UNKNOWN)
+        return cache->state == GLSL_PROGRAM_CACHE_ENABLED;
+
+    cache->state = GLSL_PROGRAM_CACHE_DISABLED;
+    if (!gl_info->supported[ARB_GET_PROGRAM_BINARY])
+    {
+        WARN("ARB_get_program_binary is not supported, disabling the GLSL program cache.\n");
+        return FALSE;
+    }
+    gl_info->gl_ops.gl.p_glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    if (!format_count)
+    {
+        WARN("No program binary formats are supported, disabling the GLSL program cache.\n");
+        return FALSE;
+    }
+
+    /* Binaries are only valid for the driver that created them. */
+    cache->driver_hash = 0xcbf29ce484222325ull;
+    cache->driver_hash = glsl_program_cache_hash_string(cache->driver_hash,
+            (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VENDOR));
+    cache->driver_hash = glsl_program_cache_hash_string(cache->driver_hash,
+            (const char *)gl_info->gl_ops.gl.p_glGetString(GL_RENDERER));
+    cache->driver_hash = glsl_program_cache_hash_string(cache->driver_hash,
+            (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VERSION));
+    cache->state = GLSL_PROGRAM_CACHE_ENABLED;
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_get_key(const struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, UINT64 *key)
+{
+    GLint i, shader_count, source_size = 0, length, type;
+    UINT64 hash, shader_hash = 0;
+    char *source = NULL;
+    GLuint *shaders;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_ATTACHED_SHADERS, &shader_count));
+    if (!(shaders = heap_calloc(shader_count, sizeof(*shaders))))
+        return FALSE;
+    GL_EXTCALL(glGetAttachedShaders(program_id, shader_count, NULL, shaders));
+
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        if (length > source_size)
+        {
+            heap_free(source);
+            if (!(source = heap_alloc(length)))
+            {
+                heap_free(shaders);
+                return FALSE;
+            }
+            source_size = length;
+        }
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size, &length, source));
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type));
+
+        hash = glsl_program_cache_hash(cache->driver_hash, &type, sizeof(type));
+        hash = glsl_program_cache_hash(hash, source, length);
+        /* The order of attached shaders isn't defined. */
+        shader_hash += hash;
+    }
+    checkGLcall("get program sources");
+
+    heap_free(source);
+    heap_free(shaders);
+
+    *key = glsl_program_cache_hash(cache->driver_hash, &shader_hash, sizeof(shader_hash));
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_load(struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, UINT64 key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH];
+    void *binary = NULL;
+    GLint status = 0;
+    FILETIME now;
+    HANDLE file;
+    DWORD read;
+
+    glsl_program_cache_get_filename(key, filename, sizeof(filename));
+    file = CreateFileA(filename, GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ,
+            NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (!ReadFile(file, &header, sizeof(header), &read, NULL) || read != sizeof(header)
+            || header.magic != GLSL_PROGRAM_CACHE_MAGIC || header.version != GLSL_PROGRAM_CACHE_VERSION
+            || header.key != key || !(binary = heap_alloc(header.binary_size))
+            || !ReadFile(file, binary, header.binary_size, &read, NULL) || read != header.binary_size)
+    {
+        WARN("Invalid cache file %s.\n", debugstr_a(filename));
+        goto fail;
+    }
+
+    GL_EXTCALL(glProgramBinary(program_id, header.binary_format, binary, header.binary_size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    if (!status)
+    {
+        /* E.g. after a driver update that didn't change the version string. */
+        WARN("Driver rejected cached binary %s.\n", debugstr_a(filename));
+        goto fail;
+    }
+
+    /* Keep track of the last use for eviction. */
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, NULL, &now);
+    CloseHandle(file);
+    heap_free(binary);
+
+    TRACE("Loaded program %u from %s.\n", program_id, debugstr_a(filename));
+    ++cache->hits;
+    return TRUE;
+
+fail:
+    CloseHandle(file);
+    heap_free(binary);
+    DeleteFileA(filename);
+    return FALSE;
+}
+
+/* Context activation is done by the caller. */
+static void glsl_program_cache_store(struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, UINT64 key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH], tmp_filename[MAX_PATH];
+    GLint status, length = 0;
+    void *binary;
+    GLenum format;
+    HANDLE file;
+    DWORD written;
+    BOOL ret;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    if (!status)
+        return;
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (!length || !(binary = heap_alloc(length)))
+        return;
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &format, binary));
+    checkGLcall("glGetProgramBinary");
+
+    header.magic = GLSL_PROGRAM_CACHE_MAGIC;
+    header.version = GLSL_PROGRAM_CACHE_VERSION;
+    header.key = key;
+    header.binary_format = format;
+    header.binary_size = length;
+
+    /* Write to a temporary file first, other processes may be reading the
+     * cache concurrently. */
+    glsl_program_cache_get_filename(key, filename, sizeof(filename));
+    snprintf(tmp_filename, sizeof(tmp_filename), "%s.%x", filename, GetCurrentProcessId());
+    file = CreateFileA(tmp_filename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create %s, error %u.\n", debugstr_a(tmp_filename), GetLastError());
+        heap_free(binary);
+        return;
+    }
+    ret = WriteFile(file, &header, sizeof(header), &written, NULL) && written == sizeof(header)
+            && WriteFile(file, binary, length, &written, NULL) && written == (DWORD)length;
+    CloseHandle(file);
+    heap_free(binary);
+
+    if (!ret || !MoveFileExA(tmp_filename, filename, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to write %s, error %u.\n", debugstr_a(filename), GetLastError());
+        DeleteFileA(tmp_filename);
+        return;
+    }
+
+    TRACE("Stored program %u in %s.\n", program_id, debugstr_a(filename));
+    ++cache->stores;
+    cache->size += sizeof(header) + length;
+    if (cache->size > cache->max_size)
+    {
+        TRACE_(d3d_perf)("GLSL program cache exceeds %s bytes, evicting old programs.\n",
+                wine_dbgstr_longlong(cache->max_size));
+        glsl_program_cache_scan(cache, cache->max_size / 4 * 3);
+    }
+}
+
+/* Context activation is done by the caller. Programs using transform
+ * feedback can't be cached, the varyings aren't part of the GLSL source. */
+static void shader_glsl_link_program(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, BOOL cacheable)
+{
+    struct glsl_program_cache *cache = &priv->program_cache;
+    UINT64 key;
+
+    if (cacheable && glsl_program_cache_enabled(cache, gl_info)
+            && glsl_program_cache_get_key(cache, gl_info, program_id, &key))
+    {
+        if (glsl_program_cache_load(cache, gl_info, program_id, key))
+            return;
+
+        ++cache->misses;
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        TRACE("Linking GLSL shader program %u.\n", program_id);
+        GL_EXTCALL(glLinkProgram(program_id));
+        shader_glsl_validate_link(gl_info, program_id);
+        glsl_program_cache_store(cache, gl_info, program_id, key);
+        return;
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+    GL_EXTCALL(glLinkProgram(program_id));
+    shader_glsl_validate_link(gl_info, program_id);
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -10293,9 +10669,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(priv, gl_info, program_id, TRUE);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10622,9 +10996,7 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     }
 
     /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(priv, gl_info, program_id, !gshader || !gshader->u.gs.so_desc.element_count);
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
             vshader ? vshader->limits->constant_float : 0);
@@ -11217,6 +11589,7 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     fragment_pipe->get_caps(gl_info, &fragment_caps);
     priv->ffp_proj_control = fragment_caps.wined3d_caps & WINED3D_FRAGMENT_CAP_PROJ_CONTROL;
     priv->legacy_lighting = device->wined3d->flags & WINED3D_LEGACY_FFP_LIGHTING;
+    glsl_program_cache_init(&priv->program_cache);
 
     device->vertex_priv = vertex_priv;
     device->fragment_priv = fragment_priv;
@@ -11240,6 +11613,7 @@ static void shader_glsl_free(struct wined3d_device *device)
 {
     struct shader_glsl_priv *priv = device->shader_priv;
 
+    glsl_program_cache_cleanup(&priv->program_cache);
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
@@ -29,6 +29,7 @@ WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_TEXTURE_DYNAMIC_MAP_THRESHOLD 50
+#define WINED3D_MAX_KEPT_DCS 16
 
 struct wined3d_texture_idx
 {
@@ -262,6 +263,8 @@ static void wined3d_texture_evict_sysmem(struct wined3d_texture *texture)
     struct wined3d_texture_sub_resource *sub_resource;
     unsigned int i, sub_count;
 
+    sub_count = texture->level_count * texture->layer_count;
+
     if (texture->flags & (WINED3D_TEXTURE_CONVERTED | WINED3D_TEXTURE_PIN_SYSMEM)
             || texture->download_count > WINED3D_TEXTURE_DYNAMIC_MAP_THRESHOLD)
     {
@@ -269,9 +272,21 @@ static void wined3d_texture_evict_sysmem(struct wined3d_texture *texture)
         return;
     }
 
+    /* DCs point to the system memory of the texture. */
+    if (texture->dc_info)
+    {
+        for (i = 0; i < sub_count; ++i)
+        {
+            if (texture->dc_info[i].dc)
+            {
+                TRACE("Not evicting system memory for texture %p with a DC.\n", texture);
+                return;
+            }
+        }
+    }
+
     TRACE("Evicting system memory for texture %p.\n", texture);
 
-    sub_count = texture->level_count * texture->layer_count;
     for (i = 0; i < sub_count; ++i)
     {
         sub_resource = &texture->sub_resources[i];
@@ -789,10 +804,33 @@ static void wined3d_texture_create_dc(void *object)
     dc_info = &texture->dc_info[sub_resource_idx];
     dc_info->dc = desc.hDc;
     dc_info->bitmap = desc.hBitmap;
+    dc_info->texture = texture;
 
     TRACE("Created DC %p, bitmap %p for texture %p, %u.\n", dc_info->dc, dc_info->bitmap, texture, sub_resource_idx);
 }
 
+static void wined3d_texture_load_dc_location(void *object)
+{
+    const struct wined3d_texture_idx *idx = object;
+    struct wined3d_context *context = NULL;
+    struct wined3d_texture *texture;
+    struct wined3d_device *device;
+
+    TRACE("texture %p, sub_resource_idx %u.\n", idx->texture, idx->sub_resource_idx);
+
+    texture = idx->texture;
+    device = texture->resource.device;
+
+    if (device->d3d_initialized)
+        context = context_acquire(device, NULL, 0);
+
+    wined3d_texture_load_location(texture, idx->sub_resource_idx, context, texture->resource.map_binding);
+    wined3d_texture_invalidate_location(texture, idx->sub_resource_idx, ~texture->resource.map_binding);
+
+    if (context)
+        context_release(context);
+}
+
 static void wined3d_texture_destroy_dc(void *object)
 {
     const struct wined3d_texture_idx *idx = object;
@@ -835,6 +873,73 @@ static void wined3d_texture_destroy_dc(void *object)
         context_release(context);
 }
 
+/* Only DCs created on top of plain system memory may outlive a GetDC() /
+ * ReleaseDC() pair, buffer objects have to be unmapped. The map binding of
+ * such textures doesn't change while the DC exists, wined3d_texture_update_desc()
+ * destroys it. */
+static BOOL wined3d_texture_can_keep_dc(const struct wined3d_texture *texture)
+{
+    if ((texture->resource.usage & WINED3DUSAGE_OWNDC) || (texture->resource.device->wined3d->flags & WINED3D_NO3D))
+        return FALSE;
+    return texture->resource.map_binding == WINED3D_LOCATION_SYSMEM
+            || texture->resource.map_binding == WINED3D_LOCATION_USER_MEMORY;
+}
+
+/* The memory behind a kept DC is up to date as long as the map binding is
+ * the only valid location, i.e. nothing modified the texture since the DC
+ * was released. */
+static BOOL wined3d_texture_dc_is_current(const struct wined3d_texture *texture, unsigned int sub_resource_idx)
+{
+    return !InterlockedCompareExchange((LONG *)&texture->resource.access_count, 0, 0)
+            && texture->sub_resources[sub_resource_idx].locations == texture->resource.map_binding;
+}
+
+static void wined3d_texture_unlink_dc(struct wined3d_texture *texture, unsigned int sub_resource_idx)
+{
+    struct wined3d_dc_info *dc_info = &texture->dc_info[sub_resource_idx];
+
+    if (!dc_info->entry.next)
+        return;
+
+    list_remove(&dc_info->entry);
+    memset(&dc_info->entry, 0, sizeof(dc_info->entry));
+    --texture->resource.device->kept_dc_count;
+}
+
+static void wined3d_texture_unlink_dcs(struct wined3d_texture *texture)
+{
+    unsigned int i, sub_count;
+
+    if (!texture->dc_info)
+        return;
+
+    sub_count = texture->level_count * texture->layer_count;
+    for (i = 0; i < sub_count; ++i)
+        wined3d_texture_unlink_dc(texture, i);
+}
+
+/* Only a limited number of DCs is kept per device, the least recently
+ * released one is destroyed to make room for a new one. */
+static void wined3d_texture_keep_dc(struct wined3d_texture *texture, unsigned int sub_resource_idx)
+{
+    struct wined3d_device *device = texture->resource.device;
+    struct wined3d_texture_idx texture_idx;
+    struct wined3d_dc_info *dc_info;
+
+    list_add_head(&device->kept_dcs, &texture->dc_info[sub_resource_idx].entry);
+    if (++device->kept_dc_count <= WINED3D_MAX_KEPT_DCS)
+        return;
+
+    dc_info = LIST_ENTRY(list_tail(&device->kept_dcs), struct wined3d_dc_info, entry);
+    texture_idx.texture = dc_info->texture;
+    texture_idx.sub_resource_idx = dc_info - dc_info->texture->dc_info;
+    TRACE("Destroying DC of sub-resource {%p, %u}.\n", texture_idx.texture, texture_idx.sub_resource_idx);
+
+    wined3d_texture_unlink_dc(texture_idx.texture, texture_idx.sub_resource_idx);
+    wined3d_cs_destroy_object(device->cs, wined3d_texture_destroy_dc, &texture_idx);
+    device->cs->ops->finish(device->cs, WINED3D_CS_QUEUE_DEFAULT);
+}
+
 static void wined3d_texture_cleanup(struct wined3d_texture *texture)
 {
     unsigned int sub_count = texture->level_count * texture->layer_count;
@@ -1236,6 +1341,7 @@ ULONG CDECL wined3d_texture_decref(struct wined3d_texture *texture)
          * wined3d_texture_destroy_object() can't access that memory either. */
         if (texture->user_memory)
             wined3d_resource_wait_idle(&texture->resource);
+        wined3d_texture_unlink_dcs(texture);
         wined3d_texture_sub_resources_destroyed(texture);
         texture->resource.parent_ops->wined3d_object_destroyed(texture->resource.parent);
         resource_cleanup(&texture->resource);
@@ -1590,6 +1696,7 @@ HRESULT CDECL wined3d_texture_update_desc(struct wined3d_texture *texture, UINT
     {
         struct wined3d_texture_idx texture_idx = {texture, 0};
 
+        wined3d_texture_unlink_dc(texture, 0);
         wined3d_cs_destroy_object(device->cs, wined3d_texture_destroy_dc, &texture_idx);
         device->cs->ops->finish(device->cs, WINED3D_CS_QUEUE_DEFAULT);
         create_dib = TRUE;
@@ -1662,6 +1769,8 @@ HRESULT CDECL wined3d_texture_update_desc(struct wined3d_texture *texture, UINT
 
         wined3d_cs_init_object(device->cs, wined3d_texture_create_dc, &texture_idx);
         device->cs->ops->finish(device->cs, WINED3D_CS_QUEUE_DEFAULT);
+        if (texture->dc_info && texture->dc_info[0].dc && wined3d_texture_can_keep_dc(texture))
+            wined3d_texture_keep_dc(texture, 0);
     }
 
     return WINED3D_OK;
@@ -3455,6 +3564,21 @@ HRESULT CDECL wined3d_texture_get_dc(struct wined3d_texture *texture, unsigned i
     if (texture->resource.map_count && !(texture->flags & WINED3D_TEXTURE_GET_DC_LENIENT))
         return WINED3DERR_INVALIDCALL;
 
+    if (!sub_resource->map_count && (dc_info = texture->dc_info) && dc_info[sub_resource_idx].dc
+            && wined3d_texture_can_keep_dc(texture))
+    {
+        struct wined3d_texture_idx texture_idx = {texture, sub_resource_idx};
+
+        /* The DC was kept from a previous GetDC() call, bring the memory
+         * behind it up to date if the texture was modified since. */
+        wined3d_texture_unlink_dc(texture, sub_resource_idx);
+        if (!wined3d_texture_dc_is_current(texture, sub_resource_idx))
+        {
+            wined3d_cs_init_object(device->cs, wined3d_texture_load_dc_location, &texture_idx);
+            device->cs->ops->finish(device->cs, WINED3D_CS_QUEUE_DEFAULT);
+        }
+    }
+
     if (!(dc_info = texture->dc_info) || !dc_info[sub_resource_idx].dc)
     {
         struct wined3d_texture_idx texture_idx = {texture, sub_resource_idx};
@@ -3465,6 +3589,11 @@ HRESULT CDECL wined3d_texture_get_dc(struct wined3d_texture *texture, unsigned i
             return WINED3DERR_INVALIDCALL;
     }
 
+    /* Save the initial state of a DC that may be kept, so that the next
+     * caller doesn't get objects and attributes selected by this one. */
+    if (!sub_resource->map_count && wined3d_texture_can_keep_dc(texture))
+        SaveDC(dc_info[sub_resource_idx].dc);
+
     if (!(texture->flags & WINED3D_TEXTURE_GET_DC_LENIENT))
         texture->flags |= WINED3D_TEXTURE_DC_IN_USE;
     ++texture->resource.map_count;
@@ -3503,7 +3632,18 @@ HRESULT CDECL wined3d_texture_release_dc(struct wined3d_texture *texture, unsign
         return WINED3DERR_INVALIDCALL;
     }
 
-    if (!(texture->resource.usage & WINED3DUSAGE_OWNDC) && !(device->wined3d->flags & WINED3D_NO3D))
+    /* Applications drawing with GDI onto a texture typically do so every
+     * frame. Keep the DC around instead of recreating it on every GetDC()
+     * call; the system memory behind it isn't evicted while it exists. */
+    if (wined3d_texture_can_keep_dc(texture))
+    {
+        if (sub_resource->map_count == 1)
+        {
+            RestoreDC(dc, 1);
+            wined3d_texture_keep_dc(texture, sub_resource_idx);
+        }
+    }
+    else if (!(texture->resource.usage & WINED3DUSAGE_OWNDC) && !(device->wined3d->flags & WINED3D_NO3D))
     {
         struct wined3d_texture_idx texture_idx = {texture, sub_resource_idx};
 
@@ -91,6 +91,8 @@ struct wined3d_settings wined3d_settings =
     ~0U,            /* No PS shader model limit by default. */
     ~0u,            /* No CS shader model limit by default. */
     FALSE,          /* 3D support enabled by default. */
+    NULL,           /* No GLSL program cache by default. */
+    64,             /* GLSL program cache size limit in MiB. */
 };
 
 struct wined3d * CDECL wined3d_create(DWORD flags)
@@ -313,6 +315,17 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             TRACE("Disabling 3D support.\n");
             wined3d_settings.no_3d = TRUE;
         }
+        if (!get_config_key(hkey, appkey, "ShaderCachePath", buffer, size) && *buffer)
+        {
+            size_t len = strlen(buffer) + 1;
+
+            if (!(wined3d_settings.shader_cache_path = heap_alloc(len)))
+                ERR("Failed to allocate shader cache path memory.\n");
+            else
+                memcpy(wined3d_settings.shader_cache_path, buffer, len);
+        }
+        if (!get_config_key_dword(hkey, appkey, "ShaderCacheSize", &wined3d_settings.shader_cache_size))
+            TRACE("Limiting the GLSL program cache to %u MiB.\n", wined3d_settings.shader_cache_size);
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -345,6 +358,7 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     heap_free(wndproc_table.entries);
 
     heap_free(wined3d_settings.logo);
+    heap_free(wined3d_settings.shader_cache_path);
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
     DeleteCriticalSection(&wined3d_wndproc_cs);
@@ -399,6 +399,8 @@ struct wined3d_settings
     unsigned int max_sm_ps;
     unsigned int max_sm_cs;
     BOOL no_3d;
+    char *shader_cache_path;
+    unsigned int shader_cache_size;
 };
 
 extern struct wined3d_settings wined3d_settings DECLSPEC_HIDDEN;
@@ -3005,6 +3007,10 @@ struct wined3d_device
     struct list             shaders;   /* a linked list to track shaders (pixel and vertex)      */
     struct wine_rb_tree samplers;
 
+    /* Texture DCs kept across GetDC() / ReleaseDC(), most recently released first. */
+    struct list kept_dcs;
+    unsigned int kept_dc_count;
+
     /* Render Target Support */
     struct wined3d_fb_state fb;
     struct wined3d_rendertarget_view *auto_depth_stencil_view;
@@ -3239,6 +3245,8 @@ struct wined3d_texture
     {
         HBITMAP bitmap;
         HDC dc;
+        struct wined3d_texture *texture;
+        struct list entry; /* In device->kept_dcs while kept. */
     } *dc_info;
 
     struct list renderbuffers;
@@ -3561,6 +3569,11 @@ enum wined3d_push_constants
 #define WINED3D_CS_QUERY_POLL_INTERVAL  10u
 #define WINED3D_CS_QUEUE_SIZE           0x100000u
 #define WINED3D_CS_SPIN_COUNT           10000000u
+#define WINED3D_CS_WAIT_SPIN_COUNT      4000u
+#define WINED3D_CS_INLINE_UPLOAD_SIZE   0x10000u
+#define WINED3D_CS_MAX_PENDING_UPLOAD   0x4000000u
+#define WINED3D_CS_UPLOAD_RING_SIZE     0x400000u
+#define WINED3D_CS_MAX_UPLOAD_BO_SIZE   0x100000u
 
 struct wined3d_cs_queue
 {
@@ -3568,6 +3581,22 @@ struct wined3d_cs_queue
     BYTE data[WINED3D_CS_QUEUE_SIZE];
 };
 
+/* Blocks in the upload ring are released once "refcount" drops to 0. The
+ * owning buffer holds one reference, and each queued upload holds another.
+ * The data follows the header at the next RESOURCE_ALIGNMENT boundary. */
+struct wined3d_cs_upload_block
+{
+    LONG refcount;
+    unsigned int size;
+    struct wined3d_buffer *owner;
+};
+
+struct wined3d_cs_upload_ring
+{
+    BYTE *mem, *data;
+    size_t head, tail, used;
+};
+
 struct wined3d_cs_ops
 {
     void *(*require_space)(struct wined3d_cs *cs, size_t size, enum wined3d_cs_queue_id queue_id);
@@ -3596,6 +3625,13 @@ struct wined3d_cs
     HANDLE event;
     BOOL waiting_for_event;
     LONG pending_presents;
+
+    HANDLE progress_event;
+    LONG waiting_for_progress;
+    LONG pending_upload_size;
+    struct wined3d_cs_upload_ring upload_ring;
+
+    struct wined3d_cs_stats *stats;
 };
 
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device) DECLSPEC_HIDDEN;
@@ -3688,8 +3724,14 @@ void wined3d_cs_init_object(struct wined3d_cs *cs,
         void (*callback)(void *object), void *object) DECLSPEC_HIDDEN;
 HRESULT wined3d_cs_map(struct wined3d_cs *cs, struct wined3d_resource *resource, unsigned int sub_resource_idx,
         struct wined3d_map_desc *map_desc, const struct wined3d_box *box, unsigned int flags) DECLSPEC_HIDDEN;
+BOOL wined3d_cs_map_upload_bo(struct wined3d_cs *cs, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, struct wined3d_map_desc *map_desc,
+        const struct wined3d_box *box, DWORD flags) DECLSPEC_HIDDEN;
+void wined3d_cs_release_upload_bo(struct wined3d_buffer *buffer) DECLSPEC_HIDDEN;
 HRESULT wined3d_cs_unmap(struct wined3d_cs *cs, struct wined3d_resource *resource,
         unsigned int sub_resource_idx) DECLSPEC_HIDDEN;
+BOOL wined3d_cs_unmap_upload_bo(struct wined3d_cs *cs, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx) DECLSPEC_HIDDEN;
 
 static inline void wined3d_cs_push_constants(struct wined3d_cs *cs, enum wined3d_push_constants p,
         unsigned int start_idx, unsigned int count, const void *constants)
@@ -3741,6 +3783,12 @@ struct wined3d_buffer
     SIZE_T maps_size, modified_areas;
     struct wined3d_fence *fence;
 
+    /* Streamed DISCARD / NOOVERWRITE maps. Only modified by the application
+     * thread. Streamed maps are included in resource.map_count. */
+    struct wined3d_cs_upload_block *upload_block;
+    unsigned int upload_map_count;
+    unsigned int upload_start, upload_end;
+
     /* conversion stuff */
     UINT decl_change_count, full_conversion_count;
     UINT draw_count;
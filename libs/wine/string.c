@@ -26,11 +26,21 @@
 #define WINE_UNICODE_INLINE  /* nothing */
 #include "wine/unicode.h"
 
+/* identical characters are by far the common case, skip the case mapping for them */
+
 int strcmpiW( const WCHAR *str1, const WCHAR *str2 )
 {
     for (;;)
     {
-        int ret = tolowerW(*str1) - tolowerW(*str2);
+        int ret;
+        if (*str1 == *str2)
+        {
+            if (!*str1) return 0;
+            str1++;
+            str2++;
+            continue;
+        }
+        ret = tolowerW(*str1) - tolowerW(*str2);
         if (ret || !*str1) return ret;
         str1++;
         str2++;
@@ -41,7 +51,14 @@ int strncmpiW( const WCHAR *str1, const WCHAR *str2, int n )
 {
     int ret = 0;
     for ( ; n > 0; n--, str1++, str2++)
+    {
+        if (*str1 == *str2)
+        {
+            if (!*str1) return 0;
+            continue;
+        }
         if ((ret = tolowerW(*str1) - tolowerW(*str2)) || !*str1) break;
+    }
     return ret;
 }
 
@@ -49,7 +66,7 @@ int memicmpW( const WCHAR *str1, const WCHAR *str2, int n )
 {
     int ret = 0;
     for ( ; n > 0; n--, str1++, str2++)
-        if ((ret = tolowerW(*str1) - tolowerW(*str2))) break;
+        if (*str1 != *str2 && (ret = tolowerW(*str1) - tolowerW(*str2))) break;
     return ret;
 }
 